@@ -0,0 +1,316 @@
+
+/*
+  ScorePress - Music Engraving Software  (libscorepress)
+  Copyright (C) 2016 Dominik Lehmann
+  
+  Licensed under the EUPL, Version 1.1 or - as soon they
+  will be approved by the European Commission - subsequent
+  versions of the EUPL (the "Licence");
+  You may not use this work except in compliance with the
+  Licence. You may obtain a copy of the Licence at
+  <http://ec.europa.eu/idabc/eupl/>.
+  
+  Unless required by applicable law or agreed to in
+  writing, software distributed under the Licence is
+  distributed on an "AS IS" basis, WITHOUT WARRANTIES OR
+  CONDITIONS OF ANY KIND, either expressed or implied.
+  See the Licence for the specific language governing
+  permissions and limitations under the Licence.
+*/
+
+//
+//     ScorePress Benchmark
+//    ======================
+//
+// This program generates, copies, engraves, renders and traverses a synthetic
+// score (see "Test::get_synthetic_document") and writes the measured run-times
+// to stdout as a JSON object. The score is described by "<parameter>=<value>" arguments:
+//
+//   staves, subvoices, beats, line_beats, page_lines,  (score structure)
+//   justify                                            (0 or 1)
+//   beams, ties, slurs, hairpins, accidentals, seed    (densities in permille)
+//   runs                                               (number of timed runs)
+//   sprites                                            (spriteset description file)
+//
+// The run-times of the single engraving phases are taken from the engine's
+// performance counters, which requires the library to be compiled with
+// "STATISTICS" defined (see "statistics.hh"). The renderer does not draw
+// anything; since it cannot measure the sprites, these are given the dimension
+// of a note-head.
+//
+
+#include <iostream>     // std::cout, std::cerr
+#include <string>       // std::string
+#include <vector>       // std::vector
+#include <algorithm>    // std::min
+#include <chrono>       // std::chrono::steady_clock
+#include <cstdlib>      // strtoul
+
+#include "engine.hh"            // Engine, Renderer, Document, UserCursor
+#include "statistics.hh"        // Statistics
+#include "file_format.hh"       // XMLSpritesetReader
+#include "test.hh"              // Test::get_synthetic_document, Test::SyntheticParam
+
+#ifndef BENCHMARK_SPRITES
+#define BENCHMARK_SPRITES "data/symbol/default.xml"
+#endif
+
+using namespace ScorePress;
+
+// renderer without output
+class NullRenderer : public Renderer
+{
+ public:
+    virtual bool   ready() const {return true;}
+    virtual bool   exist(const std::string&) const {return true;}
+    virtual bool   exist(const std::string&, const size_t) const {return true;}
+    
+    virtual size_t    spriteset_format_count() const {return 1;}
+    virtual ReaderPtr spriteset_reader(const size_t) {return ReaderPtr(new XMLSpritesetReader());}
+    virtual size_t    add_spriteset(ReaderPtr reader)
+    {
+        sprites.push_back(SpriteSet());
+        reader->parse_spriteset(sprites.back(), *this, sprites.size() - 1);
+        for (SpriteSet::iterator i = sprites.back().begin(); i != sprites.back().end(); ++i)
+        {
+            i->width  = static_cast<int>(sprites.back().head_height * 13 / 10);
+            i->height = static_cast<int>(sprites.back().head_height);
+        };
+        return sprites.size() - 1;
+    }
+    
+    virtual void draw_sprite(const SpriteId, double, double) {}
+    virtual void draw_sprite(const SpriteId, double, double, double, double) {}
+    
+    virtual void set_line_width(const double) {}
+    virtual void set_color(const unsigned char, const unsigned char, const unsigned char, const unsigned char) {}
+    virtual void move_to(const double, const double) {}
+    virtual void line_to(const double, const double) {}
+    virtual void fill() {}
+    virtual void stroke() {}
+    virtual void close() {}
+    
+    virtual void clip(const int, const int, const int, const int) {}
+    virtual void unclip() {}
+    
+    virtual void set_font_family(const std::string&) {}
+    virtual void set_font_size(const double) {}
+    virtual void set_font_bold(const bool) {}
+    virtual void set_font_italic(const bool) {}
+    virtual void set_font_underline(const bool) {}
+    virtual void set_font_color(const unsigned char, const unsigned char, const unsigned char) {}
+    
+    virtual void set_text_width(const double) {}
+    virtual void reset_text_width() {}
+    virtual void set_text_align(const enuAlignment) {}
+    virtual void set_text_justify(const bool) {}
+    virtual void add_text(const std::string&) {}
+    virtual void render_text() {}
+    
+    virtual void rect_invert(double, double, double, double) {}
+    virtual bool has_rect_invert() const {return false;}
+};
+
+// run-time statistics of a benchmark
+struct Result
+{
+    std::string        name;    // benchmark name
+    unsigned long long min;     // minimal run-time (in nanoseconds)
+    unsigned long long total;   // accumulated run-time (in nanoseconds)
+    size_t             runs;    // number of runs
+    size_t             count;   // number of processed items per run (calls, documents, pages or cursor movements)
+    
+    Result(const std::string& _name) : name(_name), min(static_cast<unsigned long long>(-1)), total(0), runs(0), count(0) {}
+    void add(const unsigned long long ns) {min = std::min(min, ns); total += ns; ++runs;}
+};
+
+typedef std::chrono::steady_clock Clock;
+inline unsigned long long _ns(const Clock::duration d) {return static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());}
+
+// move the cursor through every voice of every line (returns the number of movements)
+static size_t traverse(UserCursor& cursor)
+{
+    size_t moves = 0;
+    while (true)
+    {
+        while (cursor.has_prev_voice()) {cursor.prev_voice(); ++moves;};
+        while (true)
+        {
+            cursor.home_voice();
+            while (cursor.has_next()) {cursor.next(); ++moves;};
+            if (!cursor.has_next_voice()) break;
+            cursor.next_voice();
+            ++moves;
+        };
+        if (!cursor.has_next_line()) break;
+        cursor.next_line_home();
+        ++moves;
+    };
+    return moves;
+}
+
+// parse a "<parameter>=<value>" argument
+static bool parse_arg(const std::string& arg, const char* key, size_t& value)
+{
+    const std::string prefix = std::string(key) + "=";
+    if (arg.compare(0, prefix.size(), prefix) != 0) return false;
+    value = strtoul(arg.c_str() + prefix.size(), NULL, 10);
+    return true;
+}
+
+static bool parse_arg(const std::string& arg, const char* key, unsigned int& value)
+{
+    size_t v = value;
+    if (!parse_arg(arg, key, v)) return false;
+    value = static_cast<unsigned int>(v);
+    return true;
+}
+
+static bool parse_arg(const std::string& arg, const char* key, bool& value)
+{
+    size_t v = value;
+    if (!parse_arg(arg, key, v)) return false;
+    value = (v != 0);
+    return true;
+}
+
+// write a result as JSON object
+static void write(std::ostream& out, const Result& result, bool last)
+{
+    out << "    {\"name\": \"" << result.name << "\", \"runs\": " << result.runs << ", \"count\": " << result.count
+        << ", \"min_ns\": " << result.min << ", \"mean_ns\": " << (result.runs ? result.total / result.runs : 0) << "}"
+        << (last ? "\n" : ",\n");
+}
+
+int main(int argc, char** argv)
+{
+    // parse the arguments
+    Test::SyntheticParam param;
+    size_t runs = 10;
+    std::string sprites = BENCHMARK_SPRITES;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg(argv[i]);
+        if (   !parse_arg(arg, "staves",      param.staves)
+            && !parse_arg(arg, "subvoices",   param.subvoices)
+            && !parse_arg(arg, "beats",       param.beats)
+            && !parse_arg(arg, "line_beats",  param.line_beats)
+            && !parse_arg(arg, "page_lines",  param.page_lines)
+            && !parse_arg(arg, "justify",     param.justify)
+            && !parse_arg(arg, "beams",       param.beams)
+            && !parse_arg(arg, "ties",        param.ties)
+            && !parse_arg(arg, "slurs",       param.slurs)
+            && !parse_arg(arg, "hairpins",    param.hairpins)
+            && !parse_arg(arg, "accidentals", param.accidentals)
+            && !parse_arg(arg, "seed",        param.seed)
+            && !parse_arg(arg, "runs",        runs))
+        {
+            if (arg.compare(0, 8, "sprites=") == 0) sprites = arg.substr(8);
+            else {std::cerr << "Unknown argument \"" << arg << "\"\n"; return 1;};
+        };
+    };
+    if (param.line_beats == 0 || runs == 0) {std::cerr << "The values of \"line_beats\" and \"runs\" must not be zero.\n"; return 1;};
+    
+    try
+    {
+        // load the sprites
+        NullRenderer renderer;
+        Renderer::ReaderPtr reader = renderer.spriteset_reader(0);
+        reader->open(sprites);
+        renderer.add_spriteset(reader);
+        
+        // generate the score
+        Document document;
+        Test::get_synthetic_document(document, renderer.get_sprites(), param);
+        Engine engine(document, renderer.get_sprites());
+        
+        Result generate("Test::get_synthetic_document");
+        Result copy("Document::Document(const Document&)");
+        Result destroy("Document::~Document");
+        Result engrave("Engraver::engrave");
+        Result render("Press::render");
+        Result cursor("UserCursor::next");
+        Statistics statistics;
+        std::vector<Result> phases;
+        for (size_t p = 0; p < Statistics::RENDER; ++p)
+            phases.push_back(Result(std::string("phase.") + Statistics::name(static_cast<Statistics::Phase>(p))));
+        
+        for (size_t i = 0; i < runs; ++i)
+        {
+            // generate, copy and destroy a document (allocating and releasing the score objects)
+            Clock::time_point start = Clock::now();
+            Document* const generated = new Document();
+            Test::get_synthetic_document(*generated, renderer.get_sprites(), param);
+            generate.add(_ns(Clock::now() - start));
+            generate.count = 1;
+            
+            start = Clock::now();
+            Document* const copied = new Document(*generated);
+            copy.add(_ns(Clock::now() - start));
+            copy.count = 1;
+            
+            start = Clock::now();
+            delete copied;
+            destroy.add(_ns(Clock::now() - start));
+            destroy.count = 1;
+            delete generated;
+            
+            // engrave the document
+            engine.reset_statistics();
+            start = Clock::now();
+            engine.engrave();
+            engrave.add(_ns(Clock::now() - start));
+            
+            statistics = engine.get_statistics();
+            engrave.count = statistics.get(Statistics::LINES);
+            for (size_t p = 0; p < phases.size(); ++p)
+            {
+                const Statistics::Timer& timer = statistics.get(static_cast<Statistics::Phase>(p));
+                phases[p].add(timer.time);
+                phases[p].count = timer.calls;
+            };
+            
+            // render all pages
+            start = Clock::now();
+            engine.render_all(renderer, MultipageLayout(), Position<mpx_t>());
+            render.add(_ns(Clock::now() - start));
+            render.count = engine.page_count();
+            
+            // move the cursor through the score
+            RefPtr<EditCursor> edit_cursor = engine.get_cursor();
+            start = Clock::now();
+            cursor.count = traverse(*edit_cursor);
+            cursor.add(_ns(Clock::now() - start));
+        };
+        
+        // write the results
+        std::cout << "{\n  \"parameters\": {"
+                  << "\"staves\": "       << param.staves      << ", \"subvoices\": "  << param.subvoices
+                  << ", \"beats\": "      << param.beats       << ", \"line_beats\": " << param.line_beats
+                  << ", \"page_lines\": " << param.page_lines  << ", \"justify\": "    << param.justify
+                  << ", \"beams\": "      << param.beams
+                  << ", \"ties\": "       << param.ties        << ", \"slurs\": "      << param.slurs
+                  << ", \"hairpins\": "   << param.hairpins    << ", \"accidentals\": " << param.accidentals
+                  << ", \"seed\": "       << param.seed        << "},\n  \"statistics\": " << (Statistics::enabled() ? "true" : "false")
+                  << ",\n  \"results\": [\n";
+        write(std::cout, generate, false);
+        write(std::cout, copy,     false);
+        write(std::cout, destroy,  false);
+        write(std::cout, engrave,  false);
+        for (std::vector<Result>::const_iterator p = phases.begin(); p != phases.end(); ++p)
+            write(std::cout, *p, false);
+        write(std::cout, render,  false);
+        write(std::cout, cursor,  true);
+        std::cout << "  ],\n  \"counters\": {";
+        for (size_t c = 0; c < Statistics::COUNTER_COUNT; ++c)
+            std::cout << (c ? ", \"" : "\"") << Statistics::name(static_cast<Statistics::Counter>(c)) << "\": "
+                      << statistics.get(static_cast<Statistics::Counter>(c));
+        std::cout << "}\n}\n";
+    }
+    catch (ScorePress::Error& e)
+    {
+        std::cerr << "ERROR: " << e << "\n";
+        return 1;
+    };
+    return 0;
+}
@@ -0,0 +1,266 @@
+
+/*
+  ScorePress - Music Engraving Software  (libscorepress)
+  Copyright (C) 2016 Dominik Lehmann
+  
+  Licensed under the EUPL, Version 1.1 or - as soon they
+  will be approved by the European Commission - subsequent
+  versions of the EUPL (the "Licence");
+  You may not use this work except in compliance with the
+  Licence. You may obtain a copy of the Licence at
+  <http://ec.europa.eu/idabc/eupl/>.
+  
+  Unless required by applicable law or agreed to in
+  writing, software distributed under the Licence is
+  distributed on an "AS IS" basis, WITHOUT WARRANTIES OR
+  CONDITIONS OF ANY KIND, either expressed or implied.
+  See the Licence for the specific language governing
+  permissions and limitations under the Licence.
+*/
+
+#ifndef SCOREPRESS_ARENA_HH
+#define SCOREPRESS_ARENA_HH
+
+#include <cstddef>      // size_t
+#include <new>          // operator new, operator delete
+#include <type_traits>  // std::true_type, std::false_type
+
+#include "export.hh"
+
+namespace ScorePress
+{
+//  CLASSES
+// ---------
+class SCOREPRESS_API Arena;             // memory region, releasing all of its allocations at once
+template <typename T>
+class ArenaAllocator;                   // allocator for the standard containers (using an arena)
+class SCOREPRESS_API ObjectPool;        // thread-caching pool for small objects (shared by all threads)
+template <typename T>
+class PoolAllocator;                    // allocator for the standard containers (using the object pool)
+
+
+//
+//     class Arena
+//    =============
+//
+// This class hands out memory from large blocks, which are only returned to
+// the system, when the arena is destroyed. Released objects are kept in a free
+// list per size class and reused by the following allocations of the same
+// size. Objects larger than "MAX_SIZE" are allocated on the heap directly.
+// The arena is not thread-safe; it has to be used by one thread at a time.
+//
+class SCOREPRESS_API Arena
+{
+ public:
+    static const size_t GRANULARITY = 16;       // size granularity (and alignment) of the objects
+    static const size_t MAX_SIZE    = 1024;     // maximal object size (larger objects are allocated on the heap)
+    static const size_t MIN_BLOCK   = 4096;     // size of the first memory block
+    static const size_t MAX_BLOCK   = 16384;    // maximal size of the memory blocks (each block doubling the capacity)
+    
+ private:
+    struct Block {Block* next;};                // block header (followed by the objects)
+    struct Free  {Free*  next;};                // released object (element of a free list)
+    
+    Block* blocks;                              // allocated blocks (the newest first)
+    char*  next;                                // free memory within the newest block
+    char*  end;                                 // end of the newest block
+    Free*  free_list[MAX_SIZE / GRANULARITY];   // released objects (for each size class)
+    size_t capacity;                            // accumulated size of the blocks
+    
+    void* allocate_block(const size_t size);    // allocate the object from a new block
+    
+    // (uncopyable)
+    Arena(const Arena&);
+    Arena& operator = (const Arena&);
+    
+ public:
+    Arena();                                    // constructor (without blocks)
+    ~Arena();                                   // destructor (releasing all blocks)
+    
+    void* allocate(const size_t size);              // allocate memory for an object of the given size
+    void  deallocate(void* ptr, const size_t size); // release the memory of an object (of the given size)
+    
+    size_t get_capacity() const;                // accumulated size of the blocks
+};
+
+// inline method implementations
+inline void* Arena::allocate(const size_t size)
+{
+    if (size > MAX_SIZE) return ::operator new(size);
+    const size_t cls = (size - 1) / GRANULARITY;    // size class
+    if (free_list[cls])                             // reuse a released object
+    {
+        Free* const ptr = free_list[cls];
+        free_list[cls] = ptr->next;
+        return ptr;
+    };
+    const size_t n = (cls + 1) * GRANULARITY;       // rounded size
+    if (static_cast<size_t>(end - next) < n) return allocate_block(n);
+    void* const ptr = next;
+    next += n;
+    return ptr;
+}
+
+inline void Arena::deallocate(void* ptr, const size_t size)
+{
+    if (!ptr) return;
+    if (size > MAX_SIZE) {::operator delete(ptr); return;};
+    const size_t cls = (size - 1) / GRANULARITY;
+    static_cast<Free*>(ptr)->next = free_list[cls];
+    free_list[cls] = static_cast<Free*>(ptr);
+}
+
+inline size_t Arena::get_capacity() const {return capacity;}
+
+
+//
+//     class ArenaAllocator
+//    ======================
+//
+// Allocator for the standard containers, which takes the memory from the given
+// arena. A default constructed allocator (without arena) uses the heap.
+// Containers can only exchange their elements (i.e. "splice" or "swap"), if
+// their allocators use the same arena. The allocator is propagated on swap,
+// but not on assignment (an assigned container keeps its arena).
+//
+template <typename T> class ArenaAllocator
+{
+ public:
+    // typedefs
+    typedef T         value_type;
+    typedef T*        pointer;
+    typedef const T*  const_pointer;
+    typedef T&        reference;
+    typedef const T&  const_reference;
+    typedef size_t    size_type;
+    typedef ptrdiff_t difference_type;
+    
+    typedef std::false_type propagate_on_container_copy_assignment;
+    typedef std::false_type propagate_on_container_move_assignment;
+    typedef std::true_type  propagate_on_container_swap;
+    
+    template <typename U> struct rebind {typedef ArenaAllocator<U> other;};
+    
+ private:
+    Arena* arena;       // memory source (NULL for the heap)
+    
+ public:
+    ArenaAllocator();                                       // default constructor (using the heap)
+    explicit ArenaAllocator(Arena& arena);                  // constructor (using the given arena)
+    template <typename U> ArenaAllocator(const ArenaAllocator<U>& alloc);  // conversion (using the same arena)
+    
+    T*   allocate(const size_t n);                          // allocate memory for "n" objects
+    void deallocate(T* const ptr, const size_t n);          // release the memory of "n" objects
+    
+    Arena* get_arena() const;                               // memory source (NULL for the heap)
+};
+
+// method implementations
+template <typename T>
+inline ArenaAllocator<T>::ArenaAllocator() : arena(NULL) {}
+
+template <typename T>
+inline ArenaAllocator<T>::ArenaAllocator(Arena& _arena) : arena(&_arena) {}
+
+template <typename T> template <typename U>
+inline ArenaAllocator<T>::ArenaAllocator(const ArenaAllocator<U>& alloc) : arena(alloc.get_arena()) {}
+
+template <typename T>
+inline T* ArenaAllocator<T>::allocate(const size_t n)
+{
+    return static_cast<T*>(arena ? arena->allocate(n * sizeof(T)) : ::operator new(n * sizeof(T)));
+}
+
+template <typename T>
+inline void ArenaAllocator<T>::deallocate(T* const ptr, const size_t n)
+{
+    if (arena) arena->deallocate(ptr, n * sizeof(T)); else ::operator delete(ptr);
+}
+
+template <typename T>
+inline Arena* ArenaAllocator<T>::get_arena() const {return arena;}
+
+template <typename T, typename U>
+inline bool operator == (const ArenaAllocator<T>& a1, const ArenaAllocator<U>& a2) {return a1.get_arena() == a2.get_arena();}
+
+template <typename T, typename U>
+inline bool operator != (const ArenaAllocator<T>& a1, const ArenaAllocator<U>& a2) {return a1.get_arena() != a2.get_arena();}
+
+
+//
+//     class ObjectPool
+//    ==================
+//
+// This pool provides the memory for the objects of the score model (see the
+// operators "new" and "delete" of "Class") and the nodes of their lists. Each
+// thread allocates from its own cache, which holds a free list per size class
+// and a block to carve new objects from; thus the common case needs no lock.
+// Objects may be released by any thread (being reused by that thread). When a
+// thread exits, its free lists are handed to the following allocating threads.
+// The blocks are never returned to the system, but reused for later objects.
+// Objects larger than "MAX_SIZE" are allocated on the heap directly.
+//
+class SCOREPRESS_API ObjectPool
+{
+ public:
+    static const size_t GRANULARITY = 16;       // size granularity (and alignment) of the objects
+    static const size_t MAX_SIZE    = 512;      // maximal object size (larger objects are allocated on the heap)
+    static const size_t BLOCK_SIZE  = 65536;    // size of the memory blocks
+    
+    static void* allocate(const size_t size);               // allocate memory for an object of the given size
+    static void  deallocate(void* ptr, const size_t size);  // release the memory of an object (of the given size)
+};
+
+
+//
+//     class PoolAllocator
+//    =====================
+//
+// Allocator for the standard containers, which takes the memory from the object
+// pool. It is stateless, so containers can always exchange their elements.
+//
+template <typename T> class PoolAllocator
+{
+ public:
+    // typedefs
+    typedef T         value_type;
+    typedef T*        pointer;
+    typedef const T*  const_pointer;
+    typedef T&        reference;
+    typedef const T&  const_reference;
+    typedef size_t    size_type;
+    typedef ptrdiff_t difference_type;
+    
+    template <typename U> struct rebind {typedef PoolAllocator<U> other;};
+    
+ public:
+    PoolAllocator();                                        // default constructor
+    template <typename U> PoolAllocator(const PoolAllocator<U>&);   // conversion
+    
+    T*   allocate(const size_t n);                          // allocate memory for "n" objects
+    void deallocate(T* const ptr, const size_t n);          // release the memory of "n" objects
+};
+
+// method implementations
+template <typename T>
+inline PoolAllocator<T>::PoolAllocator() {}
+
+template <typename T> template <typename U>
+inline PoolAllocator<T>::PoolAllocator(const PoolAllocator<U>&) {}
+
+template <typename T>
+inline T* PoolAllocator<T>::allocate(const size_t n) {return static_cast<T*>(ObjectPool::allocate(n * sizeof(T)));}
+
+template <typename T>
+inline void PoolAllocator<T>::deallocate(T* const ptr, const size_t n) {ObjectPool::deallocate(ptr, n * sizeof(T));}
+
+template <typename T, typename U>
+inline bool operator == (const PoolAllocator<T>&, const PoolAllocator<U>&) {return true;}
+
+template <typename T, typename U>
+inline bool operator != (const PoolAllocator<T>&, const PoolAllocator<U>&) {return false;}
+
+} // end namespace
+
+#endif
+
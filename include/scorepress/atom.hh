@@ -0,0 +1,201 @@
+
+/*
+  ScorePress - Music Engraving Software  (libscorepress)
+  Copyright (C) 2016 Dominik Lehmann
+  
+  Licensed under the EUPL, Version 1.1 or - as soon they
+  will be approved by the European Commission - subsequent
+  versions of the EUPL (the "Licence");
+  You may not use this work except in compliance with the
+  Licence. You may obtain a copy of the Licence at
+  <http://ec.europa.eu/idabc/eupl/>.
+  
+  Unless required by applicable law or agreed to in
+  writing, software distributed under the Licence is
+  distributed on an "AS IS" basis, WITHOUT WARRANTIES OR
+  CONDITIONS OF ANY KIND, either expressed or implied.
+  See the Licence for the specific language governing
+  permissions and limitations under the Licence.
+*/
+
+
+#ifndef SCOREPRESS_ATOM_HH
+#define SCOREPRESS_ATOM_HH
+
+#include <string>       // std::string
+#include <vector>       // std::vector
+#include <utility>      // std::pair
+
+#include "export.hh"
+
+namespace ScorePress
+{
+//  CLASSES
+// ---------
+class SCOREPRESS_API AtomTable;     // global table of the interned strings
+template <typename T>
+class AtomMap;                      // compact map from atoms to values
+
+typedef unsigned int Atom;          // interned string
+
+// predefined atoms (sprite properties read by the engraver)
+enum PredefinedAtom
+{
+    ATOM_ANCHOR_X, ATOM_ANCHOR_Y,                       // "anchor.x", "anchor.y"
+    ATOM_STEM_X, ATOM_STEM_Y,                           // "stem.x", "stem.y"
+    ATOM_OFFSET, ATOM_DISTANCE, ATOM_LINE,              // "offset", "distance", "line"
+    ATOM_STEM_SLOPE, ATOM_STEM_MINLEN,                  // "stem.slope", "stem.minlen"
+    ATOM_STEM_TOP_X1, ATOM_STEM_TOP_Y1, ATOM_STEM_TOP_X2, ATOM_STEM_TOP_Y2,                 // "stem.top.*"
+    ATOM_STEM_BOTTOM_X1, ATOM_STEM_BOTTOM_Y1, ATOM_STEM_BOTTOM_X2, ATOM_STEM_BOTTOM_Y2,     // "stem.bottom.*"
+    ATOM_BASENOTE, ATOM_KEYBOUND_SHARP, ATOM_KEYBOUND_FLAT,     // "basenote", "keybound.sharp", "keybound.flat"
+    ATOM_HMIN, ATOM_HMAX, ATOM_LOW, ATOM_HIGH,          // "hmin", "hmax", "low", "high"
+    ATOM_LINEWIDTH,                                     // "linewidth"
+    ATOM_PREDEFINED                                     // (number of predefined atoms)
+};
+
+
+//
+//     class AtomTable
+//    =================
+//
+// This table interns strings (i.e. the property keys and ids of the sprites),
+// handing out a small integer (the atom) for each distinct string. Atoms are
+// never released; thus equal strings always yield the same atom. The keys used
+// by the engraver are interned in advance in the order of the enumeration
+// above, such that they can be used without any lookup. The table is shared by
+// all threads (and protected by a mutex).
+//
+class SCOREPRESS_API AtomTable
+{
+ public:
+    static Atom               intern(const std::string& name);              // get the atom of the string (adding it, if necessary)
+    static bool               find(const std::string& name, Atom& atom);    // get the atom of the string (if interned)
+    static const std::string& name(const Atom atom);                        // get the string of the atom
+};
+
+
+//
+//     class AtomMap
+//    ===============
+//
+// Map from atoms to values, stored as an array of pairs sorted by the atoms.
+// The lookup is a binary search on integers; the sprite properties usually
+// consist of a handful of entries, so the array is far more compact than a
+// tree. The string methods are thin wrappers, interning the string for the
+// insertion and looking it up (without interning) for the search.
+// Like "std::vector", inserting may invalidate iterators and references.
+//
+template <typename T> class AtomMap
+{
+ public:
+    // typedefs
+    typedef std::pair<Atom, T>                               value_type;
+    typedef typename std::vector<value_type>::iterator       iterator;
+    typedef typename std::vector<value_type>::const_iterator const_iterator;
+    
+ private:
+    std::vector<value_type> entries;    // entries (sorted by the atoms)
+    
+    iterator       lower_bound(const Atom atom);        // first entry not less than the atom
+    const_iterator lower_bound(const Atom atom) const;
+    
+ public:
+    // iterators
+    iterator       begin();
+    const_iterator begin() const;
+    iterator       end();
+    const_iterator end()   const;
+    
+    // size
+    bool   empty() const;
+    size_t size()  const;
+    void   clear();
+    
+    // lookup
+    iterator       find(const Atom atom);               // get the entry of the atom (or "end()")
+    const_iterator find(const Atom atom) const;
+    iterator       find(const std::string& key);        // get the entry of the string (or "end()")
+    const_iterator find(const std::string& key) const;
+    
+    // element access (inserting a default value, if necessary)
+    T& operator [] (const Atom atom);
+    T& operator [] (const std::string& key);
+};
+
+// method implementations
+template <typename T>
+typename AtomMap<T>::iterator AtomMap<T>::lower_bound(const Atom atom)
+{
+    size_t low = 0, high = entries.size();
+    while (low < high)
+    {
+        const size_t mid = (low + high) / 2;
+        if (entries[mid].first < atom) low = mid + 1; else high = mid;
+    };
+    return entries.begin() + static_cast<std::ptrdiff_t>(low);
+}
+
+template <typename T>
+typename AtomMap<T>::const_iterator AtomMap<T>::lower_bound(const Atom atom) const
+{
+    size_t low = 0, high = entries.size();
+    while (low < high)
+    {
+        const size_t mid = (low + high) / 2;
+        if (entries[mid].first < atom) low = mid + 1; else high = mid;
+    };
+    return entries.begin() + static_cast<std::ptrdiff_t>(low);
+}
+
+template <typename T> inline typename AtomMap<T>::iterator       AtomMap<T>::begin()       {return entries.begin();}
+template <typename T> inline typename AtomMap<T>::const_iterator AtomMap<T>::begin() const {return entries.begin();}
+template <typename T> inline typename AtomMap<T>::iterator       AtomMap<T>::end()         {return entries.end();}
+template <typename T> inline typename AtomMap<T>::const_iterator AtomMap<T>::end()   const {return entries.end();}
+
+template <typename T> inline bool   AtomMap<T>::empty() const {return entries.empty();}
+template <typename T> inline size_t AtomMap<T>::size()  const {return entries.size();}
+template <typename T> inline void   AtomMap<T>::clear()       {entries.clear();}
+
+template <typename T>
+inline typename AtomMap<T>::iterator AtomMap<T>::find(const Atom atom)
+{
+    const iterator i = lower_bound(atom);
+    return (i != entries.end() && i->first == atom) ? i : entries.end();
+}
+
+template <typename T>
+inline typename AtomMap<T>::const_iterator AtomMap<T>::find(const Atom atom) const
+{
+    const const_iterator i = lower_bound(atom);
+    return (i != entries.end() && i->first == atom) ? i : entries.end();
+}
+
+template <typename T>
+inline typename AtomMap<T>::iterator AtomMap<T>::find(const std::string& key)
+{
+    Atom atom;
+    return AtomTable::find(key, atom) ? find(atom) : entries.end();
+}
+
+template <typename T>
+inline typename AtomMap<T>::const_iterator AtomMap<T>::find(const std::string& key) const
+{
+    Atom atom;
+    return AtomTable::find(key, atom) ? find(atom) : entries.end();
+}
+
+template <typename T>
+T& AtomMap<T>::operator [] (const Atom atom)
+{
+    iterator i = lower_bound(atom);
+    if (i == entries.end() || i->first != atom) i = entries.insert(i, value_type(atom, T()));
+    return i->second;
+}
+
+template <typename T>
+inline T& AtomMap<T>::operator [] (const std::string& key) {return (*this)[AtomTable::intern(key)];}
+
+} // end namespace
+
+#endif
+
@@ -30,6 +30,7 @@
 #include "fraction.hh"     // Fraction
 #include "sprite_id.hh"    // SpriteId
 #include "parameters.hh"   // LayoutParam, StyleParam, ViewportParam
+#include "arena.hh"        // ObjectPool, PoolAllocator
 #include "export.hh"
 
 namespace ScorePress
@@ -104,12 +105,12 @@ typedef SmartPtr<StaffObject, CloneTrait> StaffObjectPtr;   // smart pointer to
 typedef SmartPtr<VoiceObject, CloneTrait> VoiceObjectPtr;   // smart pointer to note-object
 typedef SmartPtr<SubVoice,    CloneTrait> SubVoicePtr;      // smart pointer to sub-voice
 
-typedef std::list<MovablePtr>             MovableList;      // list of smart pointers to movable objects
-typedef std::list<HeadPtr>                HeadList;         // list of smart pointers to heads
-typedef std::list<Articulation>           ArticulationList; // list of articulation symbols
-typedef std::list<StaffObjectPtr>         StaffObjectList;  // list of smart pointers to staff-objects
-typedef std::list<VoiceObjectPtr>         VoiceObjectList;  // list of smart pointers to note-objects
-typedef std::list<SubVoicePtr>            SubVoiceList;     // list of smart pointers to sub-voices
+typedef std::list<MovablePtr,     PoolAllocator<MovablePtr> >     MovableList;      // list of smart pointers to movable objects
+typedef std::list<HeadPtr,        PoolAllocator<HeadPtr> >        HeadList;         // list of smart pointers to heads
+typedef std::list<Articulation,   PoolAllocator<Articulation> >   ArticulationList; // list of articulation symbols
+typedef std::list<StaffObjectPtr, PoolAllocator<StaffObjectPtr> > StaffObjectList;  // list of smart pointers to staff-objects
+typedef std::list<VoiceObjectPtr, PoolAllocator<VoiceObjectPtr> > VoiceObjectList;  // list of smart pointers to note-objects
+typedef std::list<SubVoicePtr,    PoolAllocator<SubVoicePtr> >    SubVoiceList;     // list of smart pointers to sub-voices
 
 
 //
@@ -164,6 +165,10 @@ class SCOREPRESS_API Class
     virtual classType classtype() const = 0;
     virtual Class* clone() const = 0;
     virtual ~Class();
+    
+    // memory management (taking the objects from the object pool)
+    static void* operator new(size_t size)               {return ObjectPool::allocate(size);}
+    static void  operator delete(void* ptr, size_t size) {ObjectPool::deallocate(ptr, size);}
 };
 
 // returns a human readable class name (for debugging purposes)
@@ -21,7 +21,7 @@
 #ifndef SCOREPRESS_CONTEXT_HH
 #define SCOREPRESS_CONTEXT_HH
 
-#include <map>          // std::map
+#include <cstddef>      // size_t
 
 #include "classes.hh"   // [score classes]
 #include "error.hh"     // ScorePress::Error
@@ -53,8 +53,10 @@ class SCOREPRESS_API VoiceContext
     int _volume;                    // current volume (0..127)
     unsigned int _value_modifier;   // note-length' multiplicator during playback (in promille)
     
-    // measure context
-    TimeSig _time_sig;              // current time-signature
+    // measure context (the fields of the current time-signature)
+    unsigned char _time_number;     // number of beats per measure
+    unsigned char _time_beat;       // length of a beat
+    Appearance    _time_appearance; // appearance of the time-signature
     value_t _time_time;             // time-position of that signature
     unsigned long _time_bar;        // bar index of the time-signature
     
@@ -65,16 +67,17 @@ class SCOREPRESS_API VoiceContext
         mpx_t xpos;                 // horizontal position of the last engraved object
     } _buffer, _buffer2;
     
+    value_t beat_length() const;    // length of a measure
+    
  public:
-    // constructors
+    // constructor
     VoiceContext();     // default voice-context (full volume, 85% value modifier, 4/4 time-signature)
-    VoiceContext(const VoiceContext& context);      // copy constructor
     
     // accessors
     unsigned long bar(const value_t time) const;    // calculate the index of the bar, containing the given time
     value_t beat(const value_t time) const;         // calculate the beat inside the bar (modulo operation)
     value_t restbar(const value_t time) const;      // calculate the value of the remaining bar
-    const TimeSig& last_timesig() const;            // return the last time-signature
+    TimeSig last_timesig() const;                   // create a copy of the last time-signature (without attached objects)
     
     // modifiers
     void modify(const ContextChanging&, bool vol);  // let the context-changing instance change this context
@@ -92,13 +95,18 @@ class SCOREPRESS_API VoiceContext
     void set_buffer_xpos(const mpx_t xpos);         // set last object position
     mpx_t get_buffer_xpos() const;                  // get last object position
     mpx_t get_buffer2_xpos() const;                 // get next-to-last object position
+    
+    // comparison
+    bool operator == (const VoiceContext& context) const;
+    bool operator != (const VoiceContext& context) const;
 };
 
 // inline method implementations
-inline       unsigned long VoiceContext::bar(const value_t time)         const {return _time_bar + ((time - _time_time) / _time_sig.beat_length()).i_abs();}
-inline       value_t       VoiceContext::beat(const value_t time)        const {return (time - _time_time) % _time_sig.beat_length();}
-inline       value_t       VoiceContext::restbar(const value_t time)     const {return _time_sig.beat_length() - beat(time);}
-inline const TimeSig&      VoiceContext::last_timesig()                  const {return _time_sig;}
+inline       value_t       VoiceContext::beat_length()                   const {return value_t(static_cast<long>(_time_number) << VALUE_BASE,
+                                                                                              static_cast<long>(_time_beat));}
+inline       unsigned long VoiceContext::bar(const value_t time)         const {return _time_bar + ((time - _time_time) / beat_length()).i_abs();}
+inline       value_t       VoiceContext::beat(const value_t time)        const {return (time - _time_time) % beat_length();}
+inline       value_t       VoiceContext::restbar(const value_t time)     const {return beat_length() - beat(time);}
 inline       bool          VoiceContext::has_buffer()                    const {return _buffer.object != NULL;}
 inline       bool          VoiceContext::has_buffer2()                   const {return _buffer2.object != NULL;}
 inline       void          VoiceContext::reset_buffer()                        {_buffer = _buffer2; _buffer2.object = NULL;}
@@ -108,6 +116,7 @@ inline const StaffObject*  VoiceContext::get_buffer2()                   const {
 inline       void          VoiceContext::set_buffer_xpos(const mpx_t xpos)     {_buffer.xpos = xpos;}
 inline       mpx_t         VoiceContext::get_buffer_xpos()               const {return _buffer.xpos;}
 inline       mpx_t         VoiceContext::get_buffer2_xpos()              const {return _buffer2.xpos;}
+inline       bool          VoiceContext::operator != (const VoiceContext& context) const {return !(*this == context);}
 
 
 //
@@ -132,26 +141,42 @@ class SCOREPRESS_API StaffContext
     class SCOREPRESS_API IllegalKeyException : public Error        // thrown, if the index of the key-signature symbol is out of range 0-6
         {public: IllegalKeyException();};
     
-    typedef std::map<int, Accidental::Type> AccidentalMap;
+    static const size_t ACCIDENTAL_COUNT = 7 * 22;  // number of whole tones (reachable by a "tone_t" and its accidental)
     
  private:
-    // clef context
-    Clef    _clef;                  // copy of the last clef instance
-    Key     _key;                   // copy of the last key instance
-    tone_t  _base_note;             // note in first space from top
+    // clef context (the fields of the last clef)
+    SpriteId      _clef_sprite;         // sprite of the clef
+    tone_t        _clef_base;           // tone residing on the clef's line
+    unsigned char _clef_line;           // line of the clef's base-note
+    tone_t        _keybnd_sharp;        // lowest tone for sharp-key display
+    tone_t        _keybnd_flat;         // lowest tone for flat-key display
+    Appearance    _clef_appearance;     // appearance of the clef
+    tone_t        _base_note;           // note in first space from top
+    
+    // key context (the fields of the last key)
+    Key::Type     _key_type;            // key type
+    char          _key_number;          // number of accidentals
+    SpriteId      _key_sprite;          // accidental sprite
+    Appearance    _key_appearance;      // appearance of the key
     
     // key/accidentals context
     unsigned short _key_acc;        // current key accidentals (14 bit, one per note and accidental)
-    AccidentalMap  _accidentals;    // currently used accidentals
+    
+    // currently used accidentals (indexed by the whole tone; only the entries of the current generation are valid,
+    // so that resetting them only increments the generation)
+    unsigned char  _acc_generation;                     // current generation
+    unsigned char  _acc_generations[ACCIDENTAL_COUNT];  // generation of each entry
+    unsigned char  _accidentals[ACCIDENTAL_COUNT];      // accidental type of each entry
+    
+    void clear_acc() noexcept;      // invalidate all memorized accidentals (on the overflow of the generation)
     
  public:
-    // constructors
+    // constructor
     StaffContext();                 // default staff-context (treble clef, C major key)
-    StaffContext(const StaffContext& context);      // copy constructor
     
     // member access
-    const Clef&    last_clef()    const noexcept;
-    const Key&     last_key()     const noexcept;
+    Clef           last_clef()    const;    // create a copy of the last clef (without attached objects)
+    Key            last_key()     const;    // create a copy of the last key (without attached objects)
     const tone_t&  base_note()    const noexcept;
     const tone_t&  keybnd_sharp() const noexcept;
     const tone_t&  keybnd_flat()  const noexcept;
@@ -174,17 +199,20 @@ class SCOREPRESS_API StaffContext
     static bool      check_accidental(const tone_t, const Accidental::Type);// check if the accidental is OK
     Accidental::Type get_key_accidental(const tone_t)              const;   // check if the tone got a key accidental
     Accidental::Type guess_accidental(const tone_t, bool pref_nat) const;   // calculate a nice accidental for the tone
+    
+    // comparison
+    bool operator == (const StaffContext& context) const;
+    bool operator != (const StaffContext& context) const;
 };
 
 // inline method implementations
-inline const Clef&    StaffContext::last_clef()    const noexcept {return _clef;}
-inline const Key&     StaffContext::last_key()     const noexcept {return _key;}
-inline const tone_t&  StaffContext::base_note()    const noexcept {return _clef.base_note;}
-inline const tone_t&  StaffContext::keybnd_sharp() const noexcept {return _clef.keybnd_sharp;}
-inline const tone_t&  StaffContext::keybnd_flat()  const noexcept {return _clef.keybnd_flat;}
-inline       void     StaffContext::reset_acc()          noexcept {_accidentals.clear();}
+inline const tone_t&  StaffContext::base_note()    const noexcept {return _clef_base;}
+inline const tone_t&  StaffContext::keybnd_sharp() const noexcept {return _keybnd_sharp;}
+inline const tone_t&  StaffContext::keybnd_flat()  const noexcept {return _keybnd_flat;}
+inline       void     StaffContext::reset_acc()          noexcept {if (++_acc_generation == 0) clear_acc();}
 
 inline       bool     StaffContext::on_line(const Head& head) const {return (note_offset(head, 2) % 2 == 1);}
+inline       bool     StaffContext::operator != (const StaffContext& context) const {return !(*this == context);}
 
 
 //
@@ -204,8 +232,16 @@ class SCOREPRESS_API ScoreContext
     
     // modifiers
     void modify(const ContextChanging& changer);   // let the context-changing instance cahnge the tempo
+    
+    // comparison
+    bool operator == (const ScoreContext& context) const;
+    bool operator != (const ScoreContext& context) const;
 };
 
+// inline method implementations
+inline bool ScoreContext::operator == (const ScoreContext& context) const {return _tempo == context._tempo;}
+inline bool ScoreContext::operator != (const ScoreContext& context) const {return _tempo != context._tempo;}
+
 } // end namespace
 
 #endif
@@ -92,6 +92,9 @@ class SCOREPRESS_API EditCursor : public UserCursor
     // set the given cursor "beam_begin" to the first note within the current beam-group
     SCOREPRESS_LOCAL bool get_beam_begin(VoiceCursor& beam_begin) const;
     
+    // mark the current line as edited (to be reengraved, see "Engine::reengrave")
+    SCOREPRESS_LOCAL void set_edited();
+    
  public:
     // constructors
     EditCursor(      Document&       document,
@@ -125,7 +128,7 @@ class SCOREPRESS_API EditCursor : public UserCursor
     using UserCursor::get_dimension;
     using UserCursor::get_page_attached;
     
-    // access methods (non-constant)
+    // access methods (non-constant; the score data access marks the current line as edited)
     Document&       get_document() noexcept;    // return the document
     Score&          get_score()    noexcept;    // return the score-object
     Staff&          get_staff();                // return the staff
@@ -192,6 +195,8 @@ inline Pageset::pPage& EditCursor::get_page()       noexcept {return *page;}
 inline Plate&          EditCursor::get_plate()      noexcept {return *plateinfo->plate;}
 inline Plate::pLine&   EditCursor::get_line()       noexcept {return *line;}
 
+inline void EditCursor::set_edited() {if (plateinfo) line->edited = true;}
+
 } // end namespace
 
 #endif
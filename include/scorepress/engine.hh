@@ -21,11 +21,20 @@
 #ifndef SCOREPRESS_ENGINE_HH
 #define SCOREPRESS_ENGINE_HH
 
+#include <set>              // std::set
+#include <vector>           // std::vector
+#include <thread>           // std::thread
+#include <mutex>            // std::mutex, std::lock_guard
+#include <atomic>           // std::atomic
+#include <exception>        // std::exception_ptr
+
 #include "engraver.hh"      // Engraver
 #include "press.hh"         // Press, Plate, Pageset, ViewportParam, StyleParam, UserCursor
 #include "renderer.hh"      // Renderer, Sprites
+#include "recording_renderer.hh"  // RecordingRenderer, DisplayList
 #include "edit_cursor.hh"   // EditCursor, CursorBase
 #include "parameters.hh"    // InterfaceParam
+#include "statistics.hh"    // Statistics
 #include "error.hh"         // Error
 #include "log.hh"           // Logging
 #include "export.hh"
@@ -81,11 +90,17 @@ class SCOREPRESS_API Engine : public Logging
         inline const Pageset::pPage& get_data()  const {return *it;}
     };
     
+    // callback for the background engraving (called from the engraving thread, with the number of finished pages)
+    typedef void (*ready_callback_t)(Engine& engine, const size_t pages, void* data);
+    
  private:
     // cursor management typedefs
     typedef RefPtr<CursorBase>   CursorPtr;
     typedef std::list<CursorPtr> CursorList;
     
+    // set of partially engraved scores
+    typedef std::set<const Score*> ScoreSet;
+    
     // private data
     Document*      document;    // the document this engine operates on
     Pageset        pageset;     // target pageset
@@ -94,24 +109,89 @@ class SCOREPRESS_API Engine : public Logging
     ViewportParam  viewport;    // viewport parameters
     InterfaceParam interface;   // interface parameters
     CursorList     cursors;     // cursors (registered for reengrave)
+    Statistics     statistics;  // performance counters (see "statistics.hh")
+    
+    // lazy engraving
+    bool           lazy;        // engrave the pages on demand?
+    bool           pending;     // is the lazy engraving incomplete?
+    size_t         ready_pages; // number of pages engraved completely (while pending)
+    ScoreSet       partial;     // scores engraved partially (while pending)
+    
+    // background engraving
+    std::thread        worker;          // engraving thread
+    mutable std::mutex lock;            // guards the pageset (while the engraving thread is running)
+    std::atomic<bool>  running;         // is the engraving thread running?
+    std::atomic<bool>  cancelled;       // shall the engraving thread stop?
+    std::exception_ptr error;           // exception thrown within the engraving thread
+    ready_callback_t   on_ready;        // callback for finished pages
+    void*              on_ready_data;   // user data for the callback
+    
+    // display lists
+    bool                     recording;         // replay the recorded pages (instead of rendering the plates)?
+    RecordingRenderer        recorder;          // renderer recording the pages
+    std::vector<DisplayList> display_lists;     // recorded pages (at zero offset; empty, if not yet recorded)
+    const Renderer*          recorded_for;      // renderer providing the sprites of the recorded pages
+    promille_t               recorded_scale;    // press scale of the recorded pages
+    
+    // engraving (without locking)
+    void engrave_document();                // engrave the whole document
+    void start_partial();                   // prepare the pageset for a partial engraving
+    void engrave_to(const size_t page);     // engrave the pages up to the given one (see "engrave_pages")
+    size_t ready_count() const;             // number of finished pages
+    
+    // display lists
+    void discard_pages(const size_t page = 0);  // discard the recorded pages from the given one on
+    void render_recorded(Renderer& renderer, const size_t idx, const Pageset::pPage& page, const Position<mpx_t>& offset);
+    
+    // rendering (without locking)
+    void render_single(Renderer& renderer, const size_t idx, const Pageset::pPage& page, const Position<mpx_t>& pos,
+                       const Plate::GphBox* visible, bool decor);   // render a page at the given position
+    
+    // background engraving
+    void engrave_thread();                  // engrave the pages one by one (thread function)
+    void join_thread();                     // wait for the engraving thread (rethrows its exception)
     
  protected:
     // calculate page base position for the given multipage-layout
     const Position<mpx_t> page_pos(const size_t pageno, const MultipageLayout layout) const;
     
+    // calculate the range of pages intersecting the given rectangle (relative to the layout; returns false, if there are none)
+    bool page_range(const Plate::GphBox& rect, const MultipageLayout layout, size_t& first, size_t& last) const;
+    
+    // find the page containing the given position (returns the last page, if there is none; engraves the pages up to it)
+    Pageset::Iterator find_page(const Position<mpx_t>& pos, const MultipageLayout layout, size_t& idx);
+    
     Pageset::PlateInfo& select_plate(const Position<mpx_t>& pos, Page& page);                   // get plateinfo by position (on page)
     Pageset::PlateInfo& select_plate(const Position<mpx_t>& pos, const MultipageLayout layout); // get plateinfo by position (muti-page)
     
  public:
     // constructor (specifying the document the engine will operate on)
     Engine(Document& document, const Sprites& sprites);
+    ~Engine();
     
     // setup
     void set_document(Document& document);                      // change the associated document
     void set_resolution(unsigned int hppm, unsigned int vppm);  // change screen resolution (viewport parameters)
+    void set_threads(unsigned int threads);                     // set number of engraving threads (1 for serial engraving)
+    void set_lazy(bool lazy);                                   // engrave the pages on demand (see "engrave_pages")
+    bool is_lazy() const;                                       // are the pages engraved on demand?
+    bool is_pending() const;                                    // is the lazy engraving incomplete?
+    
+    // engraving
     void engrave();                                             // engrave document (calculates pageset, invalidates cursors)
+    void engrave_pages(const size_t page);                      // engrave the pages up to the given one (lazy mode)
+    void finish_engraving();                                    // engrave the remaining pages (lazy mode; waits for the engraving thread)
+    void engrave_background();                                  // engrave document page by page on a background thread (invalidates cursors)
+    void cancel_engraving();                                    // stop the engraving thread (the finished pages are kept)
+    bool is_engraving() const;                                  // is the engraving thread running?
+    void set_ready_callback(ready_callback_t callback, void* data = NULL);  // notify about finished pages (background engraving)
+                                                                // (the document must not be edited while the engraving thread is running;
+                                                                //  "engrave", "reengrave" and "set_document" cancel the engraving thread)
     void reengrave();                                           // engrave document (recalculate cursors)
-    void reengrave(UserCursor& cursor);                         // reengrave score  (recalculate cursors)
+    void reengrave(UserCursor& cursor);                         // reengrave score  (recalculate cursors; from the first edited line on)
+                                                                // (includes the cursor's line and all lines edited through an "EditCursor"
+                                                                //  since their engraving; edits of styles, score dimensions or parameters,
+                                                                //  or of score objects not accessed through a cursor, require "reengrave()")
     
     // internal data access
     Document&              get_document();                      // the document this engine operates on
@@ -130,10 +210,14 @@ class SCOREPRESS_API Engine : public Logging
     
     void plate_dump() const;                                    // write plate-content to stdout
     
+    // performance counters (only updated, if the library is compiled with "STATISTICS" defined)
+    Statistics get_statistics() const;                          // accumulated run-times and object counts
+    void       reset_statistics();                              // set all counters to zero
+    
     // dimension information
     mpx_t  page_width()  const;                                 // graphical page width
     mpx_t  page_height() const;                                 // graphical page height
-    size_t page_count()  const;                                 // page count
+    size_t page_count()  const;                                 // page count (in lazy or background mode, the number of pages engraved so far)
     mpx_t  layout_width(const MultipageLayout layout)  const;   // width of complete layout
     mpx_t  layout_height(const MultipageLayout layout) const;   // height of complete layout
     
@@ -141,6 +225,17 @@ class SCOREPRESS_API Engine : public Logging
     void render_page(Renderer& renderer, const Page page,              const Position<mpx_t>& offset, bool decor = false);          // single page (at pos)
     void render_all( Renderer& renderer, const MultipageLayout layout, const Position<mpx_t>& offset, bool decor = false);          // all pages (with layout)
     
+    void render_page(Renderer& renderer, const Page page,              const Position<mpx_t>& offset, const Plate::GphBox& visible, bool decor = false);  // visible part of a page
+    void render_all( Renderer& renderer, const MultipageLayout layout, const Position<mpx_t>& offset, const Plate::GphBox& visible, bool decor = false);  // visible pages
+                                            // (the visible rectangle is given in the coordinates of the offset; the pages outside are skipped,
+                                            //  as well as the lines and attachables outside, unless the pages are replayed from display lists)
+    
+    void set_recording(bool recording);     // replay recorded display lists of the pages (recorded on first rendering)
+    bool is_recording() const;              // are the pages rendered through display lists?
+    void clear_recording();                 // discard the display lists (after changing the press parameters)
+                                            // (the lists are discarded by each engraving and on change of the renderer;
+                                            //  changes of the press scale are applied on replay)
+    
     void render_cursor(Renderer& renderer, const UserCursor&   cursor, const Position<mpx_t>& page_pos);                            // cursor (with page root)
     void render_cursor(Renderer& renderer, const UserCursor&   cursor, const MultipageLayout layout, const Position<mpx_t>& off);   // cursor (with layout)
     void render_cursor(Renderer& renderer, const ObjectCursor& cursor, const Position<mpx_t>& page_pos);                            // object frame (with page root)
@@ -201,14 +296,16 @@ inline const PressParam&     Engine::get_press_parameters()     const {return pr
 inline const InterfaceParam& Engine::get_interface_parameters() const {return interface;}
 inline const ViewportParam&  Engine::get_viewport()             const {return viewport;}
 
-inline void Engine::set_document(Document& _document)              {document = &_document; pageset.clear(); cursors.clear();}
 inline void Engine::set_resolution(unsigned int h, unsigned int v) {viewport.hppm = h; viewport.vppm = v;}
+inline void Engine::set_threads(unsigned int threads)              {engraver.set_threads(threads);}
+inline void Engine::set_lazy(bool _lazy)                           {lazy = _lazy;}
+inline bool Engine::is_lazy() const                                {return lazy;}
+inline bool Engine::is_engraving() const                           {return running;}
+inline bool Engine::is_recording() const                           {return recording;}
 
 inline mpx_t  Engine::page_width()  const {return (viewport.umtopx_h(document->page_layout.width)  * press.parameters.scale) / 1000;}
 inline mpx_t  Engine::page_height() const {return (viewport.umtopx_v(document->page_layout.height) * press.parameters.scale) / 1000;}
-inline size_t Engine::page_count()  const {return pageset.pages.size();}
-
-inline const Engine::Page Engine::select_page(const size_t page) {return Page(page, pageset.get_page(page));}
+inline size_t Engine::ready_count() const {return (pending && ready_pages < pageset.pages.size()) ? ready_pages : pageset.pages.size();}
 
 } // end namespace
 
@@ -22,6 +22,7 @@
 #define SCOREPRESS_ENGRAVEINFO_HH
 
 #include <map>          // std::map
+#include <vector>       // std::vector
 
 #include "plate.hh"     // Plate
 #include "stem_info.hh" // StemInfo
@@ -38,8 +39,9 @@ struct  SCOREPRESS_LOCAL TieInfo;        // tie-information structure
 struct  SCOREPRESS_LOCAL DurableInfo;    // durable-information structure
 struct  SCOREPRESS_LOCAL SpaceInfo;      // space-info structure
 struct  SCOREPRESS_LOCAL LineInfo;       // line-info structure
-typedef std::map<Plate::pVoice*, BeamInfo>   BeamInfoMap;   // beam-information for every voice
+typedef std::vector<BeamInfo>                BeamInfoList;  // beam-information for every voice (indexed by the voice id)
 typedef std::map<tone_t, TieInfo>            TieInfoChord;  // tie-information for every tone
+typedef std::vector<TieInfoChord>            TieInfoList;   // tie-information for every voice (indexed by the voice id)
 typedef std::map<const Voice*, TieInfoChord> TieInfoMap;    // tie-information for every voice
 
 
@@ -85,9 +87,13 @@ class SCOREPRESS_LOCAL BeamInfo
                const unsigned long      time);      // time stamp
     
  public:
-    // constructor
+    // constructors
+    BeamInfo();                         // (without voice, see "ready")
     BeamInfo(Plate::pVoice& voice);
     
+    // check, if the host voice is set
+    bool ready() const;
+    
     // create beam information (first pass; only top beam; expecting the "object" to correspond to the last note in the "voice")
     void apply1(const Chord& object, const unsigned char beam_group, const StemInfo& info);
     
@@ -98,6 +104,9 @@ class SCOREPRESS_LOCAL BeamInfo
     void finish();
 };
 
+// inline method implementations
+inline bool BeamInfo::ready() const {return voice != NULL;}
+
 
 //
 //     struct TieInfo
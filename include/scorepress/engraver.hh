@@ -26,6 +26,7 @@
 #include "sprites.hh"        // Sprites
 #include "parameters.hh"     // EngraverParam, StyleParam, ViewportParam
 #include "reengrave_info.hh" // ReengraveInfo
+#include "statistics.hh"     // Statistics
 #include "log.hh"            // Logging
 #include "export.hh"
 
@@ -45,6 +46,8 @@ class SCOREPRESS_LOCAL Engraver;    // engraver, computing a renderable plate fr
 // library are given during the construction.
 // Internally an instance of "Pick" (as part of the "EngraverState") is used to
 // calculate the object positions.
+// If more than one thread is set, the scores of a document are engraved
+// concurrently into private pagesets, which are merged in document order.
 //
 class SCOREPRESS_LOCAL Engraver : public Logging
 {
@@ -52,9 +55,12 @@ class SCOREPRESS_LOCAL Engraver : public Logging
           Pageset*       pageset;           // target set of pages
     const Sprites*       sprites;           // pointer to the sprite-library (for the pick)
     const ViewportParam* viewport;          // viewport-parameters (see "parameters.hh")
+    unsigned int         threads;           // number of engraving threads (for documents)
+    Statistics*          statistics;        // performance counters (may be NULL)
     
  private:
     void engrave_attachables(const Document& data);    // engrave the on-page attachables
+    void engrave_parallel(const Document& data);       // engrave the scores concurrently
     
  public:
     EngraverParam parameters;  // engraving-parameters (see "parameters.hh")
@@ -66,16 +72,40 @@ class SCOREPRESS_LOCAL Engraver : public Logging
     void set_pageset(Pageset& pageset);                 // set the pageset
     void set_sprites(const Sprites& sprites);           // set the sprite-library
     void set_viewport(const ViewportParam& viewport);   // set the viewport
+    void set_threads(const unsigned int threads);       // set the number of threads (0 or 1 for serial engraving)
+    void set_statistics(Statistics* statistics);        // set the performance counters (NULL to disable)
     
     // get methods
     const Sprites&       get_sprites();                 // get the sprite-library
     const ViewportParam& get_viewport();                // get the viewport
+    unsigned int         get_threads() const;           // get the number of threads
     
     // engrave the score
     void engrave(const Score& score, const StyleParam& style, const size_t start_page, const unsigned int head_height);
     void engrave(const Score& score, const StyleParam& style, const size_t start_page, const unsigned int head_height, ReengraveInfo& info);
     // (engraving deletes and recreates all affected plates!)
     
+    // engrave the score up to the given page (returns true, if the score is complete)
+    bool engrave(const Score& score, const StyleParam& style, const size_t start_page, const unsigned int head_height, const size_t end_page);
+    bool proceed(const Score& score, const StyleParam& style, const size_t start_page, const unsigned int head_height, const size_t end_page);
+    // (on a partial engraving, the score's last line is left unengraved on the following page;
+    //  "proceed" continues a partial engraving at this line)
+    
+    // reengrave the score, beginning in front of the first edited line (returns the index of the first reengraved page)
+    size_t reengrave(const Score& score, const StyleParam& style, const size_t start_page, const unsigned int head_height, const Plate::pLine& line, ReengraveInfo& info);
+    // (the edited lines are the given one and those marked as edited (see "Plate::pLine::edited");
+    //  lines in front of the first edited one and unchanged lines after the last one are kept;
+    //  if the engraving cannot be resumed, the whole score is engraved)
+    
+    // resume the engraving of the score at the checkpoint of the given line
+    void resume(const Score& score, const StyleParam& style, const size_t start_page, const unsigned int head_height, const Plate::pLine& line);
+    bool resume(const Score& score, const StyleParam& style, const size_t start_page, const unsigned int head_height, const Plate::pLine& line, const size_t end_page);
+    // (the lines in front are kept, the following ones are engraved again;
+    //  if the line has got no valid checkpoint, the whole score is engraved)
+    
+    // prepare the pageset for the document (engraving the on-page attachables, but no scores)
+    void prepare(const Document& document);
+    
     // engrave the document
     void engrave(const Document& document);
     void engrave(const Document& document, ReengraveInfo& info);
@@ -86,10 +116,13 @@ class SCOREPRESS_LOCAL Engraver : public Logging
 inline void Engraver::set_pageset(Pageset& _pageset)               {pageset = &_pageset;}
 inline void Engraver::set_sprites(const Sprites& _sprites)         {sprites = &_sprites;}
 inline void Engraver::set_viewport(const ViewportParam& _viewport) {viewport = &_viewport;}
+inline void Engraver::set_threads(const unsigned int _threads)     {threads = _threads;}
+inline void Engraver::set_statistics(Statistics* _statistics)      {statistics = _statistics;}
 
 // get methods
 inline const Sprites&       Engraver::get_sprites()  {return *sprites;}
 inline const ViewportParam& Engraver::get_viewport() {return *viewport;}
+inline unsigned int         Engraver::get_threads() const {return threads;}
 
 } // end namespace
 
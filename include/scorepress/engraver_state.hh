@@ -25,8 +25,9 @@
 #include "pageset.hh"        // Pageset, Plate, ScoreContext, StaffContext, VoiceContext
 #include "pick.hh"           // Pick
 #include "sprites.hh"        // Sprites
-#include "engrave_info.hh"   // StemInfo, BeamInfo, BeamInfoMap, TieInfo, TieInfoChord, TieInfoMap, SpaceInfo, LineInfo, DurableInfo
+#include "engrave_info.hh"   // StemInfo, BeamInfo, BeamInfoList, TieInfo, TieInfoChord, TieInfoList, TieInfoMap, SpaceInfo, LineInfo, DurableInfo
 #include "reengrave_info.hh" // ReengraveInfo
+#include "statistics.hh"     // Statistics
 #include "parameters.hh"     // EngraverParam, StyleParam, ViewportParam
 #include "log.hh"            // Logging
 #include "export.hh"
@@ -45,12 +46,44 @@ class SCOREPRESS_LOCAL EngraverState;    // engraver, computing a renderable pla
 // This class represents the internal state of an "Engraver" instance during
 // the engraving process. It contains all the information necessary for the
 // engraving of a single object, including the "Pick" instance.
+// At the beginning of each line (i.e. after each newline and pagebreak) a
+// checkpoint is stored with the on-plate line. The engraving can be resumed at
+// any checkpoint, without engraving the lines in front of it again. During a
+// reengraving, the previous engraving of the following lines can be held. As
+// soon as the checkpoint at the beginning of a new line equals the one
+// recorded with a held line, the engravings converge and the held lines are
+// restored instead of being engraved again.
 //
 class SCOREPRESS_LOCAL EngraverState : public Logging
 {
+ public:
+    // engraver checkpoint at the beginning of an on-plate line
+    // (the beam-information is not recorded, since beams never cross the line end)
+    class Checkpoint : public Plate::pLine::Checkpoint
+    {
+     public:
+        typedef std::map<const Voice*, VoiceContext> VoiceContextMap;
+        
+     public:
+        Pick            pick;           // pick instance (at the first objects of the line)
+        TieInfoMap      tieinfo;        // tie positioning information (of the broken ties)
+        SpaceInfo       spaceinfo;      // information about accidental- and cluster-spacing
+        LineInfo        lineinfo;       // style information for the line
+        Plate::pLine    line;           // on-plate line before engraving (contexts and voice-ends)
+        VoiceContextMap voicectx;       // voice contexts at the end of the previous line (on the same plate)
+        size_t          pagecnt;        // page counter
+        size_t          barcnt;         // bar counter
+        value_t         start_time;     // line start time
+        value_t         end_time;       // end time of the engraved voices
+        bool            at_newline;     // got a voice without objects on this line? (see "Pick::at_newline")
+        
+        Checkpoint(const EngraverState& state);             // record the state (of the new target line)
+        bool operator == (const Checkpoint& state) const;   // check, if the engraving will continue identically
+    };
+    
  private:
-    // voice map type (maps "Voice" to the corresponding on-plate voice)
-    typedef std::map<const Voice*, Plate::VoiceIt> VoiceMap;
+    // voice map type (maps the voice id to the corresponding on-plate voice; the end of the line's voices, if not engraved yet)
+    typedef std::vector<Plate::VoiceIt> VoiceMap;
     
     // initial parameters
     const Sprites*       sprites;           // pointer to the sprite-library
@@ -60,13 +93,17 @@ class SCOREPRESS_LOCAL EngraverState : public Logging
     const StyleParam&    default_style;     // default staff-style
     const ViewportParam* viewport;          // viewport-parameters
           ReengraveInfo* reengrave_info;    // reengrave information
+          Statistics*    statistics;        // performance counters (see "statistics.hh")
     
     // info structures
-    VoiceMap    voiceinfo;          // maps "VoiceCursor" to the corresponding on-plate voice
-    BeamInfoMap beaminfo;           // beam-information for each voice
-    TieInfoMap  tieinfo;            // tie positioning information
-    SpaceInfo   spaceinfo;          // information about accidental- and cluster-spacing
-    LineInfo    lineinfo;           // style information for the currently engraved line
+    VoiceMap     voiceinfo;         // maps "VoiceCursor" to the corresponding on-plate voice
+    BeamInfoList beaminfo;          // beam-information for each voice
+    TieInfoList  tieinfo;           // tie positioning information
+    SpaceInfo    spaceinfo;         // information about accidental- and cluster-spacing
+    LineInfo     lineinfo;          // style information for the currently engraved line
+    
+    // scaled sprite metrics (built on demand)
+    MetricsCache metrics;
     
     // internal pick instance
     Pick pick;
@@ -86,6 +123,12 @@ class SCOREPRESS_LOCAL EngraverState : public Logging
     value_t start_time;             // line start time
     value_t end_time;               // line end time
     
+    // previous engraving (held during the reengraving of a partial score)
+    bool                resume;         // reengraving partially? (i.e. holding the previous engraving)
+    Plate::LineList     held_lines;     // remaining lines of the previous engraving on the current page
+    Pageset::PlateList  held_plates;    // plates of the previous engraving on the following pages
+    const Plate::pLine* dirty_line;     // last line containing the edited objects (NULL, after being discarded)
+    
  private:
     void engrave();             // engrave current note-object
     void create_lineend();      // calculate line-end info/line's rightmost border (see "Plate::pLine::line_end")
@@ -97,6 +140,13 @@ class SCOREPRESS_LOCAL EngraverState : public Logging
     
     void justify_line();        // justify the given line to fit into the score-area
     
+    void record_checkpoint();   // record the checkpoint at the beginning of the current line
+    void discard_line();        // discard the first held line
+    void discard_plate();       // discard the first held plate
+    bool reuse_plate();         // move the held plate of the current page to the pageset (if the dimension did not change)
+    bool converge();            // check for convergence with the held lines (and restore them on success)
+    void finish_resume();       // discard the remaining held engraving
+    
  public:
     Pageset::ScoreDimension dimtopx(const ScoreDimension& dim) const;                     // convert score-dimension from micrometer to millipixel
     Position<mpx_t>         movable_pos(const Movable& obj, const Position<>& pos) const; // calculate on-plate position of movable object
@@ -105,6 +155,9 @@ class SCOREPRESS_LOCAL EngraverState : public Logging
     // break all ties at the specified x-position
     static void break_ties(TieInfoChord& tieinfo, const mpx_t endpos, const mpx_t restartpos, const mpx_t head_height);
     
+    // get the tie-information of the current voice
+    TieInfoChord& get_voice_ties();
+    
  public:
     // constructor (will erase "score" from the "pageset" and prepare for engraving)
     EngraverState(const Score&         score,       // score object to be engraved
@@ -116,10 +169,30 @@ class SCOREPRESS_LOCAL EngraverState : public Logging
                   const StyleParam&    style,       // default staff-style (may be overridden by score)
                   const ViewportParam& viewport);   // viewport parameters
     
+    // constructor (will resume the engraving at the given line, holding the following lines for convergence;
+    //              without dirty line, the following engraving of the score is discarded)
+    EngraverState(const Score&         score,       // score object to be engraved
+                        Pageset&       pageset,     // target pageset
+                  Pageset::PageIt      page,        // page containing the line
+                  Pageset::PlateIt     plateinfo,   // plate containing the line
+                  Plate::LineIt        line,        // line to resume the engraving at (with checkpoint)
+                  const Plate::pLine*  dirty_line,  // last line containing edited objects (no convergence before)
+                  const Sprites&       sprites,     // sprite set
+                  const umpx_t         head_height, // default head-height (may be overridden by score)
+                  const EngraverParam& parameters,  // default engraver parameters (may be overridden by score)
+                  const StyleParam&    style,       // default staff-style (may be overridden by score)
+                  const ViewportParam& viewport);   // viewport parameters
+    
+    // get the checkpoint of the given line
+    static bool              has_checkpoint(const Plate::pLine& line);
+    static const Checkpoint& get_checkpoint(const Plate::pLine& line);
+    
     void set_reengrave_info(ReengraveInfo& info);
+    void set_statistics(Statistics* statistics);
     
     // state access
     inline const Sprites&            get_sprites()      const {return *sprites;}
+    inline       MetricsCache&       get_metrics()            {return metrics;}
     inline const EngraverParam&      get_parameters()   const {return *param;}
     inline const StyleParam&         get_style()        const {return *style;}
     inline const ViewportParam&      get_viewport()     const {return *viewport;}
@@ -187,15 +260,31 @@ class SCOREPRESS_LOCAL EngraverState : public Logging
 };
 
 // inline method implementations
+inline bool                              EngraverState::has_checkpoint(const Plate::pLine& line) {return !!line.checkpoint;}
+inline const EngraverState::Checkpoint&  EngraverState::get_checkpoint(const Plate::pLine& line) {return static_cast<const Checkpoint&>(*line.checkpoint);}
 inline void     EngraverState::set_reengrave_info(ReengraveInfo& info)     {reengrave_info = &info;}
-inline void     EngraverState::add_tieinfo(const TiedHead& thead)          {tieinfo[&get_voice()][thead.tone].source = &thead; tieinfo[&get_voice()][thead.tone].target = &pnote->ties.back();}
-inline bool     EngraverState::has_tie(const Head& head)                   {return (tieinfo[&get_voice()].find(head.tone) != tieinfo[&get_voice()].end());}
-inline TieInfo& EngraverState::get_tieinfo(const Head& head)               {return tieinfo[&get_voice()][head.tone];}
-inline void     EngraverState::erase_tieinfo(const Head& head)             {tieinfo[&get_voice()].erase(head.tone);}
-inline void     EngraverState::erase_tieinfo()                             {tieinfo[&get_voice()].clear();}
-inline void     EngraverState::break_ties()                                {break_ties(tieinfo[&get_voice()], pnote->gphBox.pos.x, pnote->gphBox.right(), pvoice->head_height);}
+inline void     EngraverState::set_statistics(Statistics* _statistics)     {statistics = _statistics;}
+inline bool     EngraverState::has_tie(const Head& head)                   {const TieInfoChord& ties = get_voice_ties(); return (ties.find(head.tone) != ties.end());}
+inline TieInfo& EngraverState::get_tieinfo(const Head& head)               {return get_voice_ties()[head.tone];}
+inline void     EngraverState::erase_tieinfo(const Head& head)             {get_voice_ties().erase(head.tone);}
+inline void     EngraverState::erase_tieinfo()                             {get_voice_ties().clear();}
+inline void     EngraverState::break_ties()                                {break_ties(get_voice_ties(), pnote->gphBox.pos.x, pnote->gphBox.right(), pvoice->head_height);}
 inline void     EngraverState::add_distance_after(mpx_t dst, value_t time) {pick.add_distance_after(dst, time);}
 
+inline TieInfoChord& EngraverState::get_voice_ties()
+{
+    const size_t voice = pick.get_cursor().voice_id;
+    if (voice >= tieinfo.size()) tieinfo.resize(voice + 1);
+    return tieinfo[voice];
+}
+
+inline void EngraverState::add_tieinfo(const TiedHead& thead)
+{
+    TieInfo& info = get_voice_ties()[thead.tone];
+    info.source = &thead;
+    info.target = &pnote->ties.back();
+}
+
 inline bool EngraverState::has_cluster_space() {
     if (spaceinfo.leftcluster_host == &*pick.get_cursor()) return false;
     spaceinfo.leftcluster_host = &*pick.get_cursor();
@@ -21,6 +21,8 @@
 #ifndef SCOREPRESS_FRACTION_HH
 #define SCOREPRESS_FRACTION_HH
 
+#include <limits>       // std::numeric_limits
+
 #include "export.hh"
 
 namespace ScorePress
@@ -35,7 +37,10 @@ class SCOREPRESS_API Fraction;    // class representing a rational number
 //    ================
 //
 // The fraction class implements all arithmetic operations on the field of
-// rational numbers.
+// rational numbers. Integers and fractions of the same denominator (i.e. all
+// regular note values and times) are added, subtracted and compared by inline
+// integer operations; only other values (and values which would overflow) take
+// the general way, reducing the fractions by their greatest common divisor.
 //
 class SCOREPRESS_API Fraction
 {
@@ -46,15 +51,21 @@ class SCOREPRESS_API Fraction
     // return the greatest common divisor
     SCOREPRESS_LOCAL static long gcd(long x, long y);
     
+    // general arithmetic (for values, which cannot be processed by the inline integer operations)
+    Fraction& add(const Fraction& fract);           // sum of two fractions
+    Fraction& sub(const Fraction& fract);           // difference of two fractions
+    Fraction& mod(const Fraction& fract);           // modulo operator for two fractions
+    Fraction& mod(const long fract);                // modulo operator for fraction and number
+    long      cmp(const Fraction& fract) const;     // comparison (returns the enumerator of the difference)
+    long      cmp(const long fract) const;
+    
  public:
     // constructors
     Fraction(const long x = 0);                         // create from an integer
     Fraction(const long e, const long d);               // create from a pair of enumerator and denominator
     Fraction(const long x, const long e, const long d); // create from a mixed fraction
-    Fraction(const Fraction& fract);                    // copy constructor
     
     // assignment operators
-    Fraction& operator = (const Fraction& fract);   // assign value
     Fraction& operator = (const long fract);        // assign integer value
     
     // arithmetic operators
@@ -105,6 +116,90 @@ class SCOREPRESS_API Fraction
     static const Fraction NDN;          // not a number (for values as 0/0 or INF/INF)
 };
 
+// constructors
+inline Fraction::Fraction(const long x) : enumerator(x), denominator(1l) {}
+
+// assignment operators
+inline Fraction& Fraction::operator = (const long fract) {enumerator = fract; denominator = 1l; return *this;}
+
+// arithmetic operators (adding the enumerators of equal positive denominators, unless they overflow)
+inline Fraction& Fraction::operator += (const Fraction& fract)
+{
+    if (denominator == fract.denominator && denominator > 0l
+        && ((fract.enumerator >= 0l) ? (enumerator <= std::numeric_limits<long>::max() - fract.enumerator)
+                                     : (enumerator >= std::numeric_limits<long>::min() - fract.enumerator)))
+    {
+        enumerator += fract.enumerator;
+        return *this;
+    };
+    return add(fract);
+}
+
+inline Fraction& Fraction::operator -= (const Fraction& fract)
+{
+    if (denominator == fract.denominator && denominator > 0l
+        && ((fract.enumerator >= 0l) ? (enumerator >= std::numeric_limits<long>::min() + fract.enumerator)
+                                     : (enumerator <= std::numeric_limits<long>::max() + fract.enumerator)))
+    {
+        enumerator -= fract.enumerator;
+        return *this;
+    };
+    return sub(fract);
+}
+
+inline Fraction& Fraction::operator %= (const Fraction& fract)
+{
+    if (denominator == 1l && fract.denominator == 1l && fract.enumerator > 0l) {enumerator %= fract.enumerator; return *this;};
+    return mod(fract);
+}
+
+inline Fraction& Fraction::operator %= (const long fract)
+{
+    if (denominator == 1l && fract > 0l) {enumerator %= fract; return *this;};
+    return mod(fract);
+}
+
+// equality operators
+inline bool Fraction::operator == (const Fraction& fract) const
+{
+    if (fract.denominator == 0l &&  // check if both fractions are infinite
+        denominator == 0l &&        // and check sign
+        ((enumerator < 0l && fract.enumerator < 0l) || (enumerator > 0l && fract.enumerator > 0l))) return true;
+    
+    return (enumerator == fract.enumerator && denominator == fract.denominator);    // else check normal equality
+}
+
+inline bool Fraction::operator == (const long fract) const
+{
+    return (enumerator == fract && denominator == 1l);  // check integer equality
+}
+
+inline bool Fraction::operator != (const Fraction& fract) const
+{
+    if (enumerator == fract.enumerator && denominator == fract.denominator) return false;   // check for normal equality
+    return (fract.denominator != 0l ||  // else check for infinite equality
+            denominator != 0l ||        // and sign
+            ((enumerator >= 0l || fract.enumerator >= 0l) && (enumerator <= 0l || fract.enumerator <= 0l)));
+}
+
+inline bool Fraction::operator != (const long fract) const
+{
+    return (enumerator != fract || denominator != 1l);  // check integer inequality
+}
+
+// comparison operators (comparing the enumerators of equal positive denominators)
+inline bool Fraction::operator <= (const Fraction& fract) const {return (denominator == fract.denominator && denominator > 0l) ? (enumerator <= fract.enumerator) : (cmp(fract) <= 0l);}
+inline bool Fraction::operator <= (const long      fract) const {return (denominator == 1l) ? (enumerator <= fract) : (cmp(fract) <= 0l);}
+inline bool Fraction::operator >= (const Fraction& fract) const {return (denominator == fract.denominator && denominator > 0l) ? (enumerator >= fract.enumerator) : (cmp(fract) >= 0l);}
+inline bool Fraction::operator >= (const long      fract) const {return (denominator == 1l) ? (enumerator >= fract) : (cmp(fract) >= 0l);}
+inline bool Fraction::operator <  (const Fraction& fract) const {return (denominator == fract.denominator && denominator > 0l) ? (enumerator <  fract.enumerator) : (cmp(fract) <  0l);}
+inline bool Fraction::operator <  (const long      fract) const {return (denominator == 1l) ? (enumerator <  fract) : (cmp(fract) <  0l);}
+inline bool Fraction::operator >  (const Fraction& fract) const {return (denominator == fract.denominator && denominator > 0l) ? (enumerator >  fract.enumerator) : (cmp(fract) >  0l);}
+inline bool Fraction::operator >  (const long      fract) const {return (denominator == 1l) ? (enumerator >  fract) : (cmp(fract) >  0l);}
+
+// cast operators
+inline Fraction::operator double() const {return static_cast<double>(enumerator) / static_cast<double>(denominator);}
+
 // access methods
 inline long          Fraction::i()       const {return enumerator / denominator;}
 inline unsigned long Fraction::i_abs()   const {return (enumerator < 0) ? -static_cast<unsigned long>(enumerator) : static_cast<unsigned long>(enumerator);}
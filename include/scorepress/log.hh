@@ -22,6 +22,7 @@
 #define SCOREPRESS_LOG_HH
 
 #include <fstream>      // std::ofstream
+#include <mutex>        // std::mutex
 
 #include "export.hh"
 
@@ -58,6 +59,7 @@ class SCOREPRESS_API Log
     
     // log file
     std::ofstream file;
+    std::mutex    lock;     // serializes output of concurrent engraver threads
     
  public:
     // constructor
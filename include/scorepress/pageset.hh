@@ -22,6 +22,7 @@
 #define SCOREPRESS_PAGESET_HH
 
 #include <list>            // std::list
+#include <vector>          // std::vector
 
 #include "plate.hh"        // Plate
 #include "document.hh"     // Document
@@ -79,6 +80,7 @@ class SCOREPRESS_LOCAL Pageset
         ScoreDimension();
         ScoreDimension(mpx_t x, mpx_t y, mpx_t w, mpx_t h);
         bool contains(const Position<mpx_t>& pos) const; // check, if the score-object contains a given point
+        bool operator == (const ScoreDimension& dim) const; // check, if both have the same position and size
     };
     
     // plate with information for the press on how to render it
@@ -94,6 +96,62 @@ class SCOREPRESS_LOCAL Pageset
         PlateInfo(const size_t pageno, const size_t start_page, const Score& score, const ScoreDimension& dim); // constructor
     };
     
+    class pPage;
+    
+    // spatial index of the graphical objects on one page (uniform grid)
+    class Index
+    {
+     public:
+        // indexed object types
+        enum Type {ATTACHABLE,      // on-page attachable (without plate and line)
+                   LINE,            // on-plate line (with its note-box)
+                   NOTE,            // on-plate note
+                   ATTACHED};       // attachable of an on-plate note
+        
+        // indexed object
+        struct Item
+        {
+            Type                type;       // object type
+            Plate::GphBox       box;        // boundary box (relative to the page, as the score dimensions)
+            PlateInfo*          plateinfo;  // plate containing the object (NULL for on-page attachables)
+            Plate::LineIt       line;       // line containing the object (undefined for on-page attachables)
+            Plate::pVoice*      voice;      // voice containing the object (NULL for lines and on-page attachables)
+            Plate::pNote*       note;       // note object or parent note (NULL for lines and on-page attachables)
+            Plate::pAttachable* attachable; // attachable object (NULL for lines and notes)
+        };
+        
+        typedef std::vector<const Item*> ItemList;
+        
+     private:
+        std::vector<Item>   items;      // indexed objects (in rendering order)
+        Plate::GphBox       bounds;     // boundary box of all objects
+        mpx_t               cell_w;     // cell width
+        mpx_t               cell_h;     // cell height
+        size_t              cols;       // number of columns
+        size_t              rows;       // number of rows
+        std::vector<size_t> cells;      // start of each cell within "entries" (with an additional end marker)
+        std::vector<size_t> entries;    // item indices of each cell (in ascending order)
+        bool                valid;      // is the index up to date?
+        
+        void add(const Type type, const Plate::GphBox& box, PlateInfo* plateinfo, Plate::LineIt line,
+                 Plate::pVoice* voice, Plate::pNote* note, Plate::pAttachable* attachable);
+                 
+     public:
+        // constructors (a copied index must be rebuilt, since it refers to the objects of the original page)
+        Index();
+        Index(const Index&);
+        Index& operator = (const Index&);
+        
+        void build(pPage& page);    // (re)build the index for the given page
+        void clear();               // remove all objects (marking the index outdated)
+        bool ready() const;         // is the index up to date?
+        size_t size() const;        // number of indexed objects
+        
+        // find the objects containing the given point or intersecting the given rectangle (in rendering order)
+        void find(const Position<mpx_t>& pos,  ItemList& result) const;
+        void find(const Plate::GphBox&   rect, ItemList& result) const;
+    };
+    
     // all rendering information for one page
     class pPage
     {
@@ -108,6 +166,7 @@ class SCOREPRESS_LOCAL Pageset
         size_t         pageno;          // pagenumber (within the document)
         PlateList      plates;          // plates for each visible score-object
         AttachableList attached;        // independent movable objects on the page
+        Index          index;           // spatial index of the objects (see "get_index")
         
         // find a plate belonging to a given score on this page
         Iterator       get_plate_by_score(const Score& score);
@@ -117,6 +176,9 @@ class SCOREPRESS_LOCAL Pageset
         Iterator       get_plate_by_pos(const Position<mpx_t>& pos);
         const_Iterator get_plate_by_pos(const Position<mpx_t>& pos) const;
         
+        // get the spatial index (built on demand, after the page has been changed)
+        const Index& get_index();
+        
         // constructor
         pPage(size_t pno);
     };
@@ -129,6 +191,12 @@ class SCOREPRESS_LOCAL Pageset
     typedef PageList::iterator       PageIt;
     typedef PlateList::iterator      PlateIt;
     
+ private:
+    std::vector<Iterator> table;    // page table (iterators to the pages, indexed by page number)
+    
+    void update_table();            // rebuild the page table
+    
+ public:
     // page layout
     PageDimension page_layout;
     
@@ -137,22 +205,37 @@ class SCOREPRESS_LOCAL Pageset
     umpx_t stem_width;  // default stem-width
     
     // list of all pages within the document
+    // (pages are only to be added and removed by the methods below, which keep the page table)
     PageList pages;
     
+    // constructors (a copied page table refers to the pages of the copy)
+    Pageset();
+    Pageset(const Pageset& pageset);
+    
+    // assignment (rebuilding the page table for the copied pages)
+    Pageset& operator = (const Pageset& pageset);
+    
     // remove plates
     void clear();                   // all
     void erase(const Score& score); // of the given score
     
+    // mark the spatial indices of all pages outdated (to be called after changing the plates)
+    void invalidate_index();
+    
     // append a new page to the list (and return iterator)
     Iterator add_page();
     
-    // get the page with the given index
+    // get the page with the given index (in constant time)
     Iterator       get_page(size_t pageno);             // (creates non-existing pages)
     const_Iterator get_page(size_t pageno) const;       // (on not existing page, returns pages.end())
+    size_t         page_count() const;                  // number of pages
     Iterator       get_first_page(const Score& score);  // get the first page of the given score
     
     // remove empty pages from the end of the pageset
     void remove_empty_pages();
+    
+    // move the plates of another pageset to the pages with the same index
+    void merge(Pageset& source);    // (appends the plates to each page; leaves "source" empty)
 };
 
 // inline method implementations
@@ -162,7 +245,22 @@ inline Pageset::ScoreDimension::ScoreDimension() : width(0), height(0) {}
 inline Pageset::ScoreDimension::ScoreDimension(mpx_t x, mpx_t y, mpx_t w, mpx_t h) : position(x, y), width(w), height(h) {}
 inline Pageset::pPage::pPage(size_t pno) : pageno(pno) {}
 
-inline void Pageset::clear() {pages.clear();}
+inline Pageset::Index::Index() : cell_w(1), cell_h(1), cols(0), rows(0), valid(false) {}
+inline Pageset::Index::Index(const Index&) : cell_w(1), cell_h(1), cols(0), rows(0), valid(false) {}
+inline Pageset::Index& Pageset::Index::operator = (const Index&) {clear(); return *this;}
+inline bool   Pageset::Index::ready() const {return valid;}
+inline size_t Pageset::Index::size()  const {return items.size();}
+
+inline const Pageset::Index& Pageset::pPage::get_index() {if (!index.ready()) index.build(*this); return index;}
+
+inline Pageset::Pageset() : head_height(0), stem_width(0) {}
+inline Pageset::Pageset(const Pageset& pageset) : page_layout(pageset.page_layout), head_height(pageset.head_height),
+                                                  stem_width(pageset.stem_width), pages(pageset.pages) {update_table();}
+
+inline void   Pageset::clear() {pages.clear(); table.clear();}
+inline size_t Pageset::page_count() const {return table.size();}
+
+inline Pageset::const_Iterator Pageset::get_page(size_t pageno) const {return (pageno < table.size()) ? const_Iterator(table[pageno]) : pages.end();}
 
 
 } // end namespace
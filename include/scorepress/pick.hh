@@ -22,12 +22,15 @@
 #define SCOREPRESS_PICK_HH
 
 #include <list>             // std::list
+#include <map>              // std::map
 #include <vector>           // std::vector
-#include <algorithm>        // std::make_heap, std::push_heap, std::pop_heap
+#include <algorithm>        // std::push_heap, std::pop_heap
+#include <utility>          // std::move
 
+#include "arena.hh"         // ObjectPool
 #include "score.hh"         // Score, Staff, LineLayout, [score classes]
 #include "cursor.hh"        // const_Cursor
-#include "sprites.hh"       // Sprites
+#include "sprites.hh"       // MetricsCache, SpriteMetrics
 #include "parameters.hh"    // EngraverParam, ViewportParam
 #include "refptr.hh"        // RefPtr
 #include "error.hh"         // Error, std::string
@@ -53,6 +56,9 @@ class SCOREPRESS_LOCAL Pick;     // position calculating iterator for a score ob
 class SCOREPRESS_LOCAL Pick : public Logging
 {
  public:
+    // engraving order of the object classes (precomputed for the queued cursors, see "compare")
+    enum Order {ORDER_PAGEBREAK, ORDER_NEWLINE, ORDER_TIMESIG, ORDER_KEY, ORDER_BARLINE, ORDER_CLEF, ORDER_OTHER};
+    
     // a special cursor containing position and time information about the note pointed to
     class VoiceCursor : public const_Cursor
     {
@@ -68,17 +74,28 @@ class SCOREPRESS_LOCAL Pick : public Logging
         StaffObjectPtr virtual_obj;         // virtual object
         bool           inserted;            // inserted or replacing the original object?
         value_t        remaining_duration;  // duration of the part not yet engraved
+        size_t         voice_id;            // dense index of the voice (see "VoiceOrder")
+        
+        Class::classType type;              // class of the object (sort key, set by "update_order")
+        Order            order;             // engraving order of the object's class (sort key)
         
      public:
         VoiceCursor();                              // default constructor
         bool at_end() const;                        // overwrite "at_end" to return "false", if virtual
+        void update_order();                        // precompute the sort key (for the current object)
         
         const StaffObject& original() const;        // return the original staff-object
         const StaffObject& operator * () const;     // return the staff-object the cursor points to
         const StaffObject* operator -> () const;    // return a pointer to the staff-object
+        
+        bool operator == (const VoiceCursor&) const;// compare position, time and virtual object
+        
+        // memory management (taking the cursors from the object pool)
+        static void* operator new(size_t size)               {return ObjectPool::allocate(size);}
+        static void  operator delete(void* ptr, size_t size) {ObjectPool::deallocate(ptr, size);}
     };
     
-    // line layout (collection of newlines for each voice)
+    // line layout (collection of newlines for each voice; indexed by the voice ids)
     class LineLayout
     {
      public:
@@ -86,80 +103,94 @@ class SCOREPRESS_LOCAL Pick : public Logging
         {public: VoiceNotFoundException();};
         
      private:
-        std::map<const Voice*, const LayoutParam*> data;    // maps voices to their layout parameters
-        const Voice* first_voice;                           // voice with line-properties
+        std::vector<const LayoutParam*> data;       // layout parameters of each voice (NULL, if not set)
+        size_t first_voice;                         // voice with line-properties
         
      public:
-        void set(const Voice&, const LayoutParam&); // associate a voice with its newline object
-        bool exist(const Voice&) const;             // check, if the voice has a newline object
-        const LayoutParam& get() const;             // get first newline object (for line-properties)
-        const LayoutParam& get(const Voice&) const; // get the newline object
-        void remove(const Voice&);                  // remove a voice's layout
-        void set_first_voice(const Voice&);         // set the voice for line-properties
-        void swap(LineLayout&);                     // swap contents
-        void clear();                               // clear data
+        LineLayout();                                       // default constructor
+        void set(const size_t voice, const LayoutParam&);   // associate a voice with its newline object
+        bool exist(const size_t voice) const;               // check, if the voice has a newline object
+        const LayoutParam& get() const;                     // get first newline object (for line-properties)
+        const LayoutParam& get(const size_t voice) const;   // get the newline object
+        void remove(const size_t voice);                    // remove a voice's layout
+        void set_first_voice(const size_t voice);           // set the voice for line-properties
+        void swap(LineLayout&);                             // swap contents
+        void clear();                                       // clear data
+        
+        bool operator == (const LineLayout&) const;         // compare the newline objects
     };
     
-    // maps voices to their index thus providing an order comparison for voices
-    class VoiceOrder : private std::map<const Voice*, size_t>
+    // assigns dense ids to the voices (in the order of their appearance; the staves
+    // first, getting the ids of their index) and provides an order comparison for
+    // voices (by the vertical rank of each id)
+    class VoiceOrder
     {
      public:
         class VoiceNotFoundException : public ScorePress::Error     // thrown, if non-existant voice is given
         {public: VoiceNotFoundException();};
         
+     private:
+        std::vector<const Voice*>      voices;  // voice of each id
+        std::vector<size_t>            ranks;   // vertical rank of each voice (indexed by the id)
+        std::map<const Voice*, size_t> ids;     // id of each voice
+        
+        size_t add(const Voice& voice, const size_t rank);          // assign the next id to the voice (at the given rank)
+        
      public:
-        void add_above(const Voice& voice, const Voice& parent);    // insert new voice above "parent"
-        void add_below(const Voice& voice, const Voice& parent);    // insert new voice above "parent"
-        void add_above(const Staff& staff);                         // insert new staff at the top
-        void add_below(const Staff& staff);                         // insert new staff at the bottom
+        size_t add_above(const Voice& voice, const size_t parent);  // insert new voice above "parent" (returning its id)
+        size_t add_below(const Voice& voice, const size_t parent);  // insert new voice below "parent" (returning its id)
+        size_t add_below(const Staff& staff);                       // insert new staff at the bottom (returning its id)
+        
+        bool         find(const Voice& voice, size_t& id) const;    // get the id of the voice (false, if not found)
+        size_t       get_id(const Voice& voice) const;              // get the id of the voice
+        const Voice& get_voice(const size_t id) const;              // get the voice of the id
         
-        bool is_above(const Voice& v1, const Voice& v2) const;      // check voice order ("v1" above "v2"?)
-        bool is_below(const Voice& v1, const Voice& v2) const;      // check voice order ("v1" below "v2"?)
+        bool is_above(const size_t v1, const size_t v2) const;      // check voice order ("v1" above "v2"?)
+        bool is_below(const size_t v1, const size_t v2) const;      // check voice order ("v1" below "v2"?)
+        
+        void clear();                                               // remove all voices
+        bool operator == (const VoiceOrder& order) const;           // compare voice ids and ranks
     };
     
-    // voice-cursor smart pointer and comparison function types
+    // voice-cursor smart pointer
     typedef SmartPtr<VoiceCursor> VoiceCursorPtr;
-    typedef bool (*compare_t)(const VoiceCursorPtr& cur1, const VoiceCursorPtr& cur2);
     
-    // comparison function on pointers of VoiceCursors
+    // comparison function on pointers of VoiceCursors (using the precomputed sort keys)
     // returns true, if "cur2" should be engraved before "cur1"
     static bool compare(const VoiceCursorPtr& cur1, const VoiceCursorPtr& cur2);
     
-    // queue of voice-cursors ordered according to the compare object above
-    template <class T, class Container = std::vector<T>, class Compare = std::less<typename Container::value_type> >
-    class Queue : public Container
+    // queue of voice-cursors ordered according to the compare function above
+    // (the sort key of each cursor is computed on insertion; the heap only moves the pointers)
+    class CQueue : public std::vector<VoiceCursorPtr>
     {
      private:
         // comparison object
-        Compare comp;
+        struct Compare
+        {
+            bool operator () (const VoiceCursorPtr& cur1, const VoiceCursorPtr& cur2) const {return compare(cur1, cur2);}
+        };
         
      private:
         // hide default back/front interface
-        const T& back() const;
-              T& back();
-        const T& front() const;
-              T& front();
+        const VoiceCursorPtr& back() const;
+              VoiceCursorPtr& back();
+        const VoiceCursorPtr& front() const;
+              VoiceCursorPtr& front();
         
      public:
-        // constructors
-        Queue() {}
-        Queue(Compare c) : comp(c) {}
-        
         // queue interface
-        const T& top() const    {return Container::front();}
-        void push(const T& val) {Container::push_back(val); std::push_heap(Container::begin(), Container::end(), comp);}
-        void pop()              {std::pop_heap(Container::begin(), Container::end(), comp); Container::pop_back();}
+        const VoiceCursorPtr& top() const;
+        void                  push(VoiceCursorPtr&& cursor);
+        void                  pop();
+        VoiceCursorPtr        pop_top();    // remove and return the top
     };
     
-    // cursor queue type (with comparison function as defined above)
-    typedef Queue<VoiceCursorPtr, std::vector<VoiceCursorPtr>, compare_t> CQueue;
-    
  public:
     // return the graphical width for the number
-    static mpx_t width(const SpriteSet& spr, const unsigned int n, const mpx_t height);
+    static mpx_t width(const SpriteMetrics& metrics, unsigned int n);
     
     // return the width of the staff-object's graphic
-    static mpx_t width(const Sprites& spr, const StaffObject* obj, const mpx_t height);
+    static mpx_t width(MetricsCache& metrics, const StaffObject* obj, const mpx_t height);
     
     // caluclate the width specified by the value of the note
     static mpx_t value_width(const value_t& value, const EngraverParam& param, const ViewportParam& vparam);
@@ -169,7 +200,7 @@ class SCOREPRESS_LOCAL Pick : public Logging
     const Score*         const score;       // pointer to the score object to be engraved
     const EngraverParam* const param;       // engraving-parameters (see "parameters.hh")
     const ViewportParam* const viewport;    // viewport-paramters (see "parameters.hh")
-    const Sprites*       const sprites;     // pointer to the sprite-library (access to the graphical widths)
+    MetricsCache*              metrics;     // scaled sprite metrics (access to the graphical widths)
     const int                  head_height; // default head-hight
     
     // cursor queues
@@ -199,11 +230,12 @@ class SCOREPRESS_LOCAL Pick : public Logging
 
  public:
     // constructor
-    Pick(const Score& score, const EngraverParam& param, const ViewportParam& viewport, const Sprites& sprites, int def_head_height);
+    Pick(const Score& score, const EngraverParam& param, const ViewportParam& viewport, MetricsCache& metrics, int def_head_height);
     
     // movement methods
     void next(mpx_t width = 0);                         // pop current note from stack and add next note in voice
     void reset();                                       // reset cursors to the beginning of the score
+    void set_metrics(MetricsCache& metrics);            // use other sprite metrics (i.e. after being copied from a checkpoint)
     
     const VoiceCursor& get_cursor(const Voice&) const;  // get cursor of a special voice
     
@@ -238,12 +270,20 @@ class SCOREPRESS_LOCAL Pick : public Logging
           bool            get_forced_justification()  const; // return the forced justification for the current line
           mpx_t           get_right_margin()          const; // return the distance from the right border of the score object
     const LineLayout&     get_layout()                const; // return the layout information for the current line
-    const LayoutParam&    get_layout(const Voice& v)  const; // return the layout of the given voice
+    const LayoutParam&    get_layout(size_t voice)    const; // return the layout of the given voice
     const Score&          get_score()                 const; // return the score object which is to be engraved
     
-    // voice order interface
-    bool is_above(const Voice& v1, const Voice& v2) const;   // check voice order ("v1" above "v2"?)
-    bool is_below(const Voice& v1, const Voice& v2) const;   // check voice order ("v1" below "v2"?)
+    // state comparison (used to detect where a reengraved score converges with the previous engraving)
+    bool operator == (const Pick& pick) const;               // check, if both picks will continue identically
+    bool at_newline() const;                                 // check, if any voice's next object is a newline
+    bool check_subvoices() const;                            // check, if all sub-voices still exist in their parents
+    
+    // voice order interface (see "VoiceOrder")
+    bool         find_voice(const Voice& v, size_t& id) const;  // get the id of the voice (false, if not found)
+    size_t       get_voice_id(const Voice& v)           const;  // get the id of the voice
+    const Voice& get_voice(const size_t id)             const;  // get the voice of the id
+    bool is_above(const size_t v1, const size_t v2)     const;  // check voice order ("v1" above "v2"?)
+    bool is_below(const size_t v1, const size_t v2)     const;  // check voice order ("v1" below "v2"?)
 };
 
 // inline method implementations (Voice Cursor)
@@ -256,10 +296,46 @@ inline const StaffObject& Pick::VoiceCursor::operator * () const
 inline const StaffObject* Pick::VoiceCursor::operator -> () const
             {return (!!virtual_obj ? &*virtual_obj : const_Cursor::operator ->());}
 
+// inline method implementations (Cursor queue)
+inline const Pick::VoiceCursorPtr& Pick::CQueue::top() const {return std::vector<VoiceCursorPtr>::front();}
+
+inline void Pick::CQueue::push(VoiceCursorPtr&& cursor)
+{
+    cursor->update_order();
+    push_back(std::move(cursor));
+    std::push_heap(begin(), end(), Compare());
+}
+
+inline void Pick::CQueue::pop()
+{
+    std::pop_heap(begin(), end(), Compare());
+    pop_back();
+}
+
+inline Pick::VoiceCursorPtr Pick::CQueue::pop_top()
+{
+    std::pop_heap(begin(), end(), Compare());
+    VoiceCursorPtr cursor(std::move(std::vector<VoiceCursorPtr>::back()));
+    pop_back();
+    return cursor;
+}
+
 // inline method implementations (Line layout)
-inline void Pick::LineLayout::swap(LineLayout& a) {std::swap(data, a.data); std::swap(first_voice, a.first_voice);}
+inline bool Pick::LineLayout::exist(const size_t voice) const {return voice < data.size() && data[voice];}
+inline void Pick::LineLayout::swap(LineLayout& a) {data.swap(a.data); std::swap(first_voice, a.first_voice);}
 inline void Pick::LineLayout::clear()             {data.clear();}
 
+inline const LayoutParam& Pick::LineLayout::get(const size_t voice) const
+{
+    if (voice >= data.size() || !data[voice]) throw VoiceNotFoundException();
+    return *data[voice];
+}
+
+// inline method implementations (Voice order)
+inline const Voice& Pick::VoiceOrder::get_voice(const size_t id) const {return *voices[id];}
+inline bool Pick::VoiceOrder::is_above(const size_t v1, const size_t v2) const {return ranks[v1] < ranks[v2];}
+inline bool Pick::VoiceOrder::is_below(const size_t v1, const size_t v2) const {return ranks[v1] > ranks[v2];}
+
 // inline method implementations (Pick)
 inline void Pick::add_subvoices(const VoiceCursor& cursor) {add_subvoices(cursor, cursors);}
 
@@ -272,11 +348,14 @@ inline       bool               Pick::get_justify()               const {return
 inline       bool               Pick::get_forced_justification()  const {return _layout.get().forced_justification;}
 inline       mpx_t              Pick::get_right_margin()          const {return viewport->umtopx_h(_layout.get().right_margin);}
 inline const Pick::LineLayout&  Pick::get_layout()                const {return _layout;}
-inline const LayoutParam&       Pick::get_layout(const Voice& v)  const {return _layout.get(v);}
+inline const LayoutParam&       Pick::get_layout(size_t voice)    const {return _layout.get(voice);}
 inline const Score&             Pick::get_score()                 const {return *score;}
 
-inline bool Pick::is_above(const Voice& v1, const Voice& v2) const {return _voice_order.is_above(v1, v2);}
-inline bool Pick::is_below(const Voice& v1, const Voice& v2) const {return _voice_order.is_below(v1, v2);}
+inline bool         Pick::find_voice(const Voice& v, size_t& id) const {return _voice_order.find(v, id);}
+inline size_t       Pick::get_voice_id(const Voice& v)           const {return _voice_order.get_id(v);}
+inline const Voice& Pick::get_voice(const size_t id)             const {return _voice_order.get_voice(id);}
+inline bool         Pick::is_above(const size_t v1, const size_t v2) const {return _voice_order.is_above(v1, v2);}
+inline bool         Pick::is_below(const size_t v1, const size_t v2) const {return _voice_order.is_below(v1, v2);}
 
 } // end namespace
 
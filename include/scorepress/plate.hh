@@ -24,7 +24,9 @@
 #include <map>          // std::map
 #include <list>         // std::list
 
-#include "cursor.hh"    // const_Cursor, Position, Voice, SmartPtr, RefPtr
+#include "cursor.hh"    // const_Cursor, Position, Voice, SmartPtr, RefPtr, RefCounted, AtomicRefCounted
+#include "arena.hh"     // Arena, ArenaAllocator
+#include "small_vector.hh"  // SmallVector
 #include "stem_info.hh" // StemInfo
 #include "context.hh"   // VoiceContext, StaffContext
 #include "sprite_id.hh" // SpriteId
@@ -44,7 +46,8 @@ class SCOREPRESS_API Plate_pVoice;      // voice object (list of notes)
 class SCOREPRESS_API Plate_pLine;       // on-plate line object (list of voices)
 
 // typedefs
-typedef Position<mpx_t> Plate_Pos;
+typedef Position<mpx_t>      Plate_Pos;
+typedef ArenaAllocator<char> Plate_Allocator;   // allocator of the on-plate lists (converted to the element type)
 
 
 //
@@ -74,6 +77,7 @@ class SCOREPRESS_API Plate_GphBox
     
     bool contains(const Plate_Pos& p) const;    // check, if a given point is inside the box
     bool overlaps(const Plate_GphBox& box);     // check, if a given box overlaps this box
+    bool intersects(const Plate_GphBox& box) const; // check, if a given box intersects this box (including crossing boxes)
     void extend(const Plate_Pos& p);            // extend box, such that the given point is covered
     void extend(const Plate_GphBox& box);       // extend box, such that the given box is covered
 };
@@ -84,6 +88,9 @@ inline mpx_t Plate_GphBox::bottom() const {return pos.y + height;}
 inline bool Plate_GphBox::contains(const Plate_Pos& p) const {
     return (p.x >= pos.x && p.y >= pos.y && p.x < pos.x + width && p.y < pos.y + height);}
 
+inline bool Plate_GphBox::intersects(const Plate_GphBox& box) const {
+    return (box.pos.x < pos.x + width && pos.x < box.pos.x + box.width && box.pos.y < pos.y + height && pos.y < box.pos.y + box.height);}
+
 
 // graphical object (base class for all on-plate objects)
 class SCOREPRESS_API Plate_pGraphical
@@ -100,7 +107,7 @@ inline bool Plate_pGraphical::contains(Plate_Pos p) const {return gphBox.contain
 
 
 // attachable object (object pointer, sprite and position)
-class SCOREPRESS_API Plate_pAttachable : public Plate_pGraphical
+class SCOREPRESS_API Plate_pAttachable : public Plate_pGraphical, public RefCounted
 {
  public:
     const AttachedObject* const object; // original object
@@ -151,29 +158,30 @@ class SCOREPRESS_API Plate_pNote : public Plate_pGraphical
         Plate_Pos control2;     // second control point
     };
     
-    // virtual object structure
+    // virtual object structure (stored within the note; "object" is NULL for non-virtual notes)
     struct Virtual
     {
      public:
         SmartPtr<const StaffObject, CloneTrait> object;     // virtual object (i.e. non existant in score structure)
         bool inserted;                                      // inserted or replacing the original object?
         
-        Virtual(const StaffObject& object, bool inserted);  // ("object" will be cloned)
+        Virtual();                                          // (non-virtual)
+        void set(const StaffObject& object, bool inserted); // ("object" will be cloned)
     };
     
     // stem information structure
     struct Stem
     {
-        mpx_t x;            // horizontal position
-        mpx_t top;          // top vertical position
-        mpx_t base;         // bottom vertial position (i.e. where it touches the head)
+        mpx_t x;                // horizontal position
+        mpx_t top;              // top vertical position
+        mpx_t base;             // bottom vertial position (i.e. where it touches the head)
         
-        size_t beam_off;    // stem length correction (internal, temporary)
+        unsigned int beam_off;  // stem length correction (internal, temporary)
         
         inline bool is_up() const {return top < base;};
     };
     
-    // beam information structure
+    // beam information structure (stored within the note; "end" is NULL, if there is no beam)
     struct Beam
     {
         const Plate_pNote* end;             // reference to the end-note
@@ -185,36 +193,39 @@ class SCOREPRESS_API Plate_pNote : public Plate_pGraphical
     };
     
     // list and pointer typedefs
-    typedef std::list< Plate_Pos >       PositionList;
-    typedef RefPtr<Plate_pAttachable>    AttachablePtr;
-    typedef std::list<AttachablePtr>     AttachableList;
-    typedef std::list<Tie>               TieList;
-    typedef std::list<LedgerLines>       LedgerLineList;
-    typedef RefPtr<Virtual>              VirtualPtr;
-    typedef RefPtr<Beam>                 BeamPtr;
-    typedef SmartPtr<StemInfo>           StemInfoPtr;
-    typedef std::list<Plate_pNote>       NoteList;
-    typedef NoteList::iterator           Iterator;
+    // (the short lists keep their usual number of elements inline; note that
+    //  appending an element may move the others, like in "std::vector";
+    //  the other lists are allocated with the plate's allocator)
+    typedef SmallVector<Plate_Pos, 2>                            PositionList;
+    typedef SmallVector<Plate_Pos, 1>                            DotList;
+    typedef RefPtr<Plate_pAttachable>                            AttachablePtr;
+    typedef std::list<AttachablePtr, ArenaAllocator<AttachablePtr> > AttachableList;
+    typedef SmallVector<Tie, 1>                                  TieList;
+    typedef SmallVector<LedgerLines, 1>                          LedgerLineList;
+    typedef SmartPtr<StemInfo>                                   StemInfoPtr;
+    typedef std::list<Plate_pNote, ArenaAllocator<Plate_pNote> > NoteList;
+    typedef NoteList::iterator                                   Iterator;
     
  public:
     const_Cursor   note;                    // note object
     
     SpriteId       sprite;                  // head sprite id
     PositionList   absolutePos;             // positions for each head
-    PositionList   dotPos;                  // positions for each dot
+    DotList        dotPos;                  // positions for each dot
     LedgerLineList ledgers;                 // ledger lines
     TieList        ties;                    // attached ties
     AttachableList attached;                // list of attached objects
-    VirtualPtr     virtual_obj;             // virtual object
+    Virtual        virtual_obj;             // virtual object
     
     Stem           stem;                    // stem information
+    bool           noflag;                  // is a flag to be rendered?
     StemInfoPtr    stem_info;               // temporary additional stem information (only there during engraving)
-    BeamPtr        beam[VALUE_BASE - 2];    // beam information (VALUE_BASE - 3 being eighth)
+    Beam           beam[VALUE_BASE - 2];    // beam information (VALUE_BASE - 3 being eighth)
     Iterator       beam_begin;              // beam begin note
-    bool           noflag;                  // is a flag to be rendered?
     
  public:
-    Plate_pNote(const Plate_Pos& pos, const const_Cursor& note);    // constructor
+    Plate_pNote(const Plate_Pos& pos, const const_Cursor& note,     // constructor
+                const Plate_Allocator& alloc = Plate_Allocator());  //   (allocating the lists with the given allocator)
     
     void add_offset(mpx_t offset);          // add offset to all positions (except to the tie-end)
     void add_tieend_offset(mpx_t offset);   // add offset to tie-end positions
@@ -228,17 +239,17 @@ class SCOREPRESS_API Plate_pNote : public Plate_pGraphical
     void dump() const;
 };
 
-inline const StaffObject& Plate_pNote::get_note()    const {return (virtual_obj ? *virtual_obj->object : *note);}
-inline       bool         Plate_pNote::is_virtual()  const {return (virtual_obj != NULL);}
-inline       bool         Plate_pNote::is_inserted() const {return (virtual_obj && virtual_obj->inserted);}
-inline       bool         Plate_pNote::at_end()      const {return (!virtual_obj && note.at_end());}
+inline const StaffObject& Plate_pNote::get_note()    const {return (!virtual_obj.object ? *note : *virtual_obj.object);}
+inline       bool         Plate_pNote::is_virtual()  const {return !!virtual_obj.object;}
+inline       bool         Plate_pNote::is_inserted() const {return (!!virtual_obj.object && virtual_obj.inserted);}
+inline       bool         Plate_pNote::at_end()      const {return (!virtual_obj.object && note.at_end());}
 
 
 // voice object (list of notes)
 class SCOREPRESS_API Plate_pVoice
 {
  public:
-    typedef std::list<Plate_pNote>   NoteList;
+    typedef Plate_pNote::NoteList    NoteList;
     typedef NoteList::iterator       Iterator;
     typedef NoteList::const_iterator const_Iterator;
     
@@ -266,7 +277,8 @@ class SCOREPRESS_API Plate_pVoice
     Brace         brace;        // brace starting here
     Bracket       bracket;      // bracket starting here
     
-    Plate_pVoice(const const_Cursor& cursor);       // constructor
+    Plate_pVoice(const const_Cursor& cursor,                            // constructor
+                 const Plate_Allocator& alloc = Plate_Allocator());     //   (allocating the notes with the given allocator)
     
     Iterator append(const Plate_Pos& pos, const const_Cursor& note);    // append new note
 };
@@ -276,10 +288,17 @@ class SCOREPRESS_API Plate_pVoice
 class SCOREPRESS_API Plate_pLine : public Plate_pGraphical
 {
  public:
-    typedef std::list<Plate_pVoice>              VoiceList;
-    typedef VoiceList::iterator                  Iterator;
-    typedef VoiceList::const_iterator            const_Iterator;
-    typedef std::map<const Staff*, StaffContext> StaffContextMap;
+    typedef std::list<Plate_pVoice, ArenaAllocator<Plate_pVoice> > VoiceList;
+    typedef VoiceList::iterator                                    Iterator;
+    typedef VoiceList::const_iterator                              const_Iterator;
+    typedef std::map<const Staff*, StaffContext>                   StaffContextMap;
+    
+    // engraver checkpoint at the beginning of the line (opaque; see "EngraverState::Checkpoint")
+    class SCOREPRESS_API Checkpoint : public RefCounted
+    {
+     public:
+        virtual ~Checkpoint();
+    };
     
  public:
     Plate_GphBox    noteBox;        // graphical boundary box (only note objects)
@@ -290,6 +309,10 @@ class SCOREPRESS_API Plate_pLine : public Plate_pGraphical
     VoiceList       voices;         // voices within this line
     ScoreContext    context;        // score context (at the end of the line)
     StaffContextMap staffctx;       // staff contexts
+    RefPtr<Checkpoint> checkpoint;  // engraver checkpoint (allows resuming the engraving at this line)
+    bool            edited;         // were objects on this line edited since the engraving? (see "EditCursor")
+    
+    Plate_pLine(const Plate_Allocator& alloc = Plate_Allocator());  // constructor (allocating the voices with the given allocator)
     
     Iterator       get_voice(const Voice& voice);       // find a voice in this line
     const_Iterator get_voice(const Voice& voice) const; // (constant version)
@@ -304,8 +327,15 @@ inline void Plate_pLine::erase() {voices.clear();}
 
 
 // plate class
-class SCOREPRESS_API Plate
+// (the lists on the plate are allocated within the plate's arena; lines may only
+//  be moved between the lists of the same plate, see "get_allocator")
+// (plates are created on the engraver's threads and shared with the caller,
+//  thus they carry an atomic reference counter)
+class SCOREPRESS_API Plate : public AtomicRefCounted
 {
+ private:
+    Arena arena;    // memory of the on-plate lists (released with the plate)
+    
  public:
     //  CLASSES
     // ---------
@@ -319,21 +349,29 @@ class SCOREPRESS_API Plate
     typedef Plate_pLine       pLine;        // on-plate line object (list of voices)
     
     // list typedefs
-    typedef std::list<pNote>    NoteList;
-    typedef std::list<pVoice>   VoiceList;
-    typedef std::list<pLine>    LineList;
-    typedef LineList::iterator  Iterator;
-    typedef LineList::iterator  LineIt;
-    typedef VoiceList::iterator VoiceIt;
-    typedef NoteList::iterator  NoteIt;
+    typedef pVoice::NoteList                         NoteList;
+    typedef pLine::VoiceList                         VoiceList;
+    typedef std::list<pLine, ArenaAllocator<pLine> > LineList;
+    typedef LineList::iterator                       Iterator;
+    typedef LineList::iterator                       LineIt;
+    typedef VoiceList::iterator                      VoiceIt;
+    typedef NoteList::iterator                       NoteIt;
     
     // lines on the plate
     LineList lines;
     
+    // constructor
+    Plate();
+    
+    // allocator for the on-plate objects (using the plate's arena)
+    Plate_Allocator get_allocator();
+    
     // dump the plate content to stdout
     void dump() const;
 };
 
+inline Plate_Allocator Plate::get_allocator() {return Plate_Allocator(arena);}
+
 } // end namespace
 
 #endif
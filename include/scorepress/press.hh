@@ -69,8 +69,11 @@ class SCOREPRESS_LOCAL Press : public Logging
     // rendering method (for on-plate note objects)
     void render(Renderer&, const Plate::pNote&);
     
+    // check, if a box (in plate coordinates, placed at the offset) intersects the visible rectangle (if given)
+    bool is_visible(const Plate::GphBox& box, const Position<mpx_t> offset, const Plate::GphBox* visible) const;
+    
     // render the (empty) staff for a plate
-    void render_staff(Renderer&, const Plate&, const Position<mpx_t> offset);
+    void render_staff(Renderer&, const Plate&, const Position<mpx_t> offset, const Plate::GphBox* visible);
     
     // draw a little red cross
     void draw_cross(Renderer&, const Position<mpx_t>& pos, const Position<mpx_t> offset);
@@ -92,8 +95,9 @@ class SCOREPRESS_LOCAL Press : public Logging
     void draw_boundaries(Renderer&, const Plate::pGraphical&, const Color& color, const Position<mpx_t> offset);
     
     // render a plate/page/attachable through the given renderer
-    void render(Renderer&, const Plate&,                              const Position<mpx_t> offset);
-    void render(Renderer&, const Pageset::pPage&,     const Pageset&, const Position<mpx_t> offset);
+    // (if a visible rectangle is given, in the coordinates of the offset, the lines and attachables outside are skipped)
+    void render(Renderer&, const Plate&,                              const Position<mpx_t> offset, const Plate::GphBox* visible = NULL);
+    void render(Renderer&, const Pageset::pPage&,     const Pageset&, const Position<mpx_t> offset, const Plate::GphBox* visible = NULL);
     void render(Renderer&, const Plate::pAttachable&, const Staff&,   const Position<mpx_t> offset);
     
     // render page decoration
@@ -0,0 +1,169 @@
+
+/*
+  ScorePress - Music Engraving Software  (libscorepress)
+  Copyright (C) 2016 Dominik Lehmann
+  
+  Licensed under the EUPL, Version 1.1 or - as soon they
+  will be approved by the European Commission - subsequent
+  versions of the EUPL (the "Licence");
+  You may not use this work except in compliance with the
+  Licence. You may obtain a copy of the Licence at
+  <http://ec.europa.eu/idabc/eupl/>.
+  
+  Unless required by applicable law or agreed to in
+  writing, software distributed under the Licence is
+  distributed on an "AS IS" basis, WITHOUT WARRANTIES OR
+  CONDITIONS OF ANY KIND, either expressed or implied.
+  See the Licence for the specific language governing
+  permissions and limitations under the Licence.
+*/
+
+#ifndef SCOREPRESS_RECORDING_RENDERER_HH
+#define SCOREPRESS_RECORDING_RENDERER_HH
+
+#include <vector>       // std::vector
+#include <string>       // std::string
+
+#include "renderer.hh"  // Renderer, SpriteId
+#include "error.hh"     // ScorePress::Error
+#include "export.hh"
+
+namespace ScorePress
+{
+//  CLASSES
+// ---------
+class SCOREPRESS_API DisplayList;        // recorded command stream of a renderer
+class SCOREPRESS_API RecordingRenderer;  // renderer, recording the rendering commands to a display list
+
+
+//
+//     class DisplayList
+//    ===================
+//
+// This class stores the commands issued to a renderer in flat arrays, such
+// that they can be replayed to another renderer without traversing the plates
+// again. During the replay, the coordinates can be moved and scaled.
+//
+class SCOREPRESS_API DisplayList
+{
+ public:
+    // recorded commands
+    enum Command {DRAW_SPRITE, DRAW_SPRITE_SCALED,
+                  SET_LINE_WIDTH, SET_COLOR, MOVE_TO, LINE_TO, FILL, STROKE, CLOSE,
+                  CLIP, UNCLIP,
+                  SET_FONT_FAMILY, SET_FONT_SIZE, SET_FONT_BOLD, SET_FONT_ITALIC, SET_FONT_UNDERLINE, SET_FONT_COLOR,
+                  SET_TEXT_WIDTH, RESET_TEXT_WIDTH, SET_TEXT_ALIGN, SET_TEXT_JUSTIFY, ADD_TEXT, RENDER_TEXT,
+                  RECT_INVERT, BEZIER, BEZIER_SLUR};
+    
+ private:
+    friend class RecordingRenderer;
+    
+    std::vector<unsigned char> commands;    // command stream (see "Command")
+    std::vector<double>        reals;       // coordinates and sizes (in order of the commands)
+    std::vector<int>           integers;    // sprite-ids, colors, flags and clipping rectangles
+    std::vector<std::string>   strings;     // font families and text
+    
+ public:
+    // replay the commands (transforming each coordinate "c" to "c * scale + offset")
+    void replay(Renderer& renderer, const double x = 0.0, const double y = 0.0, const double scale = 1.0) const;
+    
+    void   clear();         // remove all commands
+    bool   empty() const;   // check, if there are no commands
+    size_t size()  const;   // number of commands
+};
+
+// inline method implementations
+inline bool   DisplayList::empty() const {return commands.empty();}
+inline size_t DisplayList::size()  const {return commands.size();}
+
+
+//
+//     class RecordingRenderer
+//    =========================
+//
+// This renderer does not draw anything, but appends the received commands to
+// a display list. It provides the sprites of a source renderer (copied by
+// "set_source"), such that the press can compute the sprite dimensions.
+// Bézier curves are recorded as such, and replayed through the target's
+// implementation.
+//
+class SCOREPRESS_API RecordingRenderer : public Renderer
+{
+ public:
+    // exception class
+    class SCOREPRESS_API Error : public ScorePress::Error {public: Error(const std::string& msg);};
+    
+ private:
+    const Renderer* source;     // renderer providing the sprites
+    DisplayList*    target;     // display list being recorded
+    
+ public:
+    // constructors
+    RecordingRenderer();                            // (without source; call "set_source" before recording)
+    RecordingRenderer(const Renderer& source);      // (copying the sprites of the given renderer)
+    
+    // setup
+    void set_source(const Renderer& source);        // copy the sprites of the given renderer
+    void set_target(DisplayList& list);             // append the following commands to the given list
+    void unset_target();                            // stop recording
+    
+    bool            has_source() const;             // is there a source renderer?
+    const Renderer& get_source() const;             // renderer providing the sprites
+    
+    // renderer methods
+    virtual bool   ready() const;
+    virtual bool   exist(const std::string& sprite) const;
+    virtual bool   exist(const std::string& sprite, const size_t setid) const;
+    
+    virtual size_t    spriteset_format_count() const;
+    virtual ReaderPtr spriteset_reader(const size_t idx = 0);   // (throws, the sprites are taken from the source)
+    virtual size_t    add_spriteset(ReaderPtr reader);          // (throws, the sprites are taken from the source)
+    
+    virtual void draw_sprite(const SpriteId sprite_id, double x, double y);
+    virtual void draw_sprite(const SpriteId sprite_id, double x, double y, double xscale, double yscale);
+    
+    virtual void set_line_width(const double width);
+    virtual void set_color(const unsigned char r, const unsigned char g, const unsigned char b, const unsigned char a);
+    virtual void move_to(const double x, const double y);
+    virtual void line_to(const double x, const double y);
+    virtual void fill();
+    virtual void stroke();
+    virtual void close();
+    
+    virtual void clip(const int x1, const int y1, const int w, const int h);
+    virtual void unclip();
+    
+    virtual void set_font_family(const std::string& family);
+    virtual void set_font_size(const double pt);
+    virtual void set_font_bold(const bool bold);
+    virtual void set_font_italic(const bool italic);
+    virtual void set_font_underline(const bool underline);
+    virtual void set_font_color(const unsigned char r, const unsigned char g, const unsigned char b);
+    
+    virtual void set_text_width(const double width);
+    virtual void reset_text_width();
+    virtual void set_text_align(const enuAlignment align);
+    virtual void set_text_justify(const bool justify);
+    virtual void add_text(const std::string& utf8);
+    virtual void render_text();
+    
+    virtual void rect_invert(double x1, double y1, double x2, double y2);
+    virtual bool has_rect_invert() const;
+    
+    virtual void bezier(double  x1, double  y1, double cx1, double cy1,
+                        double cx2, double cy2, double  x2, double  y2);
+    virtual void bezier_slur(double  x1, double  y1, double cx1, double cy1,
+                             double cx2, double cy2, double  x2, double  y2,
+                             double  w0, double  w1);
+};
+
+// inline method implementations
+inline void            RecordingRenderer::set_target(DisplayList& list) {target = &list;}
+inline void            RecordingRenderer::unset_target()                {target = NULL;}
+inline bool            RecordingRenderer::has_source() const            {return source != NULL;}
+inline const Renderer& RecordingRenderer::get_source() const            {return *source;}
+
+} // end namespace
+
+#endif
+
@@ -34,6 +34,7 @@ namespace ScorePress
 class SCOREPRESS_API   Reengraveable;   // interface for classes supporting being reengraved
 class SCOREPRESS_LOCAL ReengraveInfo;   // information about on-plate references
 class SCOREPRESS_LOCAL EngraverState;   // engraver state class prototype (see "engraver_state.hh")
+class SCOREPRESS_API   Plate_pLine;     // on-plate line class prototype (see "plate.hh")
 
 
 //
@@ -89,6 +90,9 @@ class SCOREPRESS_LOCAL ReengraveInfo
     // execute finish on all updated objects
     void finish();
     
+    // remove all objects triggered by the objects of a line, which is not reengraved
+    void release(const Plate_pLine& line);
+    
     // information access
     size_t size() const;        // number of registered objects
     bool is_empty() const;      // check, if no objects are registered (should be "true" after a successful reengrave)
@@ -21,42 +21,125 @@
 #ifndef SCOREPRESS_REFPTR_HH
 #define SCOREPRESS_REFPTR_HH
 
+#include <atomic>       // std::atomic
+#include <utility>      // std::forward
+#include <type_traits>  // std::is_base_of, std::integral_constant, std::true_type, std::false_type
+
 namespace ScorePress
 {
 //  CLASSES
 // ---------
 template <typename T>
 class RefPtr;           // a simple reference counting smart pointer
+class RefCounted;       // base class for objects with an embedded reference counter
+class AtomicRefCounted; // base class for objects with an embedded thread-safe reference counter
+template <typename T>
+struct IsRefCounted;    // trait, checking if the objects carry their own reference counter
+
+
+//
+//     class RefCounted
+//    ==================
+//
+// Objects of classes derived from this one carry their own reference counter,
+// which is used by "RefPtr" instead of allocating a separate one. Thus, the
+// object is managed with a single allocation, and several "RefPtr"s may be
+// created from the same raw pointer. Copying an object does not copy its
+// counter. The counter is not thread-safe (see "AtomicRefCounted").
+//
+class RefCounted
+{
+ private:
+    mutable unsigned int refcount;  // reference counter
+    
+ protected:
+    RefCounted() : refcount(0) {}
+    RefCounted(const RefCounted&) : refcount(0) {}
+    RefCounted& operator = (const RefCounted&) {return *this;}
+    ~RefCounted() {}
+    
+ public:
+    // counter access (used by "RefPtr")
+    friend void         ref_acquire(const RefCounted* obj) {++obj->refcount;}
+    friend bool         ref_release(const RefCounted* obj) {return !--obj->refcount;}
+    friend unsigned int ref_count(const RefCounted* obj)   {return obj->refcount;}
+};
+
+
+//
+//     class AtomicRefCounted
+//    ========================
+//
+// Like "RefCounted", but with an atomic counter, so that references to the
+// object may be copied and released by several threads at once.
+//
+class AtomicRefCounted
+{
+ private:
+    mutable std::atomic<unsigned int> refcount;     // reference counter
+    
+ protected:
+    AtomicRefCounted() : refcount(0) {}
+    AtomicRefCounted(const AtomicRefCounted&) : refcount(0) {}
+    AtomicRefCounted& operator = (const AtomicRefCounted&) {return *this;}
+    ~AtomicRefCounted() {}
+    
+ public:
+    // counter access (used by "RefPtr")
+    friend void         ref_acquire(const AtomicRefCounted* obj) {obj->refcount.fetch_add(1, std::memory_order_relaxed);}
+    friend bool         ref_release(const AtomicRefCounted* obj) {return obj->refcount.fetch_sub(1, std::memory_order_acq_rel) == 1;}
+    friend unsigned int ref_count(const AtomicRefCounted* obj)   {return obj->refcount.load(std::memory_order_acquire);}
+};
+
+// trait, checking if the objects carry their own reference counter
+template <typename T> struct IsRefCounted : public std::integral_constant<bool,    std::is_base_of<RefCounted, T>::value
+                                                                                || std::is_base_of<AtomicRefCounted, T>::value> {};
 
 
 //
 //     class RefPtr
 //    ==============
 //
-// Implementation of a simple reference counting smart pointer.
+// Implementation of a simple reference counting smart pointer. Moving transfers
+// the reference without touching the counter. For objects derived from
+// "RefCounted" or "AtomicRefCounted" the embedded counter is used; otherwise
+// the counter is allocated alongside the object. Pointers can only be cast
+// between classes using the same kind of counter.
 //
 template <typename T> class RefPtr
 {
  private:
     T* data;                // data pointer
-    unsigned int* count;    // reference counter
+    unsigned int* count;    // reference counter (NULL for objects with an embedded counter)
     
     void dealloc();         // deallocate a reference (decrease count)
     
+    // counter operations (depending on the kind of counter)
+    void init(std::true_type)                       {if (data) ref_acquire(data);}
+    void init(std::false_type)                      {if (data) count = new unsigned int(1);}
+    void acquire(std::true_type)                    {if (data) ref_acquire(data);}
+    void acquire(std::false_type)                   {if (count) ++*count;}
+    void release(std::true_type)                    {if (data && ref_release(data)) delete data;}
+    void release(std::false_type)                   {if (count && !--*count) {delete data; delete count;};}
+    unsigned int refcount(std::true_type) const     {return data ? ref_count(data) : 0;}
+    unsigned int refcount(std::false_type) const    {return count ? *count : 0;}
+    
     template <typename> friend class RefPtr;    // make all RefPtr friends (for casting)
     
  public:
-    RefPtr();                       // default constructor (NULL-pointer)
-    RefPtr(const RefPtr<T>& ptr);   // copy constructor (increase count)
-    explicit RefPtr(T* const ptr);  // raw-pointer wrapper
-    ~RefPtr();                      // destructor
+    RefPtr();                           // default constructor (NULL-pointer)
+    RefPtr(const RefPtr<T>& ptr);       // copy constructor (increase count)
+    RefPtr(RefPtr<T>&& ptr) noexcept;   // move constructor (take over the reference)
+    explicit RefPtr(T* const ptr);      // raw-pointer wrapper
+    ~RefPtr();                          // destructor
     
     // dereferece operators
     T& operator * () const {return *data;}
     T* operator-> () const {return data;}
     
-    // assignment operator
-    RefPtr<T>& operator = (const RefPtr<T>& ptr);
+    // assignment operators
+    RefPtr<T>& operator = (const RefPtr<T>& ptr);       // copy assignment (increase count)
+    RefPtr<T>& operator = (RefPtr<T>&& ptr) noexcept;   // move assignment (take over the reference)
     
     // logical operators
     bool operator ! () const;   // NULL check
@@ -71,6 +154,7 @@ template <typename T> class RefPtr
     
     // data cast
     template <typename U> RefPtr(const RefPtr<U>& ptr);
+    template <typename U> RefPtr(RefPtr<U>&& ptr) noexcept;
     
     // pointer cast (for cast to boolean, preventing cast to integral type)
     operator void* () const;
@@ -82,28 +166,40 @@ template <typename T> class RefPtr
     template <typename U> friend void         free(RefPtr<U>& ptr);              // deallocate reference
 };
 
+// create a new object and return a reference to it
+// (for objects with an embedded counter, this is a single allocation)
+template <typename T, typename... Args>
+RefPtr<T> make_ref(Args&&... args);
+
 // method implementations
 template <typename T>
-void RefPtr<T>::dealloc() {if (count && !--*count) {delete data; delete count;}; count = 0; data = 0;}
+void RefPtr<T>::dealloc() {release(IsRefCounted<T>()); count = 0; data = 0;}
 
 template <typename T>
 inline RefPtr<T>::RefPtr() : data(0), count(0) {}
 
 template <typename T>
-inline RefPtr<T>::RefPtr(const RefPtr<T>& ptr) : data(ptr.data), count(ptr.count) {if (count) ++*count;}
+inline RefPtr<T>::RefPtr(const RefPtr<T>& ptr) : data(ptr.data), count(ptr.count) {acquire(IsRefCounted<T>());}
 
 template <typename T>
-inline RefPtr<T>::RefPtr(T* const ptr) : data(ptr), count(ptr ? new unsigned int(1) : 0) {}
+inline RefPtr<T>::RefPtr(RefPtr<T>&& ptr) noexcept : data(ptr.data), count(ptr.count) {ptr.data = 0; ptr.count = 0;}
+
+template <typename T>
+inline RefPtr<T>::RefPtr(T* const ptr) : data(ptr), count(0) {init(IsRefCounted<T>());}
 
 template <typename T>
 inline RefPtr<T>::~RefPtr() {dealloc();}
 
 template <typename T>
 inline RefPtr<T>& RefPtr<T>::operator = (const RefPtr<T>& ptr)
-{if (data != ptr.data) {dealloc(); data = ptr.data; if ((count = ptr.count)) ++*count;}; return *this;}
+{if (data != ptr.data) {dealloc(); data = ptr.data; count = ptr.count; acquire(IsRefCounted<T>());}; return *this;}
 
 template <typename T>
-inline bool RefPtr<T>::operator ! () const {return (data == 0 || count == 0);}
+inline RefPtr<T>& RefPtr<T>::operator = (RefPtr<T>&& ptr) noexcept
+{if (this != &ptr) {dealloc(); data = ptr.data; count = ptr.count; ptr.data = 0; ptr.count = 0;}; return *this;}
+
+template <typename T>
+inline bool RefPtr<T>::operator ! () const {return (data == 0 || (!IsRefCounted<T>::value && count == 0));}
 
 template <typename T>
 inline bool operator == (const T* ptr1, const RefPtr<T>& ptr2) {return ptr1 == ptr2.data;}
@@ -124,7 +220,19 @@ template <typename T> template <typename U>
 inline bool RefPtr<T>::operator != (const RefPtr<U>& ptr) const {return data != ptr.data;}
 
 template <typename T> template <typename U>
-RefPtr<T>::RefPtr(const RefPtr<U>& ptr) : data(static_cast<T*>(ptr.data)), count(ptr.count) {if (count) ++*count;}
+RefPtr<T>::RefPtr(const RefPtr<U>& ptr) : data(static_cast<T*>(ptr.data)), count(ptr.count)
+{
+    static_assert(IsRefCounted<T>::value == IsRefCounted<U>::value, "RefPtr cannot be cast between different kinds of counters.");
+    acquire(IsRefCounted<T>());
+}
+
+template <typename T> template <typename U>
+RefPtr<T>::RefPtr(RefPtr<U>&& ptr) noexcept : data(static_cast<T*>(ptr.data)), count(ptr.count)
+{
+    static_assert(IsRefCounted<T>::value == IsRefCounted<U>::value, "RefPtr cannot be cast between different kinds of counters.");
+    ptr.data = 0;
+    ptr.count = 0;
+}
 
 template <typename T>
 inline RefPtr<T>::operator void* () const {return data;}
@@ -133,7 +241,7 @@ template <typename T>
 inline T* getRawPtr(const RefPtr<T>& ptr) {return ptr.data;}
 
 template <typename T>
-inline unsigned int getRefCount(const RefPtr<T>& ptr) {if (ptr.count) return *ptr.count; else return 0;}
+inline unsigned int getRefCount(const RefPtr<T>& ptr) {return ptr.refcount(IsRefCounted<T>());}
 
 template <typename T>
 inline void alloc(const RefPtr<T>& ptr) {ptr.dealloc(); ptr.count = new unsigned int(1); ptr.data = new T();}
@@ -141,6 +249,9 @@ inline void alloc(const RefPtr<T>& ptr) {ptr.dealloc(); ptr.count = new unsigned
 template <typename T>
 inline void free(RefPtr<T>& ptr) {ptr.dealloc();}
 
+template <typename T, typename... Args>
+inline RefPtr<T> make_ref(Args&&... args) {return RefPtr<T>(new T(std::forward<Args>(args)...));}
+
 } // end namespace
 
 #endif
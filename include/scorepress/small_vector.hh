@@ -0,0 +1,231 @@
+
+/*
+  ScorePress - Music Engraving Software  (libscorepress)
+  Copyright (C) 2016 Dominik Lehmann
+  
+  Licensed under the EUPL, Version 1.1 or - as soon they
+  will be approved by the European Commission - subsequent
+  versions of the EUPL (the "Licence");
+  You may not use this work except in compliance with the
+  Licence. You may obtain a copy of the Licence at
+  <http://ec.europa.eu/idabc/eupl/>.
+  
+  Unless required by applicable law or agreed to in
+  writing, software distributed under the Licence is
+  distributed on an "AS IS" basis, WITHOUT WARRANTIES OR
+  CONDITIONS OF ANY KIND, either expressed or implied.
+  See the Licence for the specific language governing
+  permissions and limitations under the Licence.
+*/
+
+#ifndef SCOREPRESS_SMALL_VECTOR_HH
+#define SCOREPRESS_SMALL_VECTOR_HH
+
+#include <cstddef>      // size_t
+#include <new>          // placement new
+#include <iterator>     // std::reverse_iterator
+#include <type_traits>  // std::aligned_storage
+
+namespace ScorePress
+{
+//  CLASSES
+// ---------
+template <typename T, size_t N>
+class SmallVector;      // vector, storing up to N elements without allocation
+
+
+//
+//     class SmallVector
+//    ===================
+//
+// Implementation of a vector, which keeps up to N elements in an inline buffer
+// and only allocates memory, if it grows beyond that (the buffer then holds the
+// pointer to the allocated array). It is used for the short lists of the
+// on-plate objects, which mostly contain less than three elements.
+// Like "std::vector", adding elements may invalidate iterators and references
+// (use "reserve" to prevent this).
+//
+template <typename T, size_t N> class SmallVector
+{
+ public:
+    // typedefs
+    typedef T                                     value_type;
+    typedef size_t                                size_type;
+    typedef T&                                    reference;
+    typedef const T&                              const_reference;
+    typedef T*                                    iterator;
+    typedef const T*                              const_iterator;
+    typedef std::reverse_iterator<iterator>       reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+    
+ private:
+    typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type Storage;
+    
+    unsigned int count;         // number of elements
+    unsigned int capacity;      // size of the element array (N, if the inline buffer is used)
+    union
+    {
+        T*      heap;           // allocated element array (if "capacity > N")
+        Storage buffer[N];      // inline buffer
+    } storage;
+    
+    T*       data();                        // pointer to the element array
+    const T* data() const;
+    void grow(const size_t min_capacity);   // move the elements to a larger array
+    
+ public:
+    SmallVector();                                          // default constructor (empty vector)
+    SmallVector(const SmallVector& vector);                 // copy constructor
+    ~SmallVector();                                         // destructor
+    SmallVector& operator = (const SmallVector& vector);    // assignment operator
+    
+    // iterators
+    iterator               begin();
+    const_iterator         begin()  const;
+    iterator               end();
+    const_iterator         end()    const;
+    reverse_iterator       rbegin();
+    const_reverse_iterator rbegin() const;
+    reverse_iterator       rend();
+    const_reverse_iterator rend()   const;
+    
+    // element access
+    T&       operator [] (const size_t idx);
+    const T& operator [] (const size_t idx) const;
+    T&       front();
+    const T& front() const;
+    T&       back();
+    const T& back()  const;
+    
+    // size
+    bool   empty() const;
+    size_t size()  const;
+    void   reserve(const size_t min_capacity);  // prepare for the given number of elements
+    
+    // modifiers
+    void     push_back(const T& value);                     // append an element
+    void     pop_back();                                    // remove the last element
+    iterator insert(iterator pos, const T& value);          // insert an element before the given one
+    iterator erase(iterator pos);                           // remove the given element
+    void     clear();                                       // remove all elements (keeping the allocated memory)
+};
+
+// method implementations
+template <typename T, size_t N>
+inline T* SmallVector<T, N>::data() {return (capacity > N) ? storage.heap : reinterpret_cast<T*>(storage.buffer);}
+
+template <typename T, size_t N>
+inline const T* SmallVector<T, N>::data() const {return (capacity > N) ? storage.heap : reinterpret_cast<const T*>(storage.buffer);}
+
+template <typename T, size_t N>
+void SmallVector<T, N>::grow(const size_t min_capacity)
+{
+    size_t cap = 2 * capacity;
+    if (cap < min_capacity) cap = min_capacity;
+    T* const source = data();
+    T* const target = static_cast<T*>(::operator new(cap * sizeof(T)));
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        new (target + i) T(source[i]);
+        source[i].~T();
+    };
+    if (capacity > N) ::operator delete(storage.heap);
+    storage.heap = target;
+    capacity = static_cast<unsigned int>(cap);
+}
+
+template <typename T, size_t N>
+inline SmallVector<T, N>::SmallVector() : count(0), capacity(N) {}
+
+template <typename T, size_t N>
+SmallVector<T, N>::SmallVector(const SmallVector& vector) : count(0), capacity(N)
+{
+    reserve(vector.count);
+    for (T* const target = data(); count < vector.count; ++count)
+        new (target + count) T(vector.data()[count]);
+}
+
+template <typename T, size_t N>
+inline SmallVector<T, N>::~SmallVector() {clear(); if (capacity > N) ::operator delete(storage.heap);}
+
+template <typename T, size_t N>
+SmallVector<T, N>& SmallVector<T, N>::operator = (const SmallVector& vector)
+{
+    if (this == &vector) return *this;
+    clear();
+    reserve(vector.count);
+    for (T* const target = data(); count < vector.count; ++count)
+        new (target + count) T(vector.data()[count]);
+    return *this;
+}
+
+template <typename T, size_t N> inline typename SmallVector<T, N>::iterator               SmallVector<T, N>::begin()        {return data();}
+template <typename T, size_t N> inline typename SmallVector<T, N>::const_iterator         SmallVector<T, N>::begin()  const {return data();}
+template <typename T, size_t N> inline typename SmallVector<T, N>::iterator               SmallVector<T, N>::end()          {return data() + count;}
+template <typename T, size_t N> inline typename SmallVector<T, N>::const_iterator         SmallVector<T, N>::end()    const {return data() + count;}
+template <typename T, size_t N> inline typename SmallVector<T, N>::reverse_iterator       SmallVector<T, N>::rbegin()       {return reverse_iterator(end());}
+template <typename T, size_t N> inline typename SmallVector<T, N>::const_reverse_iterator SmallVector<T, N>::rbegin() const {return const_reverse_iterator(end());}
+template <typename T, size_t N> inline typename SmallVector<T, N>::reverse_iterator       SmallVector<T, N>::rend()         {return reverse_iterator(begin());}
+template <typename T, size_t N> inline typename SmallVector<T, N>::const_reverse_iterator SmallVector<T, N>::rend()   const {return const_reverse_iterator(begin());}
+
+template <typename T, size_t N> inline T&       SmallVector<T, N>::operator [] (const size_t idx)       {return data()[idx];}
+template <typename T, size_t N> inline const T& SmallVector<T, N>::operator [] (const size_t idx) const {return data()[idx];}
+template <typename T, size_t N> inline T&       SmallVector<T, N>::front()       {return data()[0];}
+template <typename T, size_t N> inline const T& SmallVector<T, N>::front() const {return data()[0];}
+template <typename T, size_t N> inline T&       SmallVector<T, N>::back()        {return data()[count - 1];}
+template <typename T, size_t N> inline const T& SmallVector<T, N>::back()  const {return data()[count - 1];}
+
+template <typename T, size_t N> inline bool   SmallVector<T, N>::empty() const {return count == 0;}
+template <typename T, size_t N> inline size_t SmallVector<T, N>::size()  const {return count;}
+
+template <typename T, size_t N>
+inline void SmallVector<T, N>::reserve(const size_t min_capacity) {if (min_capacity > capacity) grow(min_capacity);}
+
+template <typename T, size_t N>
+inline void SmallVector<T, N>::push_back(const T& value)
+{
+    if (count < capacity) {new (data() + count) T(value); ++count; return;};
+    const T copy(value);    // (the value may be an element of this vector)
+    grow(count + 1);
+    new (data() + count) T(copy);
+    ++count;
+}
+
+template <typename T, size_t N>
+inline void SmallVector<T, N>::pop_back() {data()[--count].~T();}
+
+template <typename T, size_t N>
+typename SmallVector<T, N>::iterator SmallVector<T, N>::insert(iterator pos, const T& value)
+{
+    const size_t idx = static_cast<size_t>(pos - data());
+    push_back(value);
+    T* const elements = data();
+    for (size_t i = count - 1; i > idx; --i)    // rotate the new element to its position
+    {
+        const T tmp(elements[i]);
+        elements[i] = elements[i - 1];
+        elements[i - 1] = tmp;
+    };
+    return elements + idx;
+}
+
+template <typename T, size_t N>
+typename SmallVector<T, N>::iterator SmallVector<T, N>::erase(iterator pos)
+{
+    for (iterator i = pos + 1; i != end(); ++i)
+        *(i - 1) = *i;
+    pop_back();
+    return pos;
+}
+
+template <typename T, size_t N>
+inline void SmallVector<T, N>::clear()
+{
+    T* const elements = data();
+    while (count) elements[--count].~T();
+}
+
+} // end namespace
+
+#endif
+
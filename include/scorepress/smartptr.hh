@@ -36,7 +36,8 @@ template <typename T> struct CopyTrait;     // clone-trait class for "T::copy"
 //     class SmartPtr
 //    ================
 //
-// Implementation of a simple deep-copy smart pointer.
+// Implementation of a simple deep-copy smart pointer. Copying clones the object
+// (according to the trait), while moving only transfers the ownership.
 //
 template <typename T, template <typename> class trait = StdTrait> class SmartPtr
 {
@@ -46,6 +47,7 @@ template <typename T, template <typename> class trait = StdTrait> class SmartPtr
  public:
     SmartPtr();
     SmartPtr(const SmartPtr<T, trait>& ptr);
+    SmartPtr(SmartPtr<T, trait>&& ptr) noexcept;
     explicit SmartPtr(T* const ptr);
     ~SmartPtr();
     
@@ -53,6 +55,7 @@ template <typename T, template <typename> class trait = StdTrait> class SmartPtr
     T* operator-> () const {return data;}
     
     SmartPtr<T, trait>& operator = (const SmartPtr<T, trait>& ptr);
+    SmartPtr<T, trait>& operator = (SmartPtr<T, trait>&& ptr) noexcept;
     SmartPtr<T, trait>& transfer_to(SmartPtr<T, trait>& ptr);
     
     bool operator ! () const;
@@ -78,6 +81,9 @@ inline SmartPtr<T, trait>::SmartPtr() : data(0) {}
 template <typename T, template <typename> class trait>
 inline SmartPtr<T, trait>::SmartPtr(const SmartPtr<T, trait>& ptr) : data(trait<T>::clone(ptr.data)) {}
 
+template <typename T, template <typename> class trait>
+inline SmartPtr<T, trait>::SmartPtr(SmartPtr<T, trait>&& ptr) noexcept : data(ptr.data) {ptr.data = 0;}
+
 template <typename T, template <typename> class trait>
 inline SmartPtr<T, trait>::SmartPtr(T* const ptr) : data(ptr) {}
 
@@ -88,6 +94,10 @@ template <typename T, template <typename> class trait>
 inline SmartPtr<T, trait>& SmartPtr<T, trait>::operator = (const SmartPtr<T, trait>& ptr)
 {if (data != ptr.data) {delete data; data = trait<T>::clone(ptr.data);}; return *this;}
 
+template <typename T, template <typename> class trait>
+inline SmartPtr<T, trait>& SmartPtr<T, trait>::operator = (SmartPtr<T, trait>&& ptr) noexcept
+{if (this != &ptr) {delete data; data = ptr.data; ptr.data = 0;}; return *this;}
+
 template <typename T, template <typename> class trait>
 inline SmartPtr<T, trait>& SmartPtr<T, trait>::transfer_to(SmartPtr<T, trait>& ptr)
 {if (data != ptr.data) {delete ptr.data; ptr.data = data;}; data = 0; return ptr;}
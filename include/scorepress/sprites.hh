@@ -26,7 +26,9 @@
 #include <map>          // std::map
 #include <deque>        // std::deque
 
+#include "atom.hh"      // Atom, AtomMap
 #include "sprite_id.hh" // SpriteId
+#include "basetypes.hh" // mpx_t
 #include "export.hh"
 
 namespace ScorePress
@@ -36,6 +38,8 @@ namespace ScorePress
 class SCOREPRESS_API SpriteInfo;    // sprite graphic information
 class SCOREPRESS_API SpriteSet;     // set of sprites
 class SCOREPRESS_API Sprites;       // set of sprite-sets
+class SCOREPRESS_API SpriteMetrics; // metrics of a sprite-set, scaled to a head-height
+class SCOREPRESS_API MetricsCache;  // scaled sprite metrics (for each used sprite-set and head-height)
 
 
 //
@@ -44,7 +48,8 @@ class SCOREPRESS_API Sprites;       // set of sprite-sets
 //
 // Meta-information structure for one sprite graphic.
 // This contains the dimension as well as all provided attributes for a single
-// graphic.
+// graphic. The property keys are interned (see "AtomTable"), so that the
+// engraver can look them up by atom without comparing strings.
 //
 class SCOREPRESS_API SpriteInfo
 {
@@ -67,26 +72,47 @@ class SCOREPRESS_API SpriteInfo
     std::string path;   // svg path-name
     
     std::map<std::string, std::string> name;    // sprite name (internationalized; UTF8)
-    std::map<std::string, std::string> text;    // text properties
-    std::map<std::string, double>      real;    // floating-point properties
-    std::map<std::string, int>         integer; // integer properties
+    AtomMap<std::string>               text;    // text properties
+    AtomMap<double>                    real;    // floating-point properties
+    AtomMap<int>                       integer; // integer properties
     
     SpriteInfo(Type type);  // constructor
     
     // easy access methods (with default returns for non-existing values)
+    bool has_text   (const Atom key) const;
+    bool has_real   (const Atom key) const;
+    bool has_integer(const Atom key) const;
     bool has_text   (const std::string& key) const;
     bool has_real   (const std::string& key) const;
     bool has_integer(const std::string& key) const;
     
+    const std::string& get_text   (const Atom key) const;
+          double       get_real   (const Atom key) const;
+          int          get_integer(const Atom key) const;
     const std::string& get_text   (const std::string& key) const;
           double       get_real   (const std::string& key) const;
           int          get_integer(const std::string& key) const;
 };
 
+inline bool SpriteInfo::has_text   (const Atom key) const {return text.find(key) != text.end();}
+inline bool SpriteInfo::has_real   (const Atom key) const {return real.find(key) != real.end();}
+inline bool SpriteInfo::has_integer(const Atom key) const {return integer.find(key) != integer.end();}
 inline bool SpriteInfo::has_text   (const std::string& key) const {return text.find(key) != text.end();}
 inline bool SpriteInfo::has_real   (const std::string& key) const {return real.find(key) != real.end();}
 inline bool SpriteInfo::has_integer(const std::string& key) const {return integer.find(key) != integer.end();}
 
+inline double SpriteInfo::get_real(const Atom key) const
+{
+    const AtomMap<double>::const_iterator i = real.find(key);
+    return (i == real.end()) ? 0.0 : i->second;
+}
+
+inline int SpriteInfo::get_integer(const Atom key) const
+{
+    const AtomMap<int>::const_iterator i = integer.find(key);
+    return (i == integer.end()) ? 0 : i->second;
+}
+
 
 //
 //     class SpriteSet
@@ -129,9 +155,9 @@ class SCOREPRESS_API SpriteSet : public std::vector<SpriteInfo>
     std::vector<Group> groups;                  // group list
     std::vector<Typeface> typefaces;            // typeface list
     
-    std::map<std::string, size_t> ids;          // map sprite-ids to index
-    std::map<std::string, size_t> gids;         // group-ids
-    std::map<std::string, size_t> fids;         // typeface-ids
+    AtomMap<size_t> ids;                        // map sprite-ids to index
+    AtomMap<size_t> gids;                       // group-ids
+    AtomMap<size_t> fids;                       // typeface-ids
     
     // default-symbol ids
     size_t heads_longa;     // longa head
@@ -173,9 +199,12 @@ class SCOREPRESS_API SpriteSet : public std::vector<SpriteInfo>
     SpriteSet();                        // default constructor (initializing ids with UNDEFINED)
     void clear();                       // erase the vector and reset sprite-ids
     
-    size_t index(const std::string& id) const;              // get index by sprite-id
+    size_t index(const Atom id) const;                      // get index by sprite-id
+    size_t index(const std::string& id) const;
     
-          SpriteInfo& get(const std::string& id);           // get info by sprite-id
+          SpriteInfo& get(const Atom id);                   // get info by sprite-id
+    const SpriteInfo& get(const Atom id) const;
+          SpriteInfo& get(const std::string& id);
     const SpriteInfo& get(const std::string& id) const;
     
           SpriteInfo& operator[] (const size_t& idx);       // get info by index
@@ -183,6 +212,12 @@ class SCOREPRESS_API SpriteSet : public std::vector<SpriteInfo>
 };
 
 // get info by sprite-id
+inline SpriteInfo& SpriteSet::get(const Atom id) {
+    return SpriteSet::operator[](index(id));}
+
+inline const SpriteInfo& SpriteSet::get(const Atom id) const {
+    return SpriteSet::operator[](index(id));}
+
 inline SpriteInfo& SpriteSet::get(const std::string& id) {
     return SpriteSet::operator[](index(id));}
 
@@ -234,6 +269,102 @@ inline unsigned int Sprites::head_height(const SpriteId& id) const {
 inline int Sprites::head_width (const SpriteId& id) const {
     return std::deque<SpriteSet>::operator[](id.setid)[std::deque<SpriteSet>::operator[](id.setid).heads_quarter].width;}
 
+
+
+//
+//     class SpriteMetrics
+//    =====================
+//
+// This class holds the metrics of all sprites of one sprite-set, scaled to the
+// given head-height (in milli-pixel) and indexed by the sprite-id. The real
+// values are scaled per promille (i.e. they are multiplied with the scale of
+// the object's appearance), while the integer values are truncated to
+// milli-pixel (at full scale).
+//
+class SCOREPRESS_API SpriteMetrics
+{
+ public:
+    // scaled metrics of a single sprite
+    struct Metrics
+    {
+        mpx_t  mpx_width;       // width  (in milli-pixel)
+        mpx_t  mpx_height;      // height (in milli-pixel)
+        double width;           // width  (per promille)
+        double height;          // height (per promille)
+        double anchor_x;        // "anchor.x" property (per promille)
+        double anchor_y;        // "anchor.y" property (per promille)
+        double stem_x;          // "stem.x" property (per promille)
+        double stem_y;          // "stem.y" property (per promille)
+        double offset;          // "offset" property (per promille)
+        double distance;        // "distance" property (per promille)
+        double stem_slope;      // "stem.slope" property (per promille)
+        double stem_minlen;     // "stem.minlen" property (per promille)
+        double stem_bottom_x1;  // "stem.bottom.x1" property (per promille)
+        int    line;            // "line" property
+    };
+    
+ private:
+    std::vector<Metrics> sprites;   // metrics of the sprites
+    size_t undefined_symbol;        // index of the symbol for undefined sprites
+    size_t digits_time[10];         // indices of the time-signature digits (the undefined symbol for missing digits)
+    
+ public:
+    size_t setid;                   // index of the sprite-set
+    mpx_t  head_height;             // head-height (in milli-pixel)
+    double scale;                   // scale factor (from sprite pixels to milli-pixel per promille)
+    double head_width;              // width of the quarter head (per promille)
+    mpx_t  mpx_head_width;          // width of the quarter head (in milli-pixel)
+    mpx_t  mpx_digit_space;         // space between time-signature digits (in milli-pixel)
+    
+    SpriteMetrics(const SpriteSet& spriteset, const size_t setid, const mpx_t head_height);
+    
+    const Metrics& operator [] (const size_t idx) const;    // get metrics by index
+    size_t digit(const unsigned int n) const;               // get index of the time-signature digit
+};
+
+inline const SpriteMetrics::Metrics& SpriteMetrics::operator [] (const size_t idx) const {
+    return sprites[(idx < sprites.size()) ? idx : undefined_symbol];}
+
+inline size_t SpriteMetrics::digit(const unsigned int n) const {return digits_time[n];}
+
+
+//
+//     class MetricsCache
+//    ====================
+//
+// This class builds the metrics of the sprite-sets on demand, once for each
+// combination of sprite-set and head-height. It is held by the engraver for
+// a single engraving (and is thus not shared between threads).
+//
+class SCOREPRESS_API MetricsCache
+{
+ private:
+    const Sprites*            sprites;  // sprite-library
+    std::deque<SpriteMetrics> tables;   // built metrics (references remain valid)
+    const SpriteMetrics*      last;     // last requested metrics
+    
+    const SpriteMetrics& find(const size_t setid, const mpx_t head_height);     // find or build the metrics
+    
+    // (uncopyable)
+    MetricsCache(const MetricsCache&);
+    MetricsCache& operator = (const MetricsCache&);
+    
+ public:
+    explicit MetricsCache(const Sprites& sprites);  // constructor (without metrics)
+    
+    const Sprites& get_sprites() const;                                         // sprite-library
+    const SpriteMetrics& get(const size_t setid, const mpx_t head_height);      // metrics of the sprite-set
+    const SpriteMetrics::Metrics& get(const SpriteId& id, const mpx_t head_height);    // metrics of the sprite
+};
+
+inline const Sprites& MetricsCache::get_sprites() const {return *sprites;}
+
+inline const SpriteMetrics& MetricsCache::get(const size_t setid, const mpx_t head_height) {
+    return (last && last->setid == setid && last->head_height == head_height) ? *last : find(setid, head_height);}
+
+inline const SpriteMetrics::Metrics& MetricsCache::get(const SpriteId& id, const mpx_t head_height) {
+    return get(id.setid, head_height)[id.spriteid];}
+
 } // end namespace
 
 #endif
@@ -0,0 +1,147 @@
+
+/*
+  ScorePress - Music Engraving Software  (libscorepress)
+  Copyright (C) 2016 Dominik Lehmann
+  
+  Licensed under the EUPL, Version 1.1 or - as soon they
+  will be approved by the European Commission - subsequent
+  versions of the EUPL (the "Licence");
+  You may not use this work except in compliance with the
+  Licence. You may obtain a copy of the Licence at
+  <http://ec.europa.eu/idabc/eupl/>.
+  
+  Unless required by applicable law or agreed to in
+  writing, software distributed under the Licence is
+  distributed on an "AS IS" basis, WITHOUT WARRANTIES OR
+  CONDITIONS OF ANY KIND, either expressed or implied.
+  See the Licence for the specific language governing
+  permissions and limitations under the Licence.
+*/
+
+#ifndef SCOREPRESS_STATISTICS_HH
+#define SCOREPRESS_STATISTICS_HH
+
+#include <cstddef>      // size_t
+#ifdef STATISTICS
+#include <chrono>       // std::chrono::steady_clock
+#endif
+
+#include "export.hh"
+
+namespace ScorePress
+{
+//  CLASSES
+// ---------
+class SCOREPRESS_API Statistics;    // performance counters of the engraving and rendering
+
+
+//
+//     class Statistics
+//    ==================
+//
+// This class holds the accumulated wall-time and the number of calls of each
+// engraving phase and of the rendering, as well as the number of engraved
+// objects. The counters are only updated, if the library is compiled with
+// "STATISTICS" defined (see "configure --enable-statistics"). Otherwise the
+// instrumentation compiles to nothing and all values remain zero.
+//
+class SCOREPRESS_API Statistics
+{
+ public:
+    // measured phases
+    enum Phase {PICK,           // engraving of the objects (pick and engrave loop)
+                LINEEND,        // calculation of the line-end information   (EngraverState::create_lineend)
+                JUSTIFY,        // line justification                        (EngraverState::justify_line)
+                OFFSETS,        // application of non-cumulative offsets     (EngraverState::apply_offsets)
+                STEMS,          // stem engraving                            (EngraverState::engrave_stems)
+                ATTACHABLES,    // attachable engraving                      (EngraverState::engrave_attachables)
+                BRACES,         // brace and bracket engraving               (EngraverState::engrave_braces)
+                RENDER,         // rendering of the pages                    (Press::render)
+                PHASE_COUNT};
+    
+    // counted objects
+    enum Counter {LINES,        // engraved lines
+                  NOTES,        // engraved on-plate objects (Plate::pNote)
+                  ATTACHED,     // engraved attachables
+                  VIRTUALS,     // engraved virtual objects (inserted by the pick)
+                  COUNTER_COUNT};
+    
+    // run-time and number of calls of a phase
+    struct SCOREPRESS_API Timer
+    {
+        unsigned long long time;    // accumulated wall-time (in nanoseconds)
+        size_t             calls;   // number of calls
+    };
+    
+#ifdef STATISTICS
+    // scope guard, measuring a phase during its lifetime
+    class SCOREPRESS_LOCAL Scope
+    {
+     private:
+        Statistics* const                           statistics;
+        const Phase                                 phase;
+        const std::chrono::steady_clock::time_point start;
+    
+     public:
+        Scope(Statistics* const stats, const Phase phase);
+        ~Scope();
+    };
+    
+#endif
+ private:
+    Timer  timers[PHASE_COUNT];
+    size_t counters[COUNTER_COUNT];
+    
+ public:
+    // constructor
+    Statistics();
+    
+    // is the library compiled with instrumentation?
+    static bool enabled();
+    
+    // name of a phase or counter
+    static const char* name(const Phase phase);
+    static const char* name(const Counter counter);
+    
+    // access the values
+    const Timer& get(const Phase phase) const;
+    size_t       get(const Counter counter) const;
+    
+    // modify the values
+    void add(const Phase phase, const unsigned long long time);     // add a call of the phase with the given run-time
+    void count(const Counter counter, const size_t n = 1);           // increase the counter
+    void merge(const Statistics& statistics);                        // add the values of the given statistics
+    void reset();                                                    // set all values to zero
+};
+
+// inline method implementations
+inline const Statistics::Timer& Statistics::get(const Phase phase) const     {return timers[phase];}
+inline size_t                   Statistics::get(const Counter counter) const {return counters[counter];}
+
+inline void Statistics::add(const Phase phase, const unsigned long long time) {timers[phase].time += time; ++timers[phase].calls;}
+inline void Statistics::count(const Counter counter, const size_t n)          {counters[counter] += n;}
+
+#ifdef STATISTICS
+inline Statistics::Scope::Scope(Statistics* const stats, const Phase _phase)
+        : statistics(stats), phase(_phase), start(std::chrono::steady_clock::now()) {}
+
+inline Statistics::Scope::~Scope()
+{
+    if (statistics) statistics->add(phase, static_cast<unsigned long long>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+}
+#endif
+
+} // end namespace
+
+// instrumentation macros (given a pointer to the target statistics, which may be NULL)
+#ifdef STATISTICS
+#define SCOREPRESS_TIME(stats, phase)           const ScorePress::Statistics::Scope _statistics_scope_##phase((stats), ScorePress::Statistics::phase)
+#define SCOREPRESS_COUNT(stats, counter, n)     {if (stats) (stats)->count(ScorePress::Statistics::counter, (n));}
+#else
+#define SCOREPRESS_TIME(stats, phase)
+#define SCOREPRESS_COUNT(stats, counter, n)
+#endif
+
+#endif
+
@@ -29,7 +29,27 @@ namespace ScorePress
 {
 namespace Test
 {
+    // parameters of the synthetic score generator (densities in permille of the beats)
+    struct SCOREPRESS_API SyntheticParam
+    {
+        size_t       staves;        // number of staves
+        size_t       subvoices;     // number of sub-voices per staff (beginning with each line)
+        size_t       beats;         // number of beats per voice (each a quarter or two beamed eighths)
+        size_t       line_beats;    // number of beats per line (followed by a newline)
+        size_t       page_lines;    // number of lines per page (followed by a pagebreak; 0 for no pagebreaks)
+        bool         justify;       // justify the lines?
+        unsigned int beams;         // density of beamed eighths
+        unsigned int ties;          // density of ties
+        unsigned int slurs;         // density of slurs
+        unsigned int hairpins;      // density of hairpins
+        unsigned int accidentals;   // density of accidentals
+        unsigned int seed;          // seed for the pseudo-random choices (equal seeds generate equal scores)
+        
+        SyntheticParam();
+    };
+    
     SCOREPRESS_API const Document& get_document(const Sprites&);
+    SCOREPRESS_API void get_synthetic_document(Document& document, const Sprites&, const SyntheticParam&);
 }
 }
 
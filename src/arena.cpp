@@ -0,0 +1,220 @@
+
+/*
+  ScorePress - Music Engraving Software  (libscorepress)
+  Copyright (C) 2016 Dominik Lehmann
+  
+  Licensed under the EUPL, Version 1.1 or - as soon they
+  will be approved by the European Commission - subsequent
+  versions of the EUPL (the "Licence");
+  You may not use this work except in compliance with the
+  Licence. You may obtain a copy of the Licence at
+  <http://ec.europa.eu/idabc/eupl/>.
+  
+  Unless required by applicable law or agreed to in
+  writing, software distributed under the Licence is
+  distributed on an "AS IS" basis, WITHOUT WARRANTIES OR
+  CONDITIONS OF ANY KIND, either expressed or implied.
+  See the Licence for the specific language governing
+  permissions and limitations under the Licence.
+*/
+
+#include <atomic>       // std::atomic
+#include <mutex>        // std::mutex, std::lock_guard
+
+#include "arena.hh"
+using namespace ScorePress;
+
+
+//
+//     class Arena
+//    =============
+//
+// This class hands out memory from large blocks, which are only returned to
+// the system, when the arena is destroyed.
+//
+
+const size_t Arena::GRANULARITY;
+const size_t Arena::MAX_SIZE;
+const size_t Arena::MIN_BLOCK;
+const size_t Arena::MAX_BLOCK;
+
+// constructor (without blocks)
+Arena::Arena() : blocks(NULL), next(NULL), end(NULL), capacity(0)
+{
+    for (size_t i = 0; i < MAX_SIZE / GRANULARITY; ++i)
+        free_list[i] = NULL;
+}
+
+// destructor (releasing all blocks)
+Arena::~Arena()
+{
+    while (blocks)
+    {
+        Block* const block = blocks;
+        blocks = block->next;
+        ::operator delete(block);
+    };
+}
+
+// allocate the object from a new block
+// (the rest of the previous block is left unused; the header is padded to keep the objects aligned)
+void* Arena::allocate_block(const size_t size)
+{
+    const size_t block_size = (capacity < MIN_BLOCK) ? MIN_BLOCK : ((capacity > MAX_BLOCK) ? MAX_BLOCK : capacity);
+    Block* const block = static_cast<Block*>(::operator new(block_size));
+    block->next = blocks;
+    blocks = block;
+    capacity += block_size;
+    
+    char* const ptr = reinterpret_cast<char*>(block) + GRANULARITY;
+    next = ptr + size;
+    end = reinterpret_cast<char*>(block) + block_size;
+    return ptr;
+}
+
+
+//
+//     class ObjectPool
+//    ==================
+//
+// This pool hands out memory from blocks, which are cached per thread. The
+// released objects are kept in the free lists of the releasing thread; the
+// free lists of finished threads are collected in a depot (protected by a
+// mutex), from which the other threads refill their caches.
+//
+
+const size_t ObjectPool::GRANULARITY;
+const size_t ObjectPool::MAX_SIZE;
+const size_t ObjectPool::BLOCK_SIZE;
+
+static const size_t POOL_CLASSES = ObjectPool::MAX_SIZE / ObjectPool::GRANULARITY;
+
+struct SCOREPRESS_LOCAL PoolBlock {PoolBlock* next;};    // block header (followed by the objects)
+struct SCOREPRESS_LOCAL PoolFree  {PoolFree*  next;};    // released object (element of a free list)
+
+// memory cache of a thread (zero-initialized, without destructor; thus usable until the thread is gone)
+struct SCOREPRESS_LOCAL PoolCache
+{
+    PoolFree* free_list[POOL_CLASSES];      // released objects (for each size class)
+    char*     next;                         // free memory within the current block
+    char*     end;                          // end of the current block
+    bool      registered;                   // is the cache handed to the depot on thread exit?
+};
+
+// hands the cache of its thread to the depot on thread exit
+struct SCOREPRESS_LOCAL PoolCacheGuard
+{
+    bool active;                            // is the cache in use?
+    ~PoolCacheGuard();
+};
+
+static thread_local PoolCache      pool_cache;
+static thread_local PoolCacheGuard pool_cache_guard;
+
+static std::mutex        depot_lock;            // lock for the depot and the block list
+static PoolFree*         depot[POOL_CLASSES];   // released objects of finished threads
+static std::atomic<bool> depot_filled(false);   // does the depot contain any object?
+static PoolBlock*        pool_blocks = NULL;    // allocated blocks (kept until the process exits)
+
+// prepend the free list "source" to "target"
+static void prepend(PoolFree*& target, PoolFree* const source)
+{
+    if (!source) return;
+    PoolFree* tail = source;
+    while (tail->next) tail = tail->next;
+    tail->next = target;
+    target = source;
+}
+
+// hand the free lists of this thread's cache to the depot
+PoolCacheGuard::~PoolCacheGuard()
+{
+    if (!active) return;
+    std::lock_guard<std::mutex> guard(depot_lock);
+    for (size_t i = 0; i < POOL_CLASSES; ++i)
+    {
+        prepend(depot[i], pool_cache.free_list[i]);
+        pool_cache.free_list[i] = NULL;
+    };
+    depot_filled.store(true);
+}
+
+// allocate the object from the depot or a new block (the cache being empty for the given class)
+static void* allocate_slow(const size_t cls)
+{
+    PoolCache& cache = pool_cache;
+    const size_t size = (cls + 1) * ObjectPool::GRANULARITY;
+    if (!cache.registered)
+    {
+        pool_cache_guard.active = true;
+        cache.registered = true;
+    };
+    
+    if (depot_filled.load(std::memory_order_relaxed))   // take the objects of finished threads
+    {
+        std::lock_guard<std::mutex> guard(depot_lock);
+        for (size_t i = 0; i < POOL_CLASSES; ++i)
+        {
+            prepend(cache.free_list[i], depot[i]);
+            depot[i] = NULL;
+        };
+        depot_filled.store(false);
+        if (cache.free_list[cls])
+        {
+            PoolFree* const ptr = cache.free_list[cls];
+            cache.free_list[cls] = ptr->next;
+            return ptr;
+        };
+    };
+    
+    if (static_cast<size_t>(cache.end - cache.next) < size)     // allocate a new block
+    {                                                           // (the rest of the previous one is left unused)
+        PoolBlock* const block = static_cast<PoolBlock*>(::operator new(ObjectPool::BLOCK_SIZE));
+        {
+            std::lock_guard<std::mutex> guard(depot_lock);
+            block->next = pool_blocks;
+            pool_blocks = block;
+        };
+        cache.next = reinterpret_cast<char*>(block) + ObjectPool::GRANULARITY;
+        cache.end = reinterpret_cast<char*>(block) + ObjectPool::BLOCK_SIZE;
+    };
+    void* const ptr = cache.next;
+    cache.next += size;
+    return ptr;
+}
+
+// allocate memory for an object of the given size
+void* ObjectPool::allocate(const size_t size)
+{
+    if (size > MAX_SIZE) return ::operator new(size);
+    const size_t cls = (size - 1) / GRANULARITY;    // size class
+    PoolCache& cache = pool_cache;
+    if (cache.free_list[cls])                       // reuse a released object
+    {
+        PoolFree* const ptr = cache.free_list[cls];
+        cache.free_list[cls] = ptr->next;
+        return ptr;
+    };
+    const size_t n = (cls + 1) * GRANULARITY;       // rounded size
+    if (static_cast<size_t>(cache.end - cache.next) < n) return allocate_slow(cls);
+    void* const ptr = cache.next;
+    cache.next += n;
+    return ptr;
+}
+
+// release the memory of an object (of the given size)
+void ObjectPool::deallocate(void* ptr, const size_t size)
+{
+    if (!ptr) return;
+    if (size > MAX_SIZE) {::operator delete(ptr); return;};
+    const size_t cls = (size - 1) / GRANULARITY;
+    PoolCache& cache = pool_cache;
+    if (!cache.registered)                          // threads only releasing objects hand them over too
+    {
+        pool_cache_guard.active = true;
+        cache.registered = true;
+    };
+    static_cast<PoolFree*>(ptr)->next = cache.free_list[cls];
+    cache.free_list[cls] = static_cast<PoolFree*>(ptr);
+}
+
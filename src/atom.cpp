@@ -0,0 +1,118 @@
+
+/*
+  ScorePress - Music Engraving Software  (libscorepress)
+  Copyright (C) 2016 Dominik Lehmann
+  
+  Licensed under the EUPL, Version 1.1 or - as soon they
+  will be approved by the European Commission - subsequent
+  versions of the EUPL (the "Licence");
+  You may not use this work except in compliance with the
+  Licence. You may obtain a copy of the Licence at
+  <http://ec.europa.eu/idabc/eupl/>.
+  
+  Unless required by applicable law or agreed to in
+  writing, software distributed under the Licence is
+  distributed on an "AS IS" basis, WITHOUT WARRANTIES OR
+  CONDITIONS OF ANY KIND, either expressed or implied.
+  See the Licence for the specific language governing
+  permissions and limitations under the Licence.
+*/
+
+
+#include <map>          // std::map
+#include <deque>        // std::deque
+#include <mutex>        // std::mutex, std::lock_guard
+
+#include "atom.hh"
+using namespace ScorePress;
+
+
+//
+//     class AtomTable
+//    =================
+//
+// This table interns strings, handing out a small integer (the atom) for each
+// distinct string. The names are kept in a deque, so that the references
+// returned by "name" stay valid while further strings are interned.
+//
+
+// names of the predefined atoms (in the order of the enumeration)
+static const char* const predefined_names[ATOM_PREDEFINED] = {
+    "anchor.x", "anchor.y",
+    "stem.x", "stem.y",
+    "offset", "distance", "line",
+    "stem.slope", "stem.minlen",
+    "stem.top.x1", "stem.top.y1", "stem.top.x2", "stem.top.y2",
+    "stem.bottom.x1", "stem.bottom.y1", "stem.bottom.x2", "stem.bottom.y2",
+    "basenote", "keybound.sharp", "keybound.flat",
+    "hmin", "hmax", "low", "high",
+    "linewidth"};
+
+// table content
+struct SCOREPRESS_LOCAL AtomTableData
+{
+    std::mutex                  lock;   // lock for the table
+    std::map<std::string, Atom> atoms;  // atoms (by name)
+    std::deque<std::string>     names;  // names (by atom)
+    
+    AtomTableData();                    // constructor (interning the predefined atoms)
+    Atom intern(const std::string& name);
+};
+
+AtomTableData::AtomTableData()
+{
+    for (unsigned int i = 0; i < ATOM_PREDEFINED; ++i)
+        intern(predefined_names[i]);
+}
+
+// get the atom of the string, adding it if necessary (the lock being held)
+Atom AtomTableData::intern(const std::string& name)
+{
+    const std::map<std::string, Atom>::const_iterator i = atoms.find(name);
+    if (i != atoms.end()) return i->second;
+    const Atom atom = static_cast<Atom>(names.size());
+    names.push_back(name);
+    atoms[name] = atom;
+    return atom;
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wexit-time-destructors"
+
+// the table (constructed on first use)
+static AtomTableData& atom_table()
+{
+    static AtomTableData data;
+    return data;
+}
+
+// get the string of the atom
+const std::string& AtomTable::name(const Atom atom)
+{
+    static const std::string nullname;
+    AtomTableData& table = atom_table();
+    std::lock_guard<std::mutex> guard(table.lock);
+    return (atom < table.names.size()) ? table.names[atom] : nullname;
+}
+
+#pragma clang diagnostic pop
+
+// get the atom of the string (adding it, if necessary)
+Atom AtomTable::intern(const std::string& name)
+{
+    AtomTableData& table = atom_table();
+    std::lock_guard<std::mutex> guard(table.lock);
+    return table.intern(name);
+}
+
+// get the atom of the string (if interned)
+bool AtomTable::find(const std::string& name, Atom& atom)
+{
+    AtomTableData& table = atom_table();
+    std::lock_guard<std::mutex> guard(table.lock);
+    const std::map<std::string, Atom>::const_iterator i = table.atoms.find(name);
+    if (i == table.atoms.end()) return false;
+    atom = i->second;
+    return true;
+}
+
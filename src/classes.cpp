@@ -114,39 +114,83 @@ Class::classType Durable        ::classtype() const {return DURABLE;}
 Class::classType Slur           ::classtype() const {return SLUR;}
 Class::classType Hairpin        ::classtype() const {return HAIRPIN;}
 
-bool      VisibleObject  ::is(classType type) const {return (type == VISIBLEOBJECT);}
-bool      StaffObject    ::is(classType type) const {return (type == STAFFOBJECT);}
-bool      MusicObject    ::is(classType type) const {return ((type == MUSICOBJECT) || StaffObject::is(type) || VisibleObject::is(type));}
-bool      Clef           ::is(classType type) const {return ((type == CLEF) || MusicObject::is(type));}
-bool      Key            ::is(classType _typ) const {return ((_typ == KEY) || MusicObject::is(_typ));}
-bool      TimeSig        ::is(classType type) const {return ((type == TIMESIG) || MusicObject::is(type));}
-bool      CustomTimeSig  ::is(classType type) const {return ((type == CUSTOMTIMESIG) || TimeSig::is(type));}
-bool      Barline        ::is(classType type) const {return ((type == BARLINE) || MusicObject::is(type));}
-bool      VoiceObject    ::is(classType type) const {return ((type == VOICEOBJECT) || StaffObject::is(type));}
-bool      Newline        ::is(classType type) const {return ((type == NEWLINE) || VoiceObject::is(type));}
-bool      Pagebreak      ::is(classType type) const {return ((type == PAGEBREAK) || Newline::is(type));}
-bool      NoteObject     ::is(classType type) const {return ((type == NOTEOBJECT) || VoiceObject::is(type) || VisibleObject::is(type));}
-bool      Chord          ::is(classType type) const {return ((type == CHORD) || NoteObject::is(type));}
-bool      Rest           ::is(classType type) const {return ((type == REST) || NoteObject::is(type));}
-bool      AttachedObject ::is(classType type) const {return (type == ATTACHEDOBJECT);}
-bool      Accidental     ::is(classType _typ) const {return ((_typ == ACCIDENTAL) || AttachedObject::is(_typ));}
-bool      Articulation   ::is(classType type) const {return ((type == ARTICULATION) || AttachedObject::is(type));}
-bool      Head           ::is(classType type) const {return (type == HEAD);}
-bool      TiedHead       ::is(classType type) const {return ((type == TIEDHEAD) || Head::is(type));}
-bool      Voice          ::is(classType type) const {return (type == VOICE);}
-bool      Staff          ::is(classType type) const {return ((type == STAFF) || Voice::is(type));}
-bool      SubVoice       ::is(classType type) const {return ((type == SUBVOICE) || Voice::is(type));}
-bool      NamedVoice     ::is(classType type) const {return ((type == NAMEDVOICE) || SubVoice::is(type));}
-bool      Movable        ::is(classType type) const {return ((type == MOVABLE) || AttachedObject::is(type));}
-bool      Scalable       ::is(classType type) const {return ((type == SCALABLE) || Movable::is(type));}
-bool      TextArea       ::is(classType type) const {return ((type == TEXTAREA) || (Scalable::is(type)));}
-bool      Symbol         ::is(classType type) const {return ((type == SYMBOL) || (Movable::is(type)));}
-bool      PluginInfo     ::is(classType type) const {return ((type == PLUGININFO) || (Movable::is(type)));}
-bool      Annotation     ::is(classType type) const {return ((type == ANNOTATION) || (TextArea::is(type)));}
-bool      CustomSymbol   ::is(classType type) const {return ((type == CUSTOMSYMBOL) || (Symbol::is(type)));}
-bool      Durable        ::is(classType type) const {return ((type == DURABLE) || (Symbol::is(type)));}
-bool      Slur           ::is(classType type) const {return ((type == SLUR) || (Durable::is(type)));}
-bool      Hairpin        ::is(classType type) const {return ((type == HAIRPIN) || (Durable::is(type)));}
+// ancestry bitmasks (the bit of the class type, combined with the masks of the base classes)
+// (thus "is" is a single bit-test instead of a chain of calls along the class hierarchy)
+typedef unsigned long long mask_t;
+static_assert(Class::EXTERNAL < 64, "The class types do not fit into the ancestry bitmask.");
+#define _bit(type) (static_cast<mask_t>(1) << Class::type)
+
+static const mask_t VISIBLEOBJECT_MASK  = _bit(VISIBLEOBJECT);
+static const mask_t STAFFOBJECT_MASK    = _bit(STAFFOBJECT);
+static const mask_t MUSICOBJECT_MASK    = _bit(MUSICOBJECT) | STAFFOBJECT_MASK | VISIBLEOBJECT_MASK;
+static const mask_t CLEF_MASK           = _bit(CLEF) | MUSICOBJECT_MASK;
+static const mask_t KEY_MASK            = _bit(KEY) | MUSICOBJECT_MASK;
+static const mask_t TIMESIG_MASK        = _bit(TIMESIG) | MUSICOBJECT_MASK;
+static const mask_t CUSTOMTIMESIG_MASK  = _bit(CUSTOMTIMESIG) | TIMESIG_MASK;
+static const mask_t BARLINE_MASK        = _bit(BARLINE) | MUSICOBJECT_MASK;
+static const mask_t VOICEOBJECT_MASK    = _bit(VOICEOBJECT) | STAFFOBJECT_MASK;
+static const mask_t NEWLINE_MASK        = _bit(NEWLINE) | VOICEOBJECT_MASK;
+static const mask_t PAGEBREAK_MASK      = _bit(PAGEBREAK) | NEWLINE_MASK;
+static const mask_t NOTEOBJECT_MASK     = _bit(NOTEOBJECT) | VOICEOBJECT_MASK | VISIBLEOBJECT_MASK;
+static const mask_t CHORD_MASK          = _bit(CHORD) | NOTEOBJECT_MASK;
+static const mask_t REST_MASK           = _bit(REST) | NOTEOBJECT_MASK;
+static const mask_t ATTACHEDOBJECT_MASK = _bit(ATTACHEDOBJECT);
+static const mask_t ACCIDENTAL_MASK     = _bit(ACCIDENTAL) | ATTACHEDOBJECT_MASK;
+static const mask_t ARTICULATION_MASK   = _bit(ARTICULATION) | ATTACHEDOBJECT_MASK;
+static const mask_t HEAD_MASK           = _bit(HEAD);
+static const mask_t TIEDHEAD_MASK       = _bit(TIEDHEAD) | HEAD_MASK;
+static const mask_t VOICE_MASK          = _bit(VOICE);
+static const mask_t STAFF_MASK          = _bit(STAFF) | VOICE_MASK;
+static const mask_t SUBVOICE_MASK       = _bit(SUBVOICE) | VOICE_MASK;
+static const mask_t NAMEDVOICE_MASK     = _bit(NAMEDVOICE) | SUBVOICE_MASK;
+static const mask_t MOVABLE_MASK        = _bit(MOVABLE) | ATTACHEDOBJECT_MASK;
+static const mask_t SCALABLE_MASK       = _bit(SCALABLE) | MOVABLE_MASK;
+static const mask_t TEXTAREA_MASK       = _bit(TEXTAREA) | SCALABLE_MASK;
+static const mask_t SYMBOL_MASK         = _bit(SYMBOL) | MOVABLE_MASK;
+static const mask_t PLUGININFO_MASK     = _bit(PLUGININFO) | MOVABLE_MASK;
+static const mask_t ANNOTATION_MASK     = _bit(ANNOTATION) | TEXTAREA_MASK;
+static const mask_t CUSTOMSYMBOL_MASK   = _bit(CUSTOMSYMBOL) | SYMBOL_MASK;
+static const mask_t DURABLE_MASK        = _bit(DURABLE) | SYMBOL_MASK;
+static const mask_t SLUR_MASK           = _bit(SLUR) | DURABLE_MASK;
+static const mask_t HAIRPIN_MASK        = _bit(HAIRPIN) | DURABLE_MASK;
+
+#undef _bit
+
+inline static bool _is(const mask_t mask, const Class::classType type) {return type < 64 && ((mask >> type) & 1u) != 0;}
+
+bool      VisibleObject  ::is(classType type) const {return _is(VISIBLEOBJECT_MASK,  type);}
+bool      StaffObject    ::is(classType type) const {return _is(STAFFOBJECT_MASK,    type);}
+bool      MusicObject    ::is(classType type) const {return _is(MUSICOBJECT_MASK,    type);}
+bool      Clef           ::is(classType type) const {return _is(CLEF_MASK,           type);}
+bool      Key            ::is(classType _typ) const {return _is(KEY_MASK,            _typ);}
+bool      TimeSig        ::is(classType type) const {return _is(TIMESIG_MASK,        type);}
+bool      CustomTimeSig  ::is(classType type) const {return _is(CUSTOMTIMESIG_MASK,  type);}
+bool      Barline        ::is(classType type) const {return _is(BARLINE_MASK,        type);}
+bool      VoiceObject    ::is(classType type) const {return _is(VOICEOBJECT_MASK,    type);}
+bool      Newline        ::is(classType type) const {return _is(NEWLINE_MASK,        type);}
+bool      Pagebreak      ::is(classType type) const {return _is(PAGEBREAK_MASK,      type);}
+bool      NoteObject     ::is(classType type) const {return _is(NOTEOBJECT_MASK,     type);}
+bool      Chord          ::is(classType type) const {return _is(CHORD_MASK,          type);}
+bool      Rest           ::is(classType type) const {return _is(REST_MASK,           type);}
+bool      AttachedObject ::is(classType type) const {return _is(ATTACHEDOBJECT_MASK, type);}
+bool      Accidental     ::is(classType _typ) const {return _is(ACCIDENTAL_MASK,     _typ);}
+bool      Articulation   ::is(classType type) const {return _is(ARTICULATION_MASK,   type);}
+bool      Head           ::is(classType type) const {return _is(HEAD_MASK,           type);}
+bool      TiedHead       ::is(classType type) const {return _is(TIEDHEAD_MASK,       type);}
+bool      Voice          ::is(classType type) const {return _is(VOICE_MASK,          type);}
+bool      Staff          ::is(classType type) const {return _is(STAFF_MASK,          type);}
+bool      SubVoice       ::is(classType type) const {return _is(SUBVOICE_MASK,       type);}
+bool      NamedVoice     ::is(classType type) const {return _is(NAMEDVOICE_MASK,     type);}
+bool      Movable        ::is(classType type) const {return _is(MOVABLE_MASK,        type);}
+bool      Scalable       ::is(classType type) const {return _is(SCALABLE_MASK,       type);}
+bool      TextArea       ::is(classType type) const {return _is(TEXTAREA_MASK,       type);}
+bool      Symbol         ::is(classType type) const {return _is(SYMBOL_MASK,         type);}
+bool      PluginInfo     ::is(classType type) const {return _is(PLUGININFO_MASK,     type);}
+bool      Annotation     ::is(classType type) const {return _is(ANNOTATION_MASK,     type);}
+bool      CustomSymbol   ::is(classType type) const {return _is(CUSTOMSYMBOL_MASK,   type);}
+bool      Durable        ::is(classType type) const {return _is(DURABLE_MASK,        type);}
+bool      Slur           ::is(classType type) const {return _is(SLUR_MASK,           type);}
+bool      Hairpin        ::is(classType type) const {return _is(HAIRPIN_MASK,        type);}
 
 // cloning
 Clef*          Clef          ::clone()        const {return new Clef(*this);}
@@ -401,13 +445,11 @@ void Clef::engrave(EngraverState& engraver) const
     pnote.sprite = this->get_sprite(sprites);
     
     // get sprite and position-offset
-    const SpriteInfo& spriteinfo = sprites[pnote.sprite];   // get sprite-info
-    const double scale = head_height /                      // calculate scale factor
-                         (sprites.head_height(pnote.sprite) * 1000.0);
+    const SpriteMetrics::Metrics& spriteinfo = engraver.get_metrics().get(pnote.sprite, head_height);   // get sprite metrics
     
     Position<mpx_t> anchor;                         // anchor position
-    anchor.x = _round(spriteinfo.get_real("anchor.x") * scale * this->appearance.scale);
-    anchor.y = _round(spriteinfo.get_real("anchor.y") * scale * this->appearance.scale);
+    anchor.x = _round(spriteinfo.anchor_x * this->appearance.scale);
+    anchor.y = _round(spriteinfo.anchor_y * this->appearance.scale);
     
     // apply sprite-offset (x-offset applied by "Engraver::apply_offsets()")
     pnote.absolutePos.front() -= anchor;
@@ -415,8 +457,8 @@ void Clef::engrave(EngraverState& engraver) const
     
     // calculate graphical boundaries
     pnote.gphBox.pos    = pnote.absolutePos.front();
-    pnote.gphBox.width  = _round(spriteinfo.width  * scale * this->appearance.scale);
-    pnote.gphBox.height = _round(spriteinfo.height * scale * this->appearance.scale);
+    pnote.gphBox.width  = _round(spriteinfo.width  * this->appearance.scale);
+    pnote.gphBox.height = _round(spriteinfo.height * this->appearance.scale);
     
     // break ties
     engraver.break_ties();
@@ -479,16 +521,14 @@ void Key::engrave(EngraverState& engraver) const
     pnote.sprite = this->get_sprite(sprites);
     
     // get sprite and position-offset
-    const SpriteInfo& spriteinfo = sprites[pnote.sprite];   // get sprite-info
-    const double scale = head_height /                      // calculate scale factor
-                         (sprites.head_height(pnote.sprite) * 1000.0);
+    const SpriteMetrics::Metrics& spriteinfo = engraver.get_metrics().get(pnote.sprite, head_height);   // get sprite metrics
     
-    const mpx_t sprite_width = _round(spriteinfo.width * scale * this->appearance.scale);
-    const mpx_t sprite_height = _round(spriteinfo.height * scale * this->appearance.scale);
+    const mpx_t sprite_width = _round(spriteinfo.width * this->appearance.scale);
+    const mpx_t sprite_height = _round(spriteinfo.height * this->appearance.scale);
     
     Position<mpx_t> anchor;                                         // anchor position
-    anchor.x = _round(spriteinfo.get_real("anchor.x") * scale * this->appearance.scale);
-    anchor.y = _round(spriteinfo.get_real("anchor.y") * scale * this->appearance.scale);
+    anchor.x = _round(spriteinfo.anchor_x * this->appearance.scale);
+    anchor.y = _round(spriteinfo.anchor_y * this->appearance.scale);
     
     // initialize graphical boundaries
     pnote.gphBox.pos = pnote.absolutePos.back();
@@ -500,7 +540,7 @@ void Key::engrave(EngraverState& engraver) const
     for (char i = 0; i < this->number; ++i)
     {
         // context.key_offset returns correct values, because the context was already modified by the key
-        kpos.x = (i * Pick::width(sprites, this, head_height)) / this->number;
+        kpos.x = (i * Pick::width(engraver.get_metrics(), this, head_height)) / this->number;
         kpos.y = engraver.get_staffctx().key_offset(this->type, i, head_height);
         kpos -= anchor;
         pnote.absolutePos.push_back(pnote.absolutePos.front() + kpos);
@@ -523,7 +563,7 @@ void Key::render(Renderer& renderer, const Plate::pNote& note, const PressState&
                               / (1000.0 * renderer.get_sprites().head_height(note.sprite));
     
     // render key accidentals (count from 1, because the first position is the offset of the whole key)
-    for (std::list< Position<mpx_t> >::const_iterator p = ++note.absolutePos.begin(); p != note.absolutePos.end(); ++p)
+    for (Plate::pNote::PositionList::const_iterator p = note.absolutePos.begin() + 1; p != note.absolutePos.end(); ++p)
     {
         renderer.draw_sprite(note.sprite,
                              (state.scale(p->x) + state.offset.x) / 1000.0,
@@ -545,7 +585,7 @@ void TimeSig::engrave(EngraverState& engraver, size_t setid) const
     
     // apply time signature to the whole score
     const value_t& time = engraver.get_time();
-    for (std::list<Plate::pVoice>::iterator i = pline.voices.begin(); i != pline.voices.end(); ++i)
+    for (Plate::VoiceList::iterator i = pline.voices.begin(); i != pline.voices.end(); ++i)
     {
         i->context.modify(*this, time);
     };
@@ -557,17 +597,15 @@ void TimeSig::engrave(EngraverState& engraver, size_t setid) const
     pnote.sprite = SpriteId(setid, sprites[setid].undefined_symbol);
     
     // save number- and denominator-widths
-    const mpx_t width_number = Pick::width(sprites[setid], this->number, head_height);
-    const mpx_t width_beat   = Pick::width(sprites[setid], this->beat, head_height);
+    const SpriteMetrics& metrics = engraver.get_metrics().get(setid, head_height);
+    const mpx_t width_number = Pick::width(metrics, this->number);
+    const mpx_t width_beat   = Pick::width(metrics, this->beat);
     const mpx_t time_height  = _round((engraver.get_staff().line_count - 1) * head_height / 2.0);
     
     // start engraving
     unsigned int n;                     // number buffer
     Position<mpx_t> npos;               // position buffer
     Position<mpx_t> anchor;             // anchor position
-    size_t sprite;                      // sprite buffer
-    const double scale = head_height /  // scale factor
-                         (sprites.head_height(pnote.sprite) * 1000.0);
     
     // engrave number
     n = this->number;                   // copy the number to be drawn
@@ -578,42 +616,40 @@ void TimeSig::engrave(EngraverState& engraver, size_t setid) const
     
     do  // engrave each digit
     {
-        // calculate the sprite-id
-        sprite = (sprites[setid].digits_time[n % 10] == UNDEFINED) ?
-                    sprites[setid].undefined_symbol :
-                    sprites[setid].digits_time[n % 10];
+        // get the metrics of the digit
+        const SpriteMetrics::Metrics& digit = metrics[metrics.digit(n % 10)];
         
         // get "anchor" attribute
-        anchor.x = _round(sprites[setid][sprite].get_real("anchor.x") * scale * this->appearance.scale);
-        anchor.y = _round(sprites[setid][sprite].get_real("anchor.y") * scale * this->appearance.scale);
+        anchor.x = _round(digit.anchor_x * this->appearance.scale);
+        anchor.y = _round(digit.anchor_y * this->appearance.scale);
         
         // detract sprite-width from horizontal position
-        npos.x -= (sprites[setid][sprite].width * head_height) / sprites[setid].head_height;
+        npos.x -= digit.mpx_width;
         pnote.absolutePos.push_back(npos);  // append position
         pnote.absolutePos.back() -= anchor; // apply sprite-offset
         
         // center (vertically)
         pnote.absolutePos.back().y +=
-            (time_height > static_cast<mpx_t>((sprites[setid][sprite].height * head_height) / sprites[setid].head_height)) ?
-                (time_height - (sprites[setid][sprite].height * head_height) / sprites[setid].head_height) / 2 :
-                 time_height - (sprites[setid][sprite].height * head_height) / sprites[setid].head_height;
+            (time_height > digit.mpx_height) ?
+                (time_height - digit.mpx_height) / 2 :
+                 time_height - digit.mpx_height;
         
         // consider space between digits
-        npos.x -= (sprites[setid].timesig_digit_space * head_height) / sprites[setid].head_height;
+        npos.x -= metrics.mpx_digit_space;
         
         // calculate graphical boundaries
         if (pnote.gphBox.width == 0)    // if the box was not set yet
         {                               // set to dimensions of this sprite
             pnote.gphBox.pos = pnote.absolutePos.back();
-            pnote.gphBox.width = _round(sprites[setid][sprite].width * scale * this->appearance.scale);
-            pnote.gphBox.height = _round(sprites[setid][sprite].height * scale * this->appearance.scale);
+            pnote.gphBox.width = _round(digit.width * this->appearance.scale);
+            pnote.gphBox.height = _round(digit.height * this->appearance.scale);
         }
         else                            // otherwise
         {                               // extend the graphical boundary box
             pnote.gphBox.extend(Plate::GphBox(
                 pnote.absolutePos.back(),
-                _round(sprites[setid][sprite].width * scale * this->appearance.scale),
-                _round(sprites[setid][sprite].height * scale * this->appearance.scale)));
+                _round(digit.width * this->appearance.scale),
+                _round(digit.height * this->appearance.scale)));
         };
         
         n /= 10;        // cut off last digit
@@ -629,32 +665,30 @@ void TimeSig::engrave(EngraverState& engraver, size_t setid) const
     
     do  // engrave each digit
     {
-        // calculate the sprite-id
-        sprite = (sprites[setid].digits_time[n % 10] == UNDEFINED) ?
-                    sprites[setid].undefined_symbol :
-                    sprites[setid].digits_time[n % 10];
+        // get the metrics of the digit
+        const SpriteMetrics::Metrics& digit = metrics[metrics.digit(n % 10)];
         
         // get "anchor" attribute
-        anchor.x = _round(sprites[setid][sprite].get_real("anchor.x") * scale * this->appearance.scale);
-        anchor.y = _round(sprites[setid][sprite].get_real("anchor.y") * scale * this->appearance.scale);
+        anchor.x = _round(digit.anchor_x * this->appearance.scale);
+        anchor.y = _round(digit.anchor_y * this->appearance.scale);
         
         // detract sprite-width from horizontal position
-        npos.x -= (sprites[setid][sprite].width * head_height) / sprites[setid].head_height;
+        npos.x -= digit.mpx_width;
         pnote.absolutePos.push_back(npos);  // append position
         pnote.absolutePos.back() -= anchor; // apply sprite-offset
         
         // center (vertically)
-        if (time_height > static_cast<mpx_t>((sprites[setid][sprite].height * head_height) / sprites[setid].head_height))
-            pnote.absolutePos.back().y += (time_height - (sprites[setid][sprite].height * head_height) / sprites[setid].head_height) / 2;
+        if (time_height > digit.mpx_height)
+            pnote.absolutePos.back().y += (time_height - digit.mpx_height) / 2;
         
         // calculate graphical boundaries
         pnote.gphBox.extend(Plate::GphBox(
             pnote.absolutePos.back(),
-            _round(sprites[setid][sprite].width * scale * this->appearance.scale),
-            _round(sprites[setid][sprite].height * scale * this->appearance.scale)));
+            _round(digit.width * this->appearance.scale),
+            _round(digit.height * this->appearance.scale)));
         
         // consider space between digits
-        npos.x -= (sprites[setid].timesig_digit_space * head_height) / sprites[setid].head_height;
+        npos.x -= metrics.mpx_digit_space;
         
         n /= 10;        // cut off last digit
     } while(n != 0);    // repeat until the whole number is drawn
@@ -673,7 +707,7 @@ void TimeSig::render(Renderer& renderer, const Plate::pNote& note, const PressSt
                               / (1000.0 * renderer.get_sprites().head_height(note.sprite));
     
     unsigned int n = this->number;
-    for (Plate::pNote::PositionList::const_iterator p = ++note.absolutePos.begin(); p != note.absolutePos.end(); ++p)
+    for (Plate::pNote::PositionList::const_iterator p = note.absolutePos.begin() + 1; p != note.absolutePos.end(); ++p)
     {
         renderer.draw_sprite(
                 SpriteId(note.sprite.setid, 
@@ -710,30 +744,27 @@ void CustomTimeSig::engrave(EngraverState& engraver) const
     {
         // get data
               Plate::pNote&  pnote       = engraver.get_target();
-        const Sprites&       sprites     = engraver.get_sprites();
         const mpx_t&         head_height = engraver.get_head_height();
         
         // set sprite
         pnote.sprite = this->sprite;
         
         // get sprite and position-offset
-        const SpriteInfo& spriteinfo = sprites[pnote.sprite]; // get sprite-info
-        const double scale = head_height /                    // calculate scale factor
-                             (sprites.head_height(pnote.sprite) * 1000.0);
+        const SpriteMetrics::Metrics& spriteinfo = engraver.get_metrics().get(pnote.sprite, head_height);   // get sprite metrics
         
         Position<mpx_t> anchor;                                        // anchor position
-        anchor.x = _round(spriteinfo.get_real("anchor.x") * scale * this->appearance.scale);
-        anchor.y = _round(spriteinfo.get_real("anchor.y") * scale * this->appearance.scale);
+        anchor.x = _round(spriteinfo.anchor_x * this->appearance.scale);
+        anchor.y = _round(spriteinfo.anchor_y * this->appearance.scale);
         
         // apply sprite-offset (x-offset applied by "apply_offsets()")
         pnote.absolutePos.front() -= anchor;
         pnote.absolutePos.front().y += _round(  (engraver.get_staff().line_count - 1) * head_height
-                                              - spriteinfo.height * scale * this->appearance.scale   ) / 2;
+                                              - spriteinfo.height * this->appearance.scale           ) / 2;
         
         // calculate graphical boundaries
         pnote.gphBox.pos = pnote.absolutePos.front();
-        pnote.gphBox.width = _round(spriteinfo.width * scale * this->appearance.scale);
-        pnote.gphBox.height = _round(spriteinfo.height * scale * this->appearance.scale);
+        pnote.gphBox.width = _round(spriteinfo.width * this->appearance.scale);
+        pnote.gphBox.height = _round(spriteinfo.height * this->appearance.scale);
         
         // break ties
         engraver.break_ties();
@@ -774,7 +805,6 @@ void Barline::engrave(EngraverState& engraver) const
     // get data
           Plate::pNote&  pnote       = engraver.get_target();
           Plate::pLine&  pline       = engraver.get_target_line();
-    const Sprites&       sprites     = engraver.get_sprites();
     const mpx_t&         head_height = engraver.get_head_height();
     //const EngraverParam& param       = engraver.get_parameters();
     const ViewportParam& viewport    = engraver.get_viewport();
@@ -794,7 +824,7 @@ void Barline::engrave(EngraverState& engraver) const
     // engrave barline
     std::list<Staff>::const_iterator i   = engraver.get_score().staves.begin();
     std::list<Staff>::const_iterator end = engraver.get_score().staves.end();
-    std::list<Plate::pVoice>::const_iterator pvoice = pline.get_voice(*i);
+    Plate::VoiceList::const_iterator pvoice = pline.get_voice(*i);
     pnote.absolutePos.front().y = pvoice->basePos.y;
     while (i != end)    // iterate the staves
     {
@@ -830,7 +860,7 @@ void Barline::engrave(EngraverState& engraver) const
     
     // calculate graphical boundaries
     pnote.gphBox.pos = pnote.absolutePos.front();
-    pnote.gphBox.width = Pick::width(sprites, this, head_height) * viewport.umtopx_h(engraver.get_style().bar_thickness);
+    pnote.gphBox.width = Pick::width(engraver.get_metrics(), this, head_height) * viewport.umtopx_h(engraver.get_style().bar_thickness);
     pnote.gphBox.extend(pnote.absolutePos.back());
     
     // warn about illegal barline style
@@ -847,7 +877,7 @@ void Barline::render(Renderer& renderer, const Plate::pNote& note, const PressSt
     const mpx_t width = state.viewport.umtopx_h(state.style->bar_thickness);
     
     renderer.set_line_width(0.0);
-    for (std::list< Position<mpx_t> >::const_iterator p = note.absolutePos.begin(); p != note.absolutePos.end(); ++p, ++p)
+    for (Plate::pNote::PositionList::const_iterator p = note.absolutePos.begin(); p != note.absolutePos.end(); ++p, ++p)
     {
         mpx_t x_offset = 0;
         for (std::string::const_iterator i  = this->style.begin(); i != this->style.end(); ++i)
@@ -1008,7 +1038,7 @@ static bool engrave_head(Head&          head,           // head to be engraved
     
     // add horizontal offset for close heads in the chord
     Position<mpx_t> unscaledPos(headPos);            // save unscaled pos for accidental
-    for (std::list< Position<mpx_t> >::iterator j = ++target.absolutePos.begin(); j != target.absolutePos.end(); ++j)
+    for (Plate::pNote::PositionList::iterator j = target.absolutePos.begin() + 1; j != target.absolutePos.end(); ++j)
     {
         // if the head is close to ours, and is not drawn on the other side of the stem
         if (((j->y - headPos.y > 0 && j->y - headPos.y < head_height)  ||
@@ -1026,7 +1056,7 @@ static bool engrave_head(Head&          head,           // head to be engraved
     
     // push position for head ("sprite_width < 0" implies downward stem, that means heads are inserted backwards)
     if (sprite_width >= 0) target.absolutePos.push_back(headPos);
-    else                   target.absolutePos.insert(++target.absolutePos.begin(), headPos);
+    else                   target.absolutePos.insert(target.absolutePos.begin() + 1, headPos);
     
     // move cluster to the right
     if (got_cluster && sprite_width < 0 && engraver.has_cluster_space())
@@ -1048,18 +1078,18 @@ static bool engrave_head(Head&          head,           // head to be engraved
         target.attached.back()->sprite = head.accidental.get_sprite(sprites);
         
         // get sprite and calculate scale factor
+        // (the sprite-info is used, since the scale factor includes the appearance scale, unlike the sprite metrics)
+        const SpriteMetrics& metrics = engraver.get_metrics().get(target.attached.back()->sprite.setid, head_height);
         const SpriteInfo& sprite = sprites[target.attached.back()->sprite];
-        double scale  = head_height /
-                        (sprites.head_height(target.attached.back()->sprite) * 1000.0);
-        double head_width = 1000.0 * scale * sprites.head_width(target.sprite);
-               scale *= head.accidental.appearance.scale / 1000.0;
+        const double head_width = 1000.0 * metrics.scale * sprites.head_width(target.sprite);
+        const double scale = metrics.scale * (head.accidental.appearance.scale / 1000.0);
         
         // calculate sprite position offset
         Position<mpx_t> anchor;                                 // anchor position instance
         mpx_t offset;                                           // default accidental offset (in pohw)
-        anchor.x = _round(sprite.get_real("anchor.x") * 1000 * scale);
-        anchor.y = _round(sprite.get_real("anchor.y") * 1000 * scale);
-        offset   = _round(sprite.get_real("offset") * 1000 * scale);
+        anchor.x = _round(sprite.get_real(ATOM_ANCHOR_X) * 1000 * scale);
+        anchor.y = _round(sprite.get_real(ATOM_ANCHOR_Y) * 1000 * scale);
+        offset   = _round(sprite.get_real(ATOM_OFFSET) * 1000 * scale);
         
         // apply position offset
         target.attached.back()->absolutePos.x -= _round((head.accidental.offset_x * head_width) / 1000.0);
@@ -1151,33 +1181,31 @@ void Chord::engrave(EngraverState& engraver) const
     
     // get sprite
     pnote.sprite = this->get_sprite(sprites);
-    const SpriteInfo& headsprite = sprites[pnote.sprite];    // get sprite-info
+    const SpriteMetrics& metrics = engraver.get_metrics().get(pnote.sprite.setid, head_height);
+    const SpriteMetrics::Metrics& headsprite = metrics[pnote.sprite.spriteid];  // get sprite metrics
     
     // calculate scale factors
-    const double scale = head_height / (sprites.head_height(pnote.sprite) * 1000.0);
+    const double scale = metrics.scale;
     const double chord_scale = this->appearance.scale / 1000.0;
     
     // get sprite attributes
     Position<mpx_t> anchor;                  // anchor position
     Position<mpx_t> stempos;                 // stem position
-    anchor.x = _round(headsprite.get_real("anchor.x") * scale * this->appearance.scale);
-    anchor.y = _round(headsprite.get_real("anchor.y") * scale * this->appearance.scale);
-    stempos.x = _round(headsprite.get_real("stem.x") * scale * this->appearance.scale);
-    stempos.y = _round(headsprite.get_real("stem.y") * scale * this->appearance.scale);
+    anchor.x = _round(headsprite.anchor_x * this->appearance.scale);
+    anchor.y = _round(headsprite.anchor_y * this->appearance.scale);
+    stempos.x = _round(headsprite.stem_x * this->appearance.scale);
+    stempos.y = _round(headsprite.stem_y * this->appearance.scale);
     
     // get dot sprite and distance
-    const SpriteInfo& dotsprite =
-        (sprites[pnote.sprite.setid].dot != UNDEFINED) ?
-            sprites[pnote.sprite.setid][sprites[pnote.sprite.setid].dot] :
-            sprites[pnote.sprite.setid][sprites[pnote.sprite.setid].undefined_symbol];
+    const SpriteMetrics::Metrics& dotsprite = metrics[sprites[pnote.sprite.setid].dot];
     
     Position<mpx_t> dotanchor;  // anchor position
     mpx_t dotdistance = 0;      // dot distance
     if (this->val.dots)         // only get dot-attributes, if there are dots to be engraved
     {
-        dotanchor.x = _round(dotsprite.get_real("anchor.x") * scale * this->appearance.scale);
-        dotanchor.y = _round(dotsprite.get_real("anchor.y") * scale * this->appearance.scale);
-        dotdistance = _round(dotsprite.get_real("distance") * scale * this->appearance.scale);
+        dotanchor.x = _round(dotsprite.anchor_x * this->appearance.scale);
+        dotanchor.y = _round(dotsprite.anchor_y * this->appearance.scale);
+        dotdistance = _round(dotsprite.distance * this->appearance.scale);
     };
     
     // engrave
@@ -1189,8 +1217,8 @@ void Chord::engrave(EngraverState& engraver) const
     
     const mpx_t stem_width = viewport.umtopx_h(style.stem_width);
     const mpx_t stem_len = (calculate_stem_length(engraver.get_visual_staff(), engraver.get_voice(), gph_context, style) * head_height) / 1000;
-    const mpx_t sprite_width = _round(headsprite.width * scale * this->appearance.scale);
-    const double head_width = sprites.head_width(pnote.sprite) * scale * 1000.0;
+    const mpx_t sprite_width = _round(headsprite.width * this->appearance.scale);
+    const double head_width = metrics.head_width * 1000.0;
     
     // engrave heads
     if (stem_len >= 0)    // upward stem
@@ -1221,12 +1249,12 @@ void Chord::engrave(EngraverState& engraver) const
             if (i == this->heads.begin())
                 pnote.gphBox = Plate::GphBox(
                     pnote.absolutePos.back(),
-                    _round(headsprite.width * scale * chord_scale * (*i)->appearance.scale),
+                    _round(headsprite.width * chord_scale * (*i)->appearance.scale),
                     _round((head_height * chord_scale * (*i)->appearance.scale) / 1000.0));
             else
                 pnote.gphBox.extend(Plate::GphBox(
                     pnote.absolutePos.back(),
-                    _round(headsprite.width * scale * chord_scale * (*i)->appearance.scale),
+                    _round(headsprite.width * chord_scale * (*i)->appearance.scale),
                     _round((head_height * chord_scale * (*i)->appearance.scale) / 1000.0)));
             
             // check for edge-heads
@@ -1296,16 +1324,16 @@ void Chord::engrave(EngraverState& engraver) const
             stem_info.cluster |= _cluster;      // memorize cluster occurance for stem engraver
             
             // calculate graphical boundaries
-            const Position<mpx_t>& newpos = *++pnote.absolutePos.begin(); // position of new head
+            const Position<mpx_t>& newpos = pnote.absolutePos[1];         // position of new head
             if (i == this->heads.rbegin())
                 pnote.gphBox = Plate::GphBox(
                     newpos,
-                    _round(headsprite.width * scale * chord_scale * (*i)->appearance.scale),
+                    _round(headsprite.width * chord_scale * (*i)->appearance.scale),
                     _round((head_height  * chord_scale * (*i)->appearance.scale) / 1000.0));
             else
                 pnote.gphBox.extend(Plate::GphBox(
                     newpos,
-                    _round(headsprite.width * scale * chord_scale * (*i)->appearance.scale),
+                    _round(headsprite.width * chord_scale * (*i)->appearance.scale),
                     _round((head_height  * chord_scale * (*i)->appearance.scale) / 1000.0)));
             
             // check for edge-heads
@@ -1366,7 +1394,7 @@ void Chord::engrave(EngraverState& engraver) const
         
         pnote.stem.top = stem_info.top_pos + head_height / 2 - stem_len;
         pnote.stem.base = stem_info.base_pos + (stem_info.base_side ?
-            _round(((headsprite.height * scale * this->appearance.scale - stempos.y) * stem_info.base_scale) / 1000.0) :
+            _round(((headsprite.height * this->appearance.scale - stempos.y) * stem_info.base_scale) / 1000.0) :
             stempos.y);
     }
     else                // downward stems are placed left of the chord
@@ -1377,23 +1405,23 @@ void Chord::engrave(EngraverState& engraver) const
         pnote.stem.top = stem_info.base_pos + head_height / 2 - stem_len;
         pnote.stem.base = stem_info.top_pos + (stem_info.top_side ?
             stempos.y :
-            _round(((headsprite.height * scale * this->appearance.scale - stempos.y) * stem_info.top_scale) / 1000.0));
+            _round(((headsprite.height * this->appearance.scale - stempos.y) * stem_info.top_scale) / 1000.0));
     };
     pnote.gphBox.extend(Position<mpx_t>(pnote.stem.x, pnote.stem.top));
     
     // engrave dots
     {
-    std::list< Position<mpx_t> >::iterator p;
+    Plate::pNote::PositionList::iterator p;
     for (unsigned char j = 0; j < this->val.dots; ++j)
     {
-        p = ++pnote.absolutePos.begin();
+        p = pnote.absolutePos.begin() + 1;
         for (HeadList::const_iterator i = this->heads.begin(); i != this->heads.end(); ++i, ++p)
         {
             pnote.dotPos.push_back(
                 Position<mpx_t>(
                   _round(pnote.gphBox.right()
                           + dotdistance + ((*i)->dot_offset.x * head_width) / 1000.0   // offset
-                          + j * (dotdistance + dotsprite.width * scale * this->appearance.scale)
+                          + j * (dotdistance + dotsprite.width * this->appearance.scale)
                           - dotanchor.x),               // anchor | [above]: dot distance
                   _round(p->y
                           + ((*i)->dot_offset.y * head_height) / 1000.0 // offset
@@ -1462,7 +1490,7 @@ void Chord::engrave(EngraverState& engraver) const
     
     // engrave ties (from previous note)
     {
-    std::list< Position<mpx_t> >::iterator p = ++pnote.absolutePos.begin();
+    Plate::pNote::PositionList::iterator p = pnote.absolutePos.begin() + 1;
     for (HeadList::const_iterator i = this->heads.begin(); i != this->heads.end(); ++i, ++p)
     {
         if (!engraver.has_tie(**i)) continue;
@@ -1495,8 +1523,9 @@ void Chord::engrave(EngraverState& engraver) const
     // engrave ties (on this note)
     {
     engraver.erase_tieinfo();                // erase tie-information (for the voice)
+    pnote.ties.reserve(pnote.ties.size() + this->heads.size());                // (the tie-information refers to the ties)
     HeadList::const_iterator head = this->heads.begin();                       // setup head iterator
-    std::list< Position<mpx_t> >::iterator hpos = ++pnote.absolutePos.begin(); // setup head-position iterator
+    Plate::pNote::PositionList::iterator hpos = pnote.absolutePos.begin() + 1; // setup head-position iterator
     const TiedHead* thead;
     while (head != this->heads.end() && hpos != pnote.absolutePos.end())       // for each head
     {
@@ -1509,7 +1538,7 @@ void Chord::engrave(EngraverState& engraver) const
             
             // base position
             pnote.ties.back().pos1.x = _round(hpos->x
-                                               + headsprite.width * scale * this->appearance.scale
+                                               + headsprite.width * this->appearance.scale
                                                + (thead->offset1.x * head_height) / 1000.0);
             pnote.ties.back().pos1.y = _round(hpos->y
                                                + (thead->offset1.y * head_height) / 1000.0)
@@ -1545,9 +1574,9 @@ void Chord::engrave(EngraverState& engraver) const
                                                     SpriteId(0, sprites[0].undefined_symbol)];
         
         // get sprite anchor
-        artanchor.x = _round(artsprite.get_real("anchor.x") * scale * this->appearance.scale);
-        artanchor.y = _round(artsprite.get_real("anchor.y") * scale * this->appearance.scale);
-        artoffset   = _round(artsprite.get_real("offset") * scale * this->appearance.scale);
+        artanchor.x = _round(artsprite.get_real(ATOM_ANCHOR_X) * scale * this->appearance.scale);
+        artanchor.y = _round(artsprite.get_real(ATOM_ANCHOR_Y) * scale * this->appearance.scale);
+        artoffset   = _round(artsprite.get_real(ATOM_OFFSET) * scale * this->appearance.scale);
         
         // create attachable
         pnote.attached.push_back(
@@ -1555,7 +1584,7 @@ void Chord::engrave(EngraverState& engraver) const
                 new Plate::pAttachable(*i,  // articulation object
                     Position<mpx_t>(        // calculate position
                         _round(   pnote.absolutePos.begin()->x
-                                + headsprite.width * scale * chord_scale * 500
+                                + headsprite.width * chord_scale * 500
                                 - (artanchor.x * i->appearance.scale) / 1000.0),
                         (stem_len >= 0) ?
                             // upward stem and far symbol (i.e. on top of the stem)
@@ -1615,7 +1644,7 @@ void Chord::engrave(EngraverState& engraver) const
                 sprites[pnote.sprite.setid][sprites[pnote.sprite.setid].flags_note] :
                 sprites[pnote.sprite.setid][sprites[pnote.sprite.setid].undefined_symbol];
         
-        mpx_t flag_width = _round(    (flagsprite.width - flagsprite.get_real("anchor.x"))
+        mpx_t flag_width = _round(    (flagsprite.width - flagsprite.get_real(ATOM_ANCHOR_X))
                                     * scale * this->appearance.scale);
         
         // extend graphical boundary box
@@ -1631,7 +1660,7 @@ void Chord::render(Renderer& renderer, const Plate::pNote& note, const PressStat
     
     // render heads (count from 1, because the first position is the offset of the whole chord)
     HeadList::const_iterator h = this->heads.begin();
-    for (Plate::pNote::PositionList::const_iterator p = ++note.absolutePos.begin(); p != note.absolutePos.end(); ++p, ++h)
+    for (Plate::pNote::PositionList::const_iterator p = note.absolutePos.begin() + 1; p != note.absolutePos.end(); ++p, ++h)
     {
         renderer.set_color((*h)->appearance.color.r, (*h)->appearance.color.g, (*h)->appearance.color.b, (*h)->appearance.color.a);
         renderer.draw_sprite(note.sprite,
@@ -1645,7 +1674,7 @@ void Chord::render(Renderer& renderer, const Plate::pNote& note, const PressStat
     renderer.set_color(appearance.color.r, appearance.color.g, appearance.color.b, appearance.color.a);
     
     // render dots
-    for (std::list< Position<mpx_t> >::const_iterator p = note.dotPos.begin(); p != note.dotPos.end(); ++p)
+    for (Plate::pNote::DotList::const_iterator p = note.dotPos.begin(); p != note.dotPos.end(); ++p)
     {
         renderer.draw_sprite(
             SpriteId(note.sprite.setid,
@@ -1721,38 +1750,38 @@ void Chord::render_beam(Renderer& renderer, const Plate::pNote& note, const Pres
     renderer.set_line_width(state.parameters.scale / 1000.0);   // set line width
     for (short i = 0; i < VALUE_BASE - 2; i++)                 // iterate through the beams, beginning at this note
     {
-        if (note.beam[VALUE_BASE - 3 - i] == NULL) continue;    // check if a beam is to be drawn
+        if (note.beam[VALUE_BASE - 3 - i].end == NULL) continue;    // check if a beam is to be drawn
         
         // calculate vertical offset (front)
         yoffset = state.scale(state.style->beam_height + state.style->beam_distance)
                     * i * state.head_height / 1000.0;
         
-        if (note.beam[VALUE_BASE - 3 - i]->short_beam)  // if the beam is short
+        if (note.beam[VALUE_BASE - 3 - i].short_beam)  // if the beam is short
         {
             // calculate vertical offset (back)
-            if ((note.beam[VALUE_BASE - 3 - i]->end->stem.top < note.beam[VALUE_BASE - 3 - i]->end->stem.base) ^ (note.stem.top < note.stem.base))
+            if ((note.beam[VALUE_BASE - 3 - i].end->stem.top < note.beam[VALUE_BASE - 3 - i].end->stem.base) ^ (note.stem.top < note.stem.base))
                 yoffset_end =
                     state.scale(
                         (state.style->beam_height + state.style->beam_distance)
-                        * (static_cast<double>(note.stem.beam_off + note.beam[VALUE_BASE - 3 - i]->end->stem.beam_off)
-                                 - note.beam[VALUE_BASE - 3 - i]->end_idx)
+                        * (static_cast<double>(note.stem.beam_off + note.beam[VALUE_BASE - 3 - i].end->stem.beam_off)
+                                 - note.beam[VALUE_BASE - 3 - i].end_idx)
                         + state.style->beam_height
                     )
                     * state.head_height / 1000.0;
             else
                 yoffset_end = state.scale(state.style->beam_height + state.style->beam_distance)
-                            * note.beam[VALUE_BASE - 3 - i]->end_idx * state.head_height / 1000.0;
+                            * note.beam[VALUE_BASE - 3 - i].end_idx * state.head_height / 1000.0;
             
             // render the short beam
             double length = head_width * state.style->shortbeam_length; // calculate the length (i.e. width of the short beam)
-            if (abs_less((note.beam[VALUE_BASE - 3 - i]->end->stem.x - note.stem.x) * static_cast<int>(state.style->shortbeam_short), length))
-                length = (note.beam[VALUE_BASE - 3 - i]->end->stem.x - note.stem.x) * static_cast<int>(state.style->shortbeam_short);
-            if ((length < 0) ^ note.beam[VALUE_BASE - 3 - i]->short_left) length = -length;
+            if (abs_less((note.beam[VALUE_BASE - 3 - i].end->stem.x - note.stem.x) * static_cast<int>(state.style->shortbeam_short), length))
+                length = (note.beam[VALUE_BASE - 3 - i].end->stem.x - note.stem.x) * static_cast<int>(state.style->shortbeam_short);
+            if ((length < 0) ^ note.beam[VALUE_BASE - 3 - i].short_left) length = -length;
             length = state.scale(length) / 1000.0;
             
-            const double x0 = state.scale(note.beam[VALUE_BASE - 3 - i]->end->stem.x) + state.offset.x;
-            const double y0 = state.scale(note.beam[VALUE_BASE - 3 - i]->end->stem.top) + state.offset.y
-                            + (  (note.beam[VALUE_BASE - 3 - i]->end->stem.top < note.beam[VALUE_BASE - 3 - i]->end->stem.base)
+            const double x0 = state.scale(note.beam[VALUE_BASE - 3 - i].end->stem.x) + state.offset.x;
+            const double y0 = state.scale(note.beam[VALUE_BASE - 3 - i].end->stem.top) + state.offset.y
+                            + (  (note.beam[VALUE_BASE - 3 - i].end->stem.top < note.beam[VALUE_BASE - 3 - i].end->stem.base)
                                ? yoffset_end : -yoffset_end);
             const double x1 = state.scale(note.stem.x) + state.offset.x;
             const double y1 = state.scale(note.stem.top) + state.offset.y + ((note.stem.top < note.stem.base) ? yoffset : -yoffset);
@@ -1780,7 +1809,7 @@ void Chord::render_beam(Renderer& renderer, const Plate::pNote& note, const Pres
         {
             // calculate vertical offset (back)
             yoffset_end = state.scale(state.style->beam_height + state.style->beam_distance)
-                        * note.beam[VALUE_BASE - 3 - i]->end_idx * state.head_height / 1000.0;
+                        * note.beam[VALUE_BASE - 3 - i].end_idx * state.head_height / 1000.0;
             
             // render beam
             if (note.stem.top < note.stem.base) // upward stem
@@ -1798,19 +1827,19 @@ void Chord::render_beam(Renderer& renderer, const Plate::pNote& note, const Pres
                                  (state.scale(note.stem.top) + state.offset.y - yoffset) / 1000.0);
             };
             
-            if (note.beam[VALUE_BASE - 3 - i]->end->stem.top < note.beam[VALUE_BASE - 3 - i]->end->stem.base)   // upward stem
+            if (note.beam[VALUE_BASE - 3 - i].end->stem.top < note.beam[VALUE_BASE - 3 - i].end->stem.base)   // upward stem
             {
-                renderer.line_to((state.scale(note.beam[VALUE_BASE - 3 - i]->end->stem.x) + state.offset.x) / 1000.0,
-                                 (state.scale(note.beam[VALUE_BASE - 3 - i]->end->stem.top) + state.offset.y + yoffset_end + beam_height) / 1000.0);
-                renderer.line_to((state.scale(note.beam[VALUE_BASE - 3 - i]->end->stem.x) + state.offset.x) / 1000.0,
-                                 (state.scale(note.beam[VALUE_BASE - 3 - i]->end->stem.top) + state.offset.y + yoffset_end) / 1000.0);
+                renderer.line_to((state.scale(note.beam[VALUE_BASE - 3 - i].end->stem.x) + state.offset.x) / 1000.0,
+                                 (state.scale(note.beam[VALUE_BASE - 3 - i].end->stem.top) + state.offset.y + yoffset_end + beam_height) / 1000.0);
+                renderer.line_to((state.scale(note.beam[VALUE_BASE - 3 - i].end->stem.x) + state.offset.x) / 1000.0,
+                                 (state.scale(note.beam[VALUE_BASE - 3 - i].end->stem.top) + state.offset.y + yoffset_end) / 1000.0);
             }
             else                                                                                                // downward stem
             {
-                renderer.line_to((state.scale(note.beam[VALUE_BASE - 3 - i]->end->stem.x) + state.offset.x) / 1000.0,
-                                 (state.scale(note.beam[VALUE_BASE - 3 - i]->end->stem.top) + state.offset.y - yoffset_end) / 1000.0);
-                renderer.line_to((state.scale(note.beam[VALUE_BASE - 3 - i]->end->stem.x) + state.offset.x) / 1000.0,
-                                 (state.scale(note.beam[VALUE_BASE - 3 - i]->end->stem.top) + state.offset.y - yoffset_end - beam_height) / 1000.0);
+                renderer.line_to((state.scale(note.beam[VALUE_BASE - 3 - i].end->stem.x) + state.offset.x) / 1000.0,
+                                 (state.scale(note.beam[VALUE_BASE - 3 - i].end->stem.top) + state.offset.y - yoffset_end) / 1000.0);
+                renderer.line_to((state.scale(note.beam[VALUE_BASE - 3 - i].end->stem.x) + state.offset.x) / 1000.0,
+                                 (state.scale(note.beam[VALUE_BASE - 3 - i].end->stem.top) + state.offset.y - yoffset_end - beam_height) / 1000.0);
             }
             
             renderer.fill();    // close and fill the path
@@ -1818,13 +1847,13 @@ void Chord::render_beam(Renderer& renderer, const Plate::pNote& note, const Pres
     };
     
     /*
-    if (note.beam[VALUE_BASE - 3])
+    if (note.beam[VALUE_BASE - 3].end)
     {
         renderer.set_color(255, 0, 0, 255);
         renderer.move_to((scale(note.stem.x) + offset.x) / 1000.0,
                          (scale(note.stem.top) + offset.y) / 1000.0);
-        renderer.line_to((scale(note.beam[VALUE_BASE - 3]->end->stem.x) + offset.x) / 1000.0,
-                         (scale(note.beam[VALUE_BASE - 3]->end->stem.top) + offset.y) / 1000.0);
+        renderer.line_to((scale(note.beam[VALUE_BASE - 3].end->stem.x) + offset.x) / 1000.0,
+                         (scale(note.beam[VALUE_BASE - 3].end->stem.top) + offset.y) / 1000.0);
         renderer.stroke();
         renderer.set_color(0, 0, 0, 255);
     };
@@ -1858,10 +1887,10 @@ void Chord::render_beam(Renderer& renderer, const Plate::pNote& note, const Pres
         
         // calculate sprite position offset
         Position<mpx_t> flag_anchor;            // flag-anchor position
-        if (info.real.find("anchor.x") != info.real.end())  // get "anchor" attribute
-            flag_anchor.x = _round(info.real.find("anchor.x")->second * 1000);
-        if (info.real.find("anchor.y") != info.real.end())
-            flag_anchor.y = _round(info.real.find("anchor.y")->second * 1000);
+        if (info.real.find(ATOM_ANCHOR_X) != info.real.end())  // get "anchor" attribute
+            flag_anchor.x = _round(info.real.find(ATOM_ANCHOR_X)->second * 1000);
+        if (info.real.find(ATOM_ANCHOR_Y) != info.real.end())
+            flag_anchor.y = _round(info.real.find(ATOM_ANCHOR_Y)->second * 1000);
         
         // get sprite for overlayed flag
         SpriteId overlay_flag_id = SpriteId(    // get sprite id
@@ -1870,8 +1899,8 @@ void Chord::render_beam(Renderer& renderer, const Plate::pNote& note, const Pres
         
         // get flag distance
         mpx_t flag_distance = 0;        // flag-distance
-        if (info.real.find("distance") != info.real.end())
-            flag_distance = _round(info.real.find("distance")->second * 1000);
+        if (info.real.find(ATOM_DISTANCE) != info.real.end())
+            flag_distance = _round(info.real.find(ATOM_DISTANCE)->second * 1000);
         
         // render flags
         for (int i = 0; i < VALUE_BASE - 2 - this->val.exp; i++)
@@ -1947,13 +1976,12 @@ void Rest::engrave(EngraverState& engraver) const
     
     // get sprite and position-offset
     pnote.sprite = this->get_sprite(sprites);
-    const SpriteInfo& restsprite = sprites[pnote.sprite];  // get sprite-info
-    const double scale = head_height /                     // calculate scale factor
-                         (sprites.head_height(pnote.sprite) * 1000.0);
+    const SpriteMetrics& metrics = engraver.get_metrics().get(pnote.sprite.setid, head_height);
+    const SpriteMetrics::Metrics& restsprite = metrics[pnote.sprite.spriteid];  // get sprite metrics
     
-    const mpx_t sprite_width = _round(restsprite.width * scale * this->appearance.scale);
-    const mpx_t sprite_height = _round(restsprite.height * scale * this->appearance.scale);
-    const double head_width = sprites.head_width(pnote.sprite) * scale * 1000.0;
+    const mpx_t sprite_width = _round(restsprite.width * this->appearance.scale);
+    const mpx_t sprite_height = _round(restsprite.height * this->appearance.scale);
+    const double head_width = metrics.head_width * 1000.0;
     
     Position<mpx_t> anchor;        // anchor position
     int baseline = 0;              // base line
@@ -1961,28 +1989,25 @@ void Rest::engrave(EngraverState& engraver) const
     mpx_t minlen = head_height;    // stem length
     mpx_t stembottomx1 = 0;        // stem bottom position (left horizontal)
     
-    anchor.x = _round(restsprite.get_real("anchor.x") * scale * this->appearance.scale);
-    anchor.y = _round(restsprite.get_real("anchor.y") * scale * this->appearance.scale);
-    baseline = restsprite.get_integer("line");
-    slope    = _round(restsprite.get_real("stem.slope") * scale * this->appearance.scale);
-    minlen   = _round(restsprite.get_real("stem.minlen") * scale * this->appearance.scale);
-    stembottomx1 = _round(restsprite.get_real("stem.bottom.x1") * scale * this->appearance.scale);
+    anchor.x = _round(restsprite.anchor_x * this->appearance.scale);
+    anchor.y = _round(restsprite.anchor_y * this->appearance.scale);
+    baseline = restsprite.line;
+    slope    = _round(restsprite.stem_slope * this->appearance.scale);
+    minlen   = _round(restsprite.stem_minlen * this->appearance.scale);
+    stembottomx1 = _round(restsprite.stem_bottom_x1 * this->appearance.scale);
     
     // get dot sprite and distance
-    const SpriteInfo& dotsprite =
-        (sprites[pnote.sprite.setid].dot != UNDEFINED) ?
-            sprites[pnote.sprite.setid][sprites[pnote.sprite.setid].dot] :
-            sprites[pnote.sprite.setid][sprites[pnote.sprite.setid].undefined_symbol];
+    const SpriteMetrics::Metrics& dotsprite = metrics[sprites[pnote.sprite.setid].dot];
     
     Position<mpx_t> dotanchor;  // anchor position
     mpx_t dotdistance = 0;      // dot distance
     mpx_t dotoffset = 0;        // dot offset (in promille of head-width)
     if (this->val.dots > 0)     // only get dot-attributes, if there are dots to be engraved
     {
-        dotanchor.x = _round(dotsprite.get_real("anchor.x") * scale * this->appearance.scale);
-        dotanchor.y = _round(dotsprite.get_real("anchor.y") * scale * this->appearance.scale);
-        dotdistance = _round(dotsprite.get_real("distance") * scale * this->appearance.scale);
-        dotoffset   = _round(dotsprite.get_real("offset") * scale * this->appearance.scale);
+        dotanchor.x = _round(dotsprite.anchor_x * this->appearance.scale);
+        dotanchor.y = _round(dotsprite.anchor_y * this->appearance.scale);
+        dotdistance = _round(dotsprite.distance * this->appearance.scale);
+        dotoffset   = _round(dotsprite.offset * this->appearance.scale);
     };
     
     // apply sprite-offset (x-offset applied by "apply_offsets()")
@@ -2022,7 +2047,7 @@ void Rest::engrave(EngraverState& engraver) const
         pnote.gphBox.height = 0;
         
         // adjust vertical flag-positions
-        for (std::list< Position<mpx_t> >::iterator i = pnote.absolutePos.begin(); i != --pnote.absolutePos.end(); ++i)
+        for (Plate::pNote::PositionList::iterator i = pnote.absolutePos.begin(); i != pnote.absolutePos.end() - 1; ++i)
         {
             i->x += _round(slope * (static_cast<double>(pnote.absolutePos.back().y - i->y) / (pnote.absolutePos.back().y - pnote.absolutePos.front().y)) - 1000);
             
@@ -2042,7 +2067,7 @@ void Rest::engrave(EngraverState& engraver) const
                 _round(
                    pnote.gphBox.right()
                  + dotoffset + (this->dot_offset.x * head_width) / 1000.0   // offset
-                 + j * (dotdistance + dotsprite.width * scale    // dot distance
+                 + j * (dotdistance + dotsprite.width            // dot distance
                                       * this->appearance.scale)
                  - dotanchor.x),                   // anchor
                 _round(
@@ -2070,7 +2095,7 @@ void Rest::render(Renderer& renderer, const Plate::pNote& note, const PressState
     if (this->val.exp < VALUE_BASE - 2)
     {
         // draw all flags
-        for (Plate::pNote::PositionList::const_iterator p = note.absolutePos.begin(); p != --note.absolutePos.end(); ++p)
+        for (Plate::pNote::PositionList::const_iterator p = note.absolutePos.begin(); p != note.absolutePos.end() - 1; ++p)
         {
             renderer.draw_sprite(note.sprite,
                                  (state.scale(p->x) + state.offset.x) / 1000.0,
@@ -2094,14 +2119,14 @@ void Rest::render(Renderer& renderer, const Plate::pNote& note, const PressState
         // draw stem
         const SpriteInfo& info = renderer.get_sprites()[note.sprite];
         renderer.set_line_width(state.stem_width * sprite_scale);         // set line width
-        renderer.move_to((state.scale(note.absolutePos.front().x) + state.offset.x) / 1000.0 + info.real.find("stem.top.x1")->second    * app_scale,
-                         (state.scale(note.absolutePos.front().y) + state.offset.y) / 1000.0 + info.real.find("stem.top.y1")->second    * app_scale);
-        renderer.line_to((state.scale(note.absolutePos.front().x) + state.offset.x) / 1000.0 + info.real.find("stem.top.x2")->second    * app_scale,
-                         (state.scale(note.absolutePos.front().y) + state.offset.y) / 1000.0 + info.real.find("stem.top.y2")->second    * app_scale);
-        renderer.line_to((state.scale(note.absolutePos.back().x)  + state.offset.x) / 1000.0 + info.real.find("stem.bottom.x2")->second * app_scale,
-                         (state.scale(note.absolutePos.back().y)  + state.offset.y) / 1000.0 + info.real.find("stem.bottom.y2")->second * app_scale);
-        renderer.line_to((state.scale(note.absolutePos.back().x)  + state.offset.x) / 1000.0 + info.real.find("stem.bottom.x1")->second * app_scale,
-                         (state.scale(note.absolutePos.back().y)  + state.offset.y) / 1000.0 + info.real.find("stem.bottom.y1")->second * app_scale);
+        renderer.move_to((state.scale(note.absolutePos.front().x) + state.offset.x) / 1000.0 + info.get_real(ATOM_STEM_TOP_X1)    * app_scale,
+                         (state.scale(note.absolutePos.front().y) + state.offset.y) / 1000.0 + info.get_real(ATOM_STEM_TOP_Y1)    * app_scale);
+        renderer.line_to((state.scale(note.absolutePos.front().x) + state.offset.x) / 1000.0 + info.get_real(ATOM_STEM_TOP_X2)    * app_scale,
+                         (state.scale(note.absolutePos.front().y) + state.offset.y) / 1000.0 + info.get_real(ATOM_STEM_TOP_Y2)    * app_scale);
+        renderer.line_to((state.scale(note.absolutePos.back().x)  + state.offset.x) / 1000.0 + info.get_real(ATOM_STEM_BOTTOM_X2) * app_scale,
+                         (state.scale(note.absolutePos.back().y)  + state.offset.y) / 1000.0 + info.get_real(ATOM_STEM_BOTTOM_Y2) * app_scale);
+        renderer.line_to((state.scale(note.absolutePos.back().x)  + state.offset.x) / 1000.0 + info.get_real(ATOM_STEM_BOTTOM_X1) * app_scale,
+                         (state.scale(note.absolutePos.back().y)  + state.offset.y) / 1000.0 + info.get_real(ATOM_STEM_BOTTOM_Y1) * app_scale);
         renderer.fill();
         renderer.stroke();
     }
@@ -2117,7 +2142,7 @@ void Rest::render(Renderer& renderer, const Plate::pNote& note, const PressState
     };
     
     // render dots
-    for (std::list< Position<mpx_t> >::const_iterator p = note.dotPos.begin(); p != note.dotPos.end(); ++p)
+    for (Plate::pNote::DotList::const_iterator p = note.dotPos.begin(); p != note.dotPos.end(); ++p)
     {
         renderer.draw_sprite(
             SpriteId(note.sprite.setid,
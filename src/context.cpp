@@ -18,6 +18,8 @@
   permissions and limitations under the Licence.
 */
 
+#include <type_traits>  // std::is_trivially_copyable
+
 #include "context.hh"    // Context, [score classes]
 
 using namespace ScorePress;
@@ -41,10 +43,14 @@ static const int tone_off[7]  = {0, 2, 4, 5, 7, 9, 11};  // inverse array to who
 //
 
 
+static_assert(std::is_trivially_copyable<VoiceContext>::value, "The voice-context has to be copyable by value.");
+
 // default voice-context (full volume, 85% value modifier, 4/4 time-signature)
 VoiceContext::VoiceContext() : _volume(127),
                                _value_modifier(850),
-                               _time_sig(),
+                               _time_number(4),
+                               _time_beat(4),
+                               _time_appearance(),
                                _time_time(0),
                                _time_bar(0) {
                                _buffer.object = NULL;
@@ -52,15 +58,15 @@ VoiceContext::VoiceContext() : _volume(127),
                                _buffer2.object = NULL;
                                _buffer2.xpos = 0;}
 
-// copy constructor
-VoiceContext::VoiceContext(const VoiceContext& context) : 
-                               _volume(context._volume),
-                               _value_modifier(context._value_modifier),
-                               _time_sig(context._time_sig),
-                               _time_time(context._time_time),
-                               _time_bar(context._time_bar),
-                               _buffer(context._buffer),
-                               _buffer2(context._buffer2) {}
+// create a copy of the last time-signature (without attached objects)
+TimeSig VoiceContext::last_timesig() const
+{
+    TimeSig timesig;
+    timesig.number = _time_number;
+    timesig.beat = _time_beat;
+    timesig.appearance = _time_appearance;
+    return timesig;
+}
 
 // let the context-changing instance change this context
 void VoiceContext::modify(const ContextChanging& changer, bool vol)
@@ -80,9 +86,25 @@ void VoiceContext::modify(const ContextChanging& changer, bool vol)
 // set new time-signature
 void VoiceContext::modify(const TimeSig& timesig, value_t time)
 {
-    _time_bar += ((time - _time_time) / _time_sig.beat_length()).i();   // calculate current bar
-    _time_sig = timesig;   // save new time-signature
-    _time_time = time;     // save current time
+    _time_bar += ((time - _time_time) / beat_length()).i();   // calculate current bar
+    _time_number = timesig.number;          // save new time-signature
+    _time_beat = timesig.beat;
+    _time_appearance = timesig.appearance;
+    _time_time = time;                      // save current time
+}
+
+// compare with another voice-context (including the last object, but not the next-to-last,
+// which may be a virtual object and is dropped anyway, when the context is inherited by the next line)
+bool VoiceContext::operator == (const VoiceContext& context) const
+{
+    return    _volume          == context._volume
+           && _value_modifier  == context._value_modifier
+           && _time_number     == context._time_number
+           && _time_beat       == context._time_beat
+           && _time_time       == context._time_time
+           && _time_bar        == context._time_bar
+           && _buffer.object   == context._buffer.object
+           && (!_buffer.object  || _buffer.xpos  == context._buffer.xpos);
 }
 
 
@@ -105,22 +127,66 @@ StaffContext::IllegalAccidentalException::IllegalAccidentalException()
 StaffContext::IllegalKeyException::IllegalKeyException()
             : Error("Found illegal key-signature.") {}
 
+const size_t StaffContext::ACCIDENTAL_COUNT;
+
+static_assert(std::is_trivially_copyable<StaffContext>::value, "The staff-context has to be copyable by value.");
+
 // default staff-context (treble clef, C major key)
-StaffContext::StaffContext() : _clef(), _key(),
+StaffContext::StaffContext() : _clef_sprite(),
+                               _clef_base(67),
+                               _clef_line(5),
+                               _keybnd_sharp(69),
+                               _keybnd_flat(65),
+                               _clef_appearance(),
                                _base_note(76),
-                               _key_acc(0x0000) {}
+                               _key_type(Key::SHARP),
+                               _key_number(0),
+                               _key_sprite(),
+                               _key_appearance(),
+                               _key_acc(0x0000),
+                               _acc_generation(1),
+                               _acc_generations(),
+                               _accidentals() {}
+
+// invalidate all memorized accidentals (on the overflow of the generation)
+void StaffContext::clear_acc() noexcept
+{
+    for (size_t i = 0; i < ACCIDENTAL_COUNT; ++i)
+        _acc_generations[i] = 0;
+    _acc_generation = 1;
+}
 
-// copy constructor
-StaffContext::StaffContext(const StaffContext& context) : _clef(context._clef),
-                                                          _key(context._key),
-                                                          _base_note(context._base_note),
-                                                          _key_acc(context._key_acc),
-                                                          _accidentals(context._accidentals) {}
+// create a copy of the last clef (without attached objects)
+Clef StaffContext::last_clef() const
+{
+    Clef clef;
+    clef.sprite = _clef_sprite;
+    clef.base_note = _clef_base;
+    clef.line = _clef_line;
+    clef.keybnd_sharp = _keybnd_sharp;
+    clef.keybnd_flat = _keybnd_flat;
+    clef.appearance = _clef_appearance;
+    return clef;
+}
+
+// create a copy of the last key (without attached objects)
+Key StaffContext::last_key() const
+{
+    Key key;
+    key.type = _key_type;
+    key.number = _key_number;
+    key.sprite = _key_sprite;
+    key.appearance = _key_appearance;
+    return key;
+}
 
 // set new key
 void StaffContext::modify(const Key& key)
 {
-    _key = key;             // save key instance
+    _key_type = key.type;               // save key fields
+    _key_number = key.number;
+    _key_sprite = key.sprite;
+    _key_appearance = key.appearance;
     _key_acc = 0x0000;      // set key-signature
     if (key.type == Key::SHARP)
     {
@@ -144,7 +210,7 @@ void StaffContext::modify(const Key& key)
         if (key.number >= 7) {_key_acc |= 0x0800;   // Fb
         };};};};};};};
     };
-    _accidentals.clear();
+    reset_acc();
 }
 
 // set new base-note as specified by the clef
@@ -154,7 +220,12 @@ void StaffContext::modify(const Clef& clef)
     if (wholetone[clef.base_note % 12] != clef.base_note % 12) // check if the base note is a whole tone
         throw IllegalBasenoteException();
     
-    _clef = clef;   // save clef
+    _clef_sprite = clef.sprite;         // save clef fields
+    _clef_base = clef.base_note;
+    _clef_line = clef.line;
+    _keybnd_sharp = clef.keybnd_sharp;
+    _keybnd_flat = clef.keybnd_flat;
+    _clef_appearance = clef.appearance;
     
     // calculate the base_note
     _base_note = static_cast<tone_t>(12 * ((clef.base_note / 12) + (whole_off[clef.base_note % 12] + clef.line - 1) / 7) + tone_off[(whole_off[clef.base_note % 12] + clef.line - 1) % 7]);
@@ -169,7 +240,9 @@ void StaffContext::remember_acc(const Head& head)
     int tone_octave = (static_cast<int>(head.tone) - Accidental::note_modifier[head.accidental.type]) / 12;
     
     // save accidental
-    _accidentals[whole_off[tone_name] + 7 * tone_octave] = head.accidental.type;
+    const size_t idx = static_cast<size_t>(whole_off[tone_name] + 7 * tone_octave);
+    _acc_generations[idx] = _acc_generation;
+    _accidentals[idx] = static_cast<unsigned char>(head.accidental.type);
 }
 
 // calculate the vertical offset for the given note according to the current clef
@@ -191,7 +264,7 @@ mpx_t StaffContext::note_offset(const Head& head, mpx_t head_height) const
 mpx_t StaffContext::key_offset(Key::Type type, char idx, mpx_t head_height) const
 {
     // local variables
-    tone_t bound = (type == Key::SHARP) ? _clef.keybnd_sharp : _clef.keybnd_flat;    // key-signature bound
+    tone_t bound = (type == Key::SHARP) ? _keybnd_sharp : _keybnd_flat;    // key-signature bound
     int tone_name = 0;                         // tone name (corresponding to symbol)
     int tone_octave;                           // octave (of the symbol)
     
@@ -243,9 +316,9 @@ bool StaffContext::acc_visible(const Head& head) const
     int tone_octave = (static_cast<int>(head.tone) - Accidental::note_modifier[head.accidental.type]) / 12;
     
     // check currently used accidentals
-    AccidentalMap::const_iterator i = _accidentals.find(whole_off[tone_name] + 7 * tone_octave);
-    if (i != _accidentals.end())
-        return (head.accidental.type != i->second);
+    const size_t idx = static_cast<size_t>(whole_off[tone_name] + 7 * tone_octave);
+    if (_acc_generations[idx] == _acc_generation)
+        return (head.accidental.type != _accidentals[idx]);
     
     // calculate accidental flag mask
     unsigned short tone_byte = static_cast<unsigned short>(1u << whole_off[tone_name]);
@@ -316,6 +389,32 @@ Accidental::Type StaffContext::guess_accidental(const tone_t tone, bool pref_nat
     };
 }
 
+// compare with another staff-context (including the remembered accidentals)
+bool StaffContext::operator == (const StaffContext& context) const
+{
+    if (!(    _clef_sprite.setid    == context._clef_sprite.setid
+           && _clef_sprite.spriteid == context._clef_sprite.spriteid
+           && _clef_base            == context._clef_base
+           && _clef_line            == context._clef_line
+           && _keybnd_sharp         == context._keybnd_sharp
+           && _keybnd_flat          == context._keybnd_flat
+           && _key_type             == context._key_type
+           && _key_number           == context._key_number
+           && _key_sprite.setid     == context._key_sprite.setid
+           && _key_sprite.spriteid  == context._key_sprite.spriteid
+           && _base_note            == context._base_note
+           && _key_acc              == context._key_acc)) return false;
+    
+    // compare the valid entries of the remembered accidentals
+    for (size_t i = 0; i < ACCIDENTAL_COUNT; ++i)
+    {
+        const bool valid = (_acc_generations[i] == _acc_generation);
+        if (valid != (context._acc_generations[i] == context._acc_generation)) return false;
+        if (valid && _accidentals[i] != context._accidentals[i]) return false;
+    };
+    return true;
+}
+
 
 //
 //     class ScoreContext
@@ -235,7 +235,7 @@ const_Cursor::const_Cursor(const Cursor& c) : _staff(c._staff), _voice(c._voice)
 // increment operator; move cursor to the next note (prefix)
 const_Cursor& const_Cursor::operator ++ ()
 {
-    if (!_voice) throw UninitializedCursorException();
+    if (!_voice) throw Cursor::UninitializedCursorException();
     if (_staff == _voice) ++_main; else ++_sub;
     return *this;
 }
@@ -243,7 +243,7 @@ const_Cursor& const_Cursor::operator ++ ()
 // decrement operator; move cursor to the previous note (prefix)
 const_Cursor& const_Cursor::operator -- ()
 {
-    if (!_voice) throw UninitializedCursorException();
+    if (!_voice) throw Cursor::UninitializedCursorException();
     if (_staff == _voice) --_main; else --_sub;
     return *this;
 }
@@ -251,7 +251,7 @@ const_Cursor& const_Cursor::operator -- ()
 // increment operator; move cursor to the next note (postfix)
 const_Cursor const_Cursor::operator ++ (int)
 {
-    if (!_voice) throw UninitializedCursorException();
+    if (!_voice) throw Cursor::UninitializedCursorException();
     const_Cursor out(*this);
     if (_staff == _voice) ++_main; else ++_sub;
     return out;
@@ -260,7 +260,7 @@ const_Cursor const_Cursor::operator ++ (int)
 // decrement operator; move cursor to the previous note (postfix)
 const_Cursor const_Cursor::operator -- (int)
 {
-    if (!_voice) throw UninitializedCursorException();
+    if (!_voice) throw Cursor::UninitializedCursorException();
     const_Cursor out(*this);
     if (_staff == _voice) --_main; else --_sub;
     return out;
@@ -276,7 +276,7 @@ void const_Cursor::reset()
 // set cursor to the voice's end
 void const_Cursor::to_end()
 {
-    if (!_voice) throw UninitializedCursorException();
+    if (!_voice) throw Cursor::UninitializedCursorException();
     if (_staff == _voice) _main = static_cast<const Staff*>(_voice)->notes.end();
     else                  _sub  = static_cast<const SubVoice*>(_voice)->notes.end();
 }
@@ -284,7 +284,7 @@ void const_Cursor::to_end()
 // return the note index within the voice
 size_t const_Cursor::index() const
 {
-    if (!_voice) throw UninitializedCursorException();
+    if (!_voice) throw Cursor::UninitializedCursorException();
     size_t out = 0;
     if (_staff == _voice)
     {
@@ -305,7 +305,7 @@ size_t const_Cursor::index() const
 // return the length of the voice
 size_t const_Cursor::voice_length() const
 {
-    if (!_voice) throw UninitializedCursorException();
+    if (!_voice) throw Cursor::UninitializedCursorException();
     if (_staff == _voice) return static_cast<const Staff*>(_voice)->notes.size();
     else                  return static_cast<const SubVoice*>(_voice)->notes.size();
 }
@@ -342,7 +342,7 @@ bool const_Cursor::operator != (const const_Cursor& cursor) const noexcept
 // check, whether cursor can be incremented
 bool const_Cursor::has_next() const
 {
-    if (!_voice) throw UninitializedCursorException();
+    if (!_voice) throw Cursor::UninitializedCursorException();
     return (_staff == _voice) ? (_main != --static_cast<const Staff*>(_voice)->notes.end() &&
                                  _main !=   static_cast<const Staff*>(_voice)->notes.end())
                               : (_sub  != --static_cast<const SubVoice*>(_voice)->notes.end()  &&
@@ -352,7 +352,7 @@ bool const_Cursor::has_next() const
 // check, whether cursor can be decremented
 bool const_Cursor::has_prev() const
 {
-    if (!_voice) throw UninitializedCursorException();
+    if (!_voice) throw Cursor::UninitializedCursorException();
     return (_staff == _voice) ? _main != static_cast<const Staff*>(_voice)->notes.begin()
                               : _sub  != static_cast<const SubVoice*>(_voice)->notes.begin();
 }
@@ -360,7 +360,7 @@ bool const_Cursor::has_prev() const
 // check, if the cursor is at the end
 bool const_Cursor::at_end() const
 {
-    if (!_voice) throw UninitializedCursorException();
+    if (!_voice) throw Cursor::UninitializedCursorException();
     return (_staff == _voice) ? _main == static_cast<const Staff*>(_voice)->notes.end()
                               : _sub  == static_cast<const SubVoice*>(_voice)->notes.end();
 }
@@ -40,7 +40,7 @@ EditCursor::RemoveMainException::RemoveMainException()
 // calculate tone from note-name (regarding input method, ignoring accidentals)
 tone_t EditCursor::get_tone(const InputNote& note) const
 {
-    const tone_t& clef_base = get_staff_context().base_note();  // get clef-base note
+    const tone_t clef_base = get_staff_context().base_note();   // get clef-base note
 
     // set the correct octave
     int octave = clef_base / 12;                            // calculate octave of the clef-base
@@ -138,7 +138,7 @@ bool EditCursor::for_each_chord_in_beam_do(VoiceCursor& cur, callback_t func, co
         else
             i.prev();
     
-    const Plate::pNote* e = i.pnote->beam[VALUE_BASE - 3]->end;
+    const Plate::pNote* e = i.pnote->beam[VALUE_BASE - 3].end;
     
     // iterate to the end
     while(true)
@@ -200,6 +200,7 @@ EditCursor::~EditCursor() {}
 Staff& EditCursor::get_staff()
 {
     if (cursor == vcursors.end()) throw NotValidException();
+    set_edited();
     return cursor->note.staff();
 }
 
@@ -207,6 +208,7 @@ Staff& EditCursor::get_staff()
 Voice& EditCursor::get_voice()
 {
     if (cursor == vcursors.end()) throw NotValidException();
+    set_edited();
     return cursor->note.voice();
 }
 
@@ -214,6 +216,7 @@ Voice& EditCursor::get_voice()
 Cursor& EditCursor::get_cursor()
 {
     if (cursor == vcursors.end()) throw NotValidException();
+    set_edited();
     return cursor->note;
 }
 
@@ -221,6 +224,7 @@ Cursor& EditCursor::get_cursor()
 MovableList& EditCursor::get_attached()
 {
     if (cursor == vcursors.end())     throw NotValidException();
+    set_edited();
     return cursor->note->get_visible().attached;
 }
 
@@ -278,6 +282,7 @@ MovableList& EditCursor::get_page_attached()
 void EditCursor::insert(StaffObject* const object)
 {
     if (!ready()) throw NotValidException();
+    set_edited();
     if (!cursor->has_prev())                    // if the object was inserted at the front...
     {
         cursor->note.insert(object);                // insert the new object
@@ -301,6 +306,7 @@ void EditCursor::insert(const InputNote& note)
 void EditCursor::insert_head(const InputNote& note)
 {
     if (!ready()) throw NotValidException();            // check cursor
+    set_edited();                                       // mark the line as edited
     if (at_end() || !cursor->note->is(Class::CHORD))    // check current object type
         throw Cursor::IllegalObjectTypeException();     //    throw exception, if no chord
     Chord& chord = static_cast<Chord&>(*cursor->note);  // get target chord
@@ -342,6 +348,8 @@ void EditCursor::insert_rest(const unsigned char exp, const unsigned char dots)
 // insert newline objects into all active voices
 void EditCursor::insert_newline()
 {
+    set_edited();   // mark the line as edited
+    
     // check if this is a newline completion (i.e. add newline only to those voices without one)
     bool complete = true;
     for (std::list<VoiceCursor>::iterator cur = vcursors.begin(); cur != vcursors.end(); ++cur)
@@ -384,6 +392,8 @@ void EditCursor::insert_newline()
 // insert pagebreak objects into all active voices
 void EditCursor::insert_pagebreak()
 {
+    set_edited();   // mark the line as edited
+    
     // check if this is a newline completion (i.e. add newline only to those voices without one)
     bool complete = true;
     for (std::list<VoiceCursor>::iterator cur = vcursors.begin(); cur != vcursors.end(); ++cur)
@@ -436,6 +446,7 @@ void EditCursor::insert_pagebreak()
 void EditCursor::remove()
 {
     if (!ready()) throw NotValidException();        // check cursor
+    set_edited();                                   // mark the line as edited
     if (at_end()) return;                           // no note at end
     StaffObject* del_note = cursor->note->clone();
     
@@ -490,6 +501,7 @@ void EditCursor::remove()
 void EditCursor::remove_voice()
 {
     if (!ready()) throw NotValidException();        // check cursor
+    set_edited();                                   // mark the line as edited
     if (at_end()) return;                           // no note at end
     
     // only sub-voices can be removed
@@ -512,6 +524,7 @@ void EditCursor::remove_voice()
 void EditCursor::remove_newline()
 {
     if (!ready()) throw NotValidException();        // check cursor
+    set_edited();                                   // mark the line as edited
     if (   line == plateinfo->plate->lines.begin()  // if we are at the scores front
         && page == pageset->pages.begin())          //   (i.e. first line/first page)
             return;                                 //      do nothing
@@ -543,6 +556,7 @@ void EditCursor::remove_newline()
 void EditCursor::remove_pagebreak()
 {
     if (!ready()) throw NotValidException();        // check cursor
+    set_edited();                                   // mark the line as edited
     if (page == pageset->pages.begin())             // if we are at the scores front
         return;                                     //     do nothing
     home();                                         // goto line front
@@ -599,6 +613,7 @@ void EditCursor::_set_stem_length(Chord& chord, const VoiceCursor&, const int po
 void EditCursor::set_stem_length(spohh_t pohh)
 {
     if (!ready()) throw NotValidException();        // check cursor
+    set_edited();                                   // mark the line as edited
     if (at_end()) throw Cursor::IllegalObjectTypeException();
     if (!for_each_chord_in_beam_do(*cursor, &_set_stem_length, pohh))
         log_warn("Unable to find beam begin. (class: EditCursor)");
@@ -608,6 +623,7 @@ void EditCursor::set_stem_length(spohh_t pohh)
 void EditCursor::add_stem_slope(spohh_t pohh)
 {
     if (!ready()) throw NotValidException();        // check cursor
+    set_edited();                                   // mark the line as edited
     if (at_end()) throw Cursor::IllegalObjectTypeException();
     
     // search for the first note within the beam
@@ -624,6 +640,7 @@ void EditCursor::add_stem_slope(spohh_t pohh)
 void EditCursor::set_stem_slope(int pohh)
 {
     if (!ready()) throw NotValidException();        // check cursor
+    set_edited();                                   // mark the line as edited
     if (at_end()) throw Cursor::IllegalObjectTypeException();
     
     // search for the first note within the beam
@@ -655,6 +672,7 @@ void EditCursor::_set_stem_dir(Chord& chord, const VoiceCursor&, const int dir,
 void EditCursor::set_stem_dir(bool down)
 {
     if (!ready()) throw NotValidException();        // check cursor
+    set_edited();                                   // mark the line as edited
     if (at_end()) throw Cursor::IllegalObjectTypeException();
     if (!for_each_chord_in_beam_do(*cursor, &_set_stem_dir, down ? -1 : 1))
         log_warn("Unable to find beam begin. (class: EditCursor)");
@@ -663,7 +681,7 @@ void EditCursor::set_stem_dir(bool down)
 // set the stem-type within the current beam group
 void EditCursor::_set_stem_type(Chord& chord, const VoiceCursor& cursor, const int type, int*)
 {
-    switch (static_cast<const Chord::StemType>(type))
+    switch (static_cast<Chord::StemType>(type))
     {
     case Chord::STEM_CUSTOM:
         if (chord.stem.type == Chord::STEM_CUSTOM) break;
@@ -691,6 +709,7 @@ void EditCursor::_set_stem_type(Chord& chord, const VoiceCursor& cursor, const i
 void EditCursor::set_stem_type(const Chord::StemType type)
 {
     if (!ready()) throw NotValidException();        // check cursor
+    set_edited();                                   // mark the line as edited
     if (at_end()) throw Cursor::IllegalObjectTypeException();
     if (!for_each_chord_in_beam_do(*cursor, &_set_stem_type, static_cast<int>(type)))
         log_warn("Unable to find beam begin. (class: EditCursor)");
@@ -700,6 +719,7 @@ void EditCursor::set_stem_type(const Chord::StemType type)
 void EditCursor::set_slope_type(const Chord::SlopeType type)
 {
     if (!ready()) throw NotValidException();        // check cursor
+    set_edited();                                   // mark the line as edited
     if (at_end()) throw Cursor::IllegalObjectTypeException();
     
     // search for the first note within the beam
@@ -715,7 +735,7 @@ void EditCursor::set_slope_type(const Chord::SlopeType type)
     for_each_chord_in_beam_do(*cursor, &_set_stem_type, static_cast<int>(Chord::STEM_CUSTOM));
     static_cast<Chord&>(*beam_begin.note).stem.slope_type = type;
     if (type == Chord::SLOPE_CUSTOM)
-        static_cast<Chord&>(*beam_begin.note).stem.slope = static_cast<spohh_t>(((beam_begin.pnote->stem.top - beam_begin.pnote->beam[VALUE_BASE - 3]->end->stem.top) * 1000.0) / beam_begin.pvoice->head_height + .5);
+        static_cast<Chord&>(*beam_begin.note).stem.slope = static_cast<spohh_t>(((beam_begin.pnote->stem.top - beam_begin.pnote->beam[VALUE_BASE - 3].end->stem.top) * 1000.0) / beam_begin.pvoice->head_height + .5);
     else if (type == Chord::SLOPE_BOUNDED)
         static_cast<Chord&>(*beam_begin.note).stem.slope = get_style().beam_slope_max;
     for_each_chord_in_beam_do(*cursor, &_set_stem_type, static_cast<int>(stem_type));
@@ -728,6 +748,7 @@ void EditCursor::set_slope_type(const Chord::SlopeType type)
 void EditCursor::set_accidental_auto()
 {
     if (!ready()) throw NotValidException();        // check cursor
+    set_edited();                                   // mark the line as edited
     if (at_end() || !cursor->note->is(Class::CHORD))
         throw Cursor::IllegalObjectTypeException();
     
@@ -20,14 +20,17 @@
 
 #include <iostream>
 #include <limits>
+#include <utility>      // std::move
 
 #include "engine.hh"
 #include "log.hh"               // Log
+#include "undefined.hh"         // defines "UNDEFINED" macro, resolving to the largest value "size_t" can contain
 
 using namespace ScorePress;
 
 inline unsigned int _abs(const int x) {return static_cast<unsigned int>((x<0)?-x:x);}
 inline int _round(const double d) {return static_cast<mpx_t>(d + 0.5);}
+inline int _floordiv(const int a, const int b) {return (a < 0) ? -((b - 1 - a) / b) : a / b;}
 
 // exception class
 Engine::Error::Error(const std::string& msg) : ScorePress::Error(msg) {}
@@ -59,6 +62,65 @@ const Position<mpx_t> Engine::page_pos(const size_t _pageno, const MultipageLayo
     };
 }
 
+// calculate the range of pages intersecting the given rectangle (relative to the layout)
+bool Engine::page_range(const Plate::GphBox& rect, const MultipageLayout layout, size_t& first, size_t& last) const
+{
+    // get the visible interval in the layout direction
+    const bool  vertical = (layout.orientation == MultipageLayout::VERTICAL);
+    const mpx_t lo = vertical ? rect.pos.y    : rect.pos.x;
+    const mpx_t hi = vertical ? rect.bottom() : rect.right();
+    const mpx_t w = page_width();
+    const mpx_t h = page_height();
+    const mpx_t d = layout.distance;
+    if (w <= 0 || h <= 0) {first = 0; last = UNDEFINED; return true;};
+    
+    // invert "page_pos" (see above)
+    int a, b;
+    switch (layout.join)
+    {
+    case MultipageLayout::DOUBLE:
+        if (vertical) {a = 2 * _floordiv(lo, h + d); b = 2 * _floordiv(hi, h + d) + 1;}
+        else          {a = _floordiv(lo, w + d);     b = _floordiv(hi, w + d);};
+        break;
+    case MultipageLayout::JOINED:
+        if (vertical) {a = 2 * _floordiv(lo, h + d);     b = 2 * _floordiv(hi, h + d) + 1;}
+        else          {a = 2 * _floordiv(lo, 2 * w + d); b = 2 * _floordiv(hi, 2 * w + d) + 1;};
+        break;
+    case MultipageLayout::FIRSTOFF:
+        if (vertical) {a = 2 * _floordiv(lo, h + d) - 1;         b = 2 * _floordiv(hi, h + d);}
+        else          {a = 2 * _floordiv(lo + w, 2 * w + d) - 1; b = 2 * _floordiv(hi + w, 2 * w + d);};
+        break;
+    default:
+        a = _floordiv(lo, (vertical ? h : w) + d);
+        b = _floordiv(hi, (vertical ? h : w) + d);
+        break;
+    };
+    if (b < 0) return false;
+    first = (a < 0) ? 0 : static_cast<size_t>(a);
+    last  = static_cast<size_t>(b);
+    return true;
+}
+
+// find the page containing the given position (returns the last page, if there is none; without locking)
+Pageset::Iterator Engine::find_page(const Position<mpx_t>& pos, const MultipageLayout layout, size_t& idx)
+{
+    const Position<mpx_t> pagedim(page_width(), page_height());
+    size_t first, last;
+    const bool in_range = page_range(Plate::GphBox(pos, 1, 1), layout, first, last);
+    engrave_to(in_range ? last : 0);    // (the pageset may not be engraved yet, see "engrave_pages")
+    if (pageset.pages.empty()) throw Error("Cannot select a page of an empty pageset.");
+    
+    if (in_range && first < pageset.pages.size())
+    {
+        Pageset::Iterator page = pageset.get_page(first);
+        for (idx = first; page != pageset.pages.end() && idx <= last; ++page, ++idx)
+            if (Plate::GphBox(page_pos(idx, layout), pagedim.x, pagedim.y).contains(pos))
+                return page;
+    };
+    idx = pageset.pages.size() - 1;
+    return --pageset.pages.end();
+}
+
 // get plateinfo by position (on page)
 Pageset::PlateInfo& Engine::select_plate(const Position<mpx_t>& pos, Page& page)
 {
@@ -71,18 +133,8 @@ Pageset::PlateInfo& Engine::select_plate(const Position<mpx_t>& pos, Page& page)
 Pageset::PlateInfo& Engine::select_plate(const Position<mpx_t>& pos, const MultipageLayout layout)
 {
     // get page
-    Pageset::Iterator page;
-    unsigned int i = 0;
-    Position<mpx_t> pagepos;
-    const Position<mpx_t> pagedim(page_width(), page_height());
-    for (page = pageset.pages.begin(); page != pageset.pages.end(); ++page, ++i)
-    {
-        pagepos = page_pos(i, layout);
-        if (   pos.x >= pagepos.x             && pos.y >= pagepos.y
-            && pos.x <  pagepos.x + pagedim.x && pos.y <  pagepos.y + pagedim.y)
-                break;
-    };
-    if (page == pageset.pages.end()) --page;
+    size_t idx;
+    const Pageset::Iterator page = find_page(pos, layout, idx);
     
     // seach the plate
     Pageset::pPage::Iterator pinfo = page->get_plate_by_pos(pos);
@@ -92,13 +144,171 @@ Pageset::PlateInfo& Engine::select_plate(const Position<mpx_t>& pos, const Multi
 // constructor (specifying the document the engine will operate on)
 Engine::Engine(Document& _document, const Sprites& sprites) : document(&_document),
                                                               engraver(pageset, sprites, viewport),
-                                                              press(_document.style, viewport) {}
+                                                              press(_document.style, viewport),
+                                                              lazy(false), pending(false), ready_pages(0),
+                                                              running(false), cancelled(false),
+                                                              on_ready(NULL), on_ready_data(NULL),
+                                                              recording(false), recorded_for(NULL), recorded_scale(0)
+{
+    engraver.set_statistics(&statistics);
+}
 
-// engrave document (calculates pageset)
-void Engine::engrave()
+// destructor (stops the engraving thread)
+Engine::~Engine()
+{
+    cancelled = true;
+    if (worker.joinable()) worker.join();
+}
+
+// change the associated document
+void Engine::set_document(Document& _document)
+{
+    cancel_engraving();
+    document = &_document;
+    pageset.clear();
+    cursors.clear();
+    pending = false;
+    partial.clear();
+    discard_pages();
+}
+
+// is the lazy engraving incomplete?
+bool Engine::is_pending() const
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return pending;
+}
+
+// notify about finished pages (background engraving)
+void Engine::set_ready_callback(ready_callback_t callback, void* data)
+{
+    cancel_engraving();
+    on_ready = callback;
+    on_ready_data = data;
+}
+
+// engrave the whole document (without locking)
+void Engine::engrave_document()
 {
     engraver.engrave(*document);
     cursors.clear();
+    pending = false;
+    partial.clear();
+    discard_pages();
+}
+
+// prepare the pageset for a partial engraving (without locking)
+void Engine::start_partial()
+{
+    engraver.prepare(*document);
+    cursors.clear();
+    partial.clear();
+    for (std::list<Document::Score>::const_iterator i = document->scores.begin(); i != document->scores.end(); ++i)
+        partial.insert(&i->score);
+    ready_pages = 0;
+    pending = true;
+    discard_pages();
+}
+
+// engrave the pages up to the given one (without locking)
+void Engine::engrave_to(const size_t page)
+{
+    // start the engraving
+    if (!pending)
+    {
+        if (!pageset.pages.empty()) return;             // the document is already engraved
+        if (!lazy) {engrave_document(); return;}        // engrave the whole document
+        start_partial();                                // prepare the pageset
+    };
+    
+    // engrave the scores up to the given page (continuing the partial engravings)
+    if (page < ready_pages) return;
+    for (std::list<Document::Score>::const_iterator i = document->scores.begin(); i != document->scores.end(); ++i)
+    {
+        if (i->start_page > page || partial.find(&i->score) == partial.end()) continue;
+        if (engraver.proceed(i->score, document->style, i->start_page, document->head_height, page))
+            partial.erase(&i->score);
+    };
+    pageset.invalidate_index();
+    ready_pages = page + 1;
+    pending = !partial.empty();
+}
+
+// engrave document (calculates pageset)
+void Engine::engrave()
+{
+    cancel_engraving();
+    engrave_document();
+}
+
+// engrave the pages up to the given one (lazy mode)
+void Engine::engrave_pages(const size_t page)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    engrave_to(page);
+}
+
+// engrave the remaining pages (lazy mode; waits for the engraving thread)
+void Engine::finish_engraving()
+{
+    join_thread();
+    if (pending || pageset.pages.empty())
+        engrave_to(UNDEFINED - 1);
+}
+
+// engrave document page by page on a background thread
+void Engine::engrave_background()
+{
+    cancel_engraving();
+    start_partial();
+    running = true;
+    worker = std::thread(&Engine::engrave_thread, this);
+}
+
+// stop the engraving thread (the finished pages are kept)
+void Engine::cancel_engraving()
+{
+    cancelled = true;
+    join_thread();
+}
+
+// engrave the pages one by one (thread function)
+void Engine::engrave_thread()
+{
+    try
+    {
+        bool done = false;
+        for (size_t page = 0; !done && !cancelled; ++page)
+        {
+            size_t pages;
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                if (page < ready_pages) page = ready_pages;     // (pages might have been requested meanwhile)
+                engrave_to(page);
+                pages = ready_count();
+                done = !pending;
+            }
+            if (on_ready) on_ready(*this, pages, on_ready_data);
+        };
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    };
+    running = false;
+}
+
+// wait for the engraving thread (rethrows its exception)
+void Engine::join_thread()
+{
+    if (worker.joinable()) worker.join();
+    cancelled = false;
+    if (error)
+    {
+        std::exception_ptr e = error;
+        error = std::exception_ptr();
+        std::rethrow_exception(e);
+    };
 }
 
 // engrave document (recalculate cursors)
@@ -120,15 +330,23 @@ void Engine::reengrave()
     };
     
     // reengrave
+    cancel_engraving();
     engraver.engrave(*document, info);
+    pending = false;
+    partial.clear();
+    discard_pages();
     info.finish();
     if (!info.is_empty())
         log_error("Some cursors could not be updated. (class: Engine)");
 }
 
-// engrave single score (recalculate cursors)
+// engrave single score, beginning in front of the first edited line (recalculate cursors)
 void Engine::reengrave(UserCursor& cursor)
 {
+    // finish a partial engraving (the reengraving holds the following lines)
+    cancel_engraving();
+    finish_engraving();
+    
     // setup reengrave info
     ReengraveInfo info;
     for (CursorList::iterator cur = cursors.begin(); cur != cursors.end();)
@@ -145,41 +363,131 @@ void Engine::reengrave(UserCursor& cursor)
         };
     };
     
-    // reengrave
-    engraver.engrave(cursor.get_score(), document->style, cursor.get_start_page(), document->head_height, info);
+    // reengrave (beginning in front of the first edited line, i.e. the cursor's line or one edited by any cursor)
+    const size_t pageno = engraver.reengrave(cursor.get_score(), document->style, cursor.get_start_page(), document->head_height, cursor.get_line(), info);
+    pageset.invalidate_index();
+    discard_pages(pageno);
     info.finish();
     if (!info.is_empty())
         log_error("Some cursors could not be updated. (class: Engine)");
 }
 
-// render a single page at the given offset
-void Engine::render_page(Renderer& renderer, const Page page, const Position<mpx_t>& offset, bool decor)
+// render a page at the given position (without locking)
+void Engine::render_single(Renderer& renderer, const size_t idx, const Pageset::pPage& page, const Position<mpx_t>& pos,
+                           const Plate::GphBox* visible, bool decor)
 {
-    if (pageset.pages.empty()) engrave();
     Position<mpx_t> margin_offset(_round(press.parameters.do_scale(pageset.page_layout.margin.left)),
                                   _round(press.parameters.do_scale(pageset.page_layout.margin.top)));
     
-    if (decor) press.render_decor(renderer, pageset, offset);
-    press.render(renderer, *page.it, pageset, offset + margin_offset);
+    if (decor) press.render_decor(renderer, pageset, pos);
+    SCOREPRESS_TIME(&statistics, RENDER);
+    if (recording) render_recorded(renderer, idx, page, pos + margin_offset);
+    else           press.render(renderer, page, pageset, pos + margin_offset, visible);
+}
+
+// render a single page at the given offset
+void Engine::render_page(Renderer& renderer, const Page page, const Position<mpx_t>& offset, bool decor)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    engrave_to(page.idx);
+    render_single(renderer, page.idx, *page.it, offset, NULL, decor);
+}
+
+// render the visible part of a single page at the given offset
+void Engine::render_page(Renderer& renderer, const Page page, const Position<mpx_t>& offset, const Plate::GphBox& visible, bool decor)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    if (!Plate::GphBox(offset, page_width(), page_height()).intersects(visible)) return;
+    engrave_to(page.idx);
+    render_single(renderer, page.idx, *page.it, offset, &visible, decor);
 }
 
 // render all pages according to the given layout
 void Engine::render_all(Renderer& renderer, const MultipageLayout layout, const Position<mpx_t>& offset, bool decor)
 {
-    if (pageset.pages.empty()) engrave();
-    Position<mpx_t> margin_offset(_round(press.parameters.do_scale(pageset.page_layout.margin.left)),
-                                  _round(press.parameters.do_scale(pageset.page_layout.margin.top)));
+    if (!running) finish_engraving();   // (while the engraving thread is running, the finished pages are rendered)
+    std::lock_guard<std::mutex> guard(lock);
+    size_t pageno = 0;
+    const size_t pagecnt = ready_count();
+    for (std::list<Pageset::pPage>::iterator i = pageset.pages.begin(); i != pageset.pages.end() && pageno < pagecnt; ++i, ++pageno)
+        render_single(renderer, pageno, *i, offset + page_pos(pageno, layout), NULL, decor);
+}
+
+// render the visible pages according to the given layout
+void Engine::render_all(Renderer& renderer, const MultipageLayout layout, const Position<mpx_t>& offset, const Plate::GphBox& visible, bool decor)
+{
+    if (!running) finish_engraving();   // (while the engraving thread is running, the finished pages are rendered)
+    std::lock_guard<std::mutex> guard(lock);
+    
+    // get the range of visible pages
+    size_t first, last;
+    if (!page_range(Plate::GphBox(visible.pos - offset, visible.width, visible.height), layout, first, last)) return;
+    const size_t pagecnt = ready_count();
+    if (first >= pagecnt) return;
     
+    // render the pages intersecting the visible rectangle
+    const Position<mpx_t> pagedim(page_width(), page_height());
     Position<mpx_t> off;
-    unsigned int pageno = 0;
-    for (std::list<Pageset::pPage>::iterator i = pageset.pages.begin(); i != pageset.pages.end(); ++i)
+    size_t pageno = first;
+    for (std::list<Pageset::pPage>::iterator i = pageset.get_page(first); i != pageset.pages.end() && pageno < pagecnt && pageno <= last; ++i, ++pageno)
     {
-        off = offset + page_pos(pageno++, layout);
-        if (decor) press.render_decor(renderer, pageset, off);
-        press.render(renderer, *i, pageset, off + margin_offset);
+        off = offset + page_pos(pageno, layout);
+        if (Plate::GphBox(off, pagedim.x, pagedim.y).intersects(visible))
+            render_single(renderer, pageno, *i, off, &visible, decor);
     };
 }
 
+// discard the recorded pages from the given one on (without locking)
+void Engine::discard_pages(const size_t page)
+{
+    if (display_lists.size() > page) display_lists.resize(page);
+}
+
+// render a page through its display list, recording it if necessary (without locking)
+void Engine::render_recorded(Renderer& renderer, const size_t idx, const Pageset::pPage& page, const Position<mpx_t>& offset)
+{
+    // discard the display lists recorded for another renderer
+    if (recorded_for != &renderer)
+    {
+        display_lists.clear();
+        recorder.set_source(renderer);
+        recorded_for = &renderer;
+    };
+    if (display_lists.empty()) recorded_scale = press.parameters.scale;
+    
+    // record the page (at zero offset and with the recorded scale)
+    if (display_lists.size() <= idx) display_lists.resize(idx + 1);
+    if (display_lists[idx].empty())
+    {
+        const promille_t scale = press.parameters.scale;
+        press.parameters.scale = recorded_scale;
+        recorder.set_target(display_lists[idx]);
+        press.render(recorder, page, pageset, Position<mpx_t>());
+        recorder.unset_target();
+        press.parameters.scale = scale;
+    };
+    
+    // replay the page
+    display_lists[idx].replay(renderer, offset.x / 1000.0, offset.y / 1000.0,
+                              static_cast<double>(press.parameters.scale) / recorded_scale);
+}
+
+// replay recorded display lists of the pages
+void Engine::set_recording(bool _recording)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    recording = _recording;
+    display_lists.clear();
+    recorded_for = NULL;
+}
+
+// discard the display lists
+void Engine::clear_recording()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    display_lists.clear();
+}
+
 // render the cursor, assuming the given page root position
 void Engine::render_cursor(Renderer& renderer, const UserCursor& cursor, const Position<mpx_t>& _page_pos)
 {
@@ -236,12 +544,20 @@ void Engine::render_object(Renderer& renderer, const ObjectCursor& cursor, const
     press.render(renderer, cursor.get_pobject(), cursor.get_staff(), offset + page_pos(cursor.get_pageno(), layout) + margin_offset);
 }
 
+// page count (in lazy or background mode, the number of pages engraved so far)
+size_t Engine::page_count() const
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return ready_count();
+}
+
 // width of complete layout
 mpx_t Engine::layout_width(const MultipageLayout layout) const
 {
-    if (pageset.pages.empty()) return 0;
-    const int pagecnt = (pageset.pages.size() < static_cast<size_t>(std::numeric_limits<int>::max()))
-                           ? static_cast<int>(pageset.pages.size())
+    const size_t count = page_count();
+    if (count == 0) return 0;
+    const int pagecnt = (count < static_cast<size_t>(std::numeric_limits<int>::max()))
+                           ? static_cast<int>(count)
                            : std::numeric_limits<int>::max();
     switch (layout.join)
     {
@@ -267,9 +583,10 @@ mpx_t Engine::layout_width(const MultipageLayout layout) const
 // height of complete layout
 mpx_t Engine::layout_height(const MultipageLayout layout) const
 {
-    if (pageset.pages.empty()) return 0;
-    const int pagecnt = (pageset.pages.size() < static_cast<size_t>(std::numeric_limits<int>::max()))
-                           ? static_cast<int>(pageset.pages.size())
+    const size_t count = page_count();
+    if (count == 0) return 0;
+    const int pagecnt = (count < static_cast<size_t>(std::numeric_limits<int>::max()))
+                           ? static_cast<int>(count)
                            : std::numeric_limits<int>::max();
     switch (layout.join)
     {
@@ -289,40 +606,31 @@ mpx_t Engine::layout_height(const MultipageLayout layout) const
     };
 }
 
+// calculate page-iterator by index
+const Engine::Page Engine::select_page(const size_t page)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    engrave_to(page);
+    return Page(page, pageset.get_page(page));
+}
+
 // calculate page-iterator by position  (transform pos to on-page pos)
 const Engine::Page Engine::select_page(Position<mpx_t>& pos, const MultipageLayout layout)
 {
-    unsigned int i = 0;
-    Position<mpx_t> pagepos;
-    const Position<mpx_t> pagedim(page_width(), page_height());
-    for (Pageset::Iterator p = pageset.pages.begin(); p != pageset.pages.end(); ++p, ++i)
-    {
-        pagepos = page_pos(i, layout);
-        if (   pos.x >= pagepos.x             && pos.y >= pagepos.y
-            && pos.x <  pagepos.x + pagedim.x && pos.y <  pagepos.y + pagedim.y)
-        {
-                pos -= pagepos;
-                return Page(i, p);
-        };
-    };
-    pos -= pagepos;
-    return Page(--i, --pageset.pages.end());
+    std::lock_guard<std::mutex> guard(lock);
+    size_t idx;
+    const Pageset::Iterator page = find_page(pos, layout, idx);
+    pos -= page_pos(idx, layout);
+    return Page(idx, page);
 }
 
 // calculate page-iterator by position
 const Engine::Page Engine::select_page(const Position<mpx_t>& pos, const MultipageLayout layout)
 {
-    unsigned int i = 0;
-    Position<mpx_t> pagepos;
-    const Position<mpx_t> pagedim(page_width(), page_height());
-    for (Pageset::Iterator p = pageset.pages.begin(); p != pageset.pages.end(); ++p, ++i)
-    {
-        pagepos = page_pos(i, layout);
-        if (   pos.x >= pagepos.x             && pos.y >= pagepos.y
-            && pos.x <  pagepos.x + pagedim.x && pos.y <  pagepos.y + pagedim.y)
-                return Page(i, p);
-    };
-    return Page(--i, --pageset.pages.end());
+    std::lock_guard<std::mutex> guard(lock);
+    size_t idx;
+    const Pageset::Iterator page = find_page(pos, layout, idx);
+    return Page(idx, page);
 }
 
 // get score by position (on page)
@@ -366,7 +674,7 @@ Document::Score& Engine::select_score(Position<mpx_t> pos, const MultipageLayout
 RefPtr<EditCursor> Engine::get_cursor()
 {
     if (document->scores.empty()) throw Error("Cannot create a cursor for an empty document.");
-    if (pageset.pages.empty()) engrave();
+    finish_engraving();
     RefPtr<EditCursor> cursor(new EditCursor(*document, pageset, interface, viewport));
     cursor->set_score(document->scores.front());
     cursor->log_set(*this);
@@ -378,7 +686,7 @@ RefPtr<EditCursor> Engine::get_cursor()
 RefPtr<EditCursor> Engine::get_cursor(Document::Score& score)
 {
     if (document->scores.empty()) throw Error("Cannot create a cursor for an empty document.");
-    if (pageset.pages.empty()) engrave();
+    finish_engraving();
     RefPtr<EditCursor> cursor(new EditCursor(*document, pageset, interface, viewport));
     cursor->set_score(score);
     cursor->log_set(*this);
@@ -390,7 +698,7 @@ RefPtr<EditCursor> Engine::get_cursor(Document::Score& score)
 RefPtr<EditCursor> Engine::get_cursor(Position<mpx_t> pos, const Page& page)
 {
     if (document->scores.empty()) throw Error("Cannot create a cursor for an empty document.");
-    if (pageset.pages.empty()) engrave();
+    finish_engraving();
     Document::Score* const score(&select_score(pos, page));
     RefPtr<EditCursor> cursor(new EditCursor(*document, pageset, interface, viewport));
     cursor->set_score(*score);
@@ -404,7 +712,7 @@ RefPtr<EditCursor> Engine::get_cursor(Position<mpx_t> pos, const Page& page)
 RefPtr<EditCursor> Engine::get_cursor(Position<mpx_t> pos, const MultipageLayout layout)
 {
     if (document->scores.empty()) throw Error("Cannot create a cursor for an empty document.");
-    if (pageset.pages.empty()) engrave();
+    finish_engraving();
     const Page page(select_page(pos, layout));
     Document::Score* const score(&select_score(pos, page));
     RefPtr<EditCursor> cursor(new EditCursor(*document, pageset, interface, viewport));
@@ -445,7 +753,7 @@ void Engine::set_cursor(RefPtr<EditCursor>& cursor, Position<mpx_t> pos, const M
 RefPtr<ObjectCursor> Engine::select_object()
 {
     if (document->scores.empty()) throw Error("Cannot create a cursor for an empty document.");
-    if (pageset.pages.empty()) engrave();
+    finish_engraving();
     RefPtr<ObjectCursor> cursor(new ObjectCursor(*document, pageset));
     if (!cursor->set_parent(pageset.pages.front()))
         return RefPtr<ObjectCursor>();
@@ -457,7 +765,7 @@ RefPtr<ObjectCursor> Engine::select_object()
 RefPtr<ObjectCursor> Engine::select_object(EditCursor& cur)
 {
     if (document->scores.empty()) throw Error("Cannot create a cursor for an empty document.");
-    if (pageset.pages.empty()) engrave();
+    finish_engraving();
     RefPtr<ObjectCursor> cursor(new ObjectCursor(*document, pageset));
     if (!cursor->set_parent(cur))
         return RefPtr<ObjectCursor>();
@@ -469,7 +777,7 @@ RefPtr<ObjectCursor> Engine::select_object(EditCursor& cur)
 RefPtr<ObjectCursor> Engine::select_object(Position<mpx_t> pos, const Page& page)
 {
     if (document->scores.empty()) throw Error("Cannot create a cursor for an empty document.");
-    if (pageset.pages.empty()) engrave();
+    finish_engraving();
     RefPtr<ObjectCursor> cursor(new ObjectCursor(*document, pageset));
     if (!cursor->select(pos, *page.it))
         return RefPtr<ObjectCursor>();
@@ -481,7 +789,7 @@ RefPtr<ObjectCursor> Engine::select_object(Position<mpx_t> pos, const Page& page
 RefPtr<ObjectCursor> Engine::select_object(Position<mpx_t> pos, const MultipageLayout layout)
 {
     if (document->scores.empty()) throw Error("Cannot create a cursor for an empty document.");
-    if (pageset.pages.empty()) engrave();
+    finish_engraving();
     const Page page(select_page(pos, layout));
     RefPtr<ObjectCursor> cursor(new ObjectCursor(*document, pageset));
     if (!cursor->select(pos, *page.it))
@@ -495,7 +803,7 @@ bool Engine::set_cursor(RefPtr<ObjectCursor>& cursor)
 {
     if (&cursor->get_document() != document || &cursor->get_pageset() != &pageset) return false;
     if (document->scores.empty()) throw Error("Cannot create a cursor for an empty document.");
-    if (pageset.pages.empty()) engrave();
+    finish_engraving();
     return cursor->set_parent(pageset.pages.front());
 }
 
@@ -504,7 +812,7 @@ bool Engine::set_cursor(RefPtr<ObjectCursor>& cursor, EditCursor& cur)
 {
     if (&cursor->get_document() != document || &cursor->get_pageset() != &pageset) return false;
     if (document->scores.empty()) throw Error("Cannot create a cursor for an empty document.");
-    if (pageset.pages.empty()) engrave();
+    finish_engraving();
     return cursor->set_parent(cur);
 }
 
@@ -513,7 +821,7 @@ bool Engine::set_cursor(RefPtr<ObjectCursor>& cursor, Position<mpx_t> pos, const
 {
     if (&cursor->get_document() != document || &cursor->get_pageset() != &pageset) return false;
     if (document->scores.empty()) throw Error("Cannot create a cursor for an empty document.");
-    if (pageset.pages.empty()) engrave();
+    finish_engraving();
     return cursor->select(pos, *page.it);
 }
 
@@ -522,7 +830,7 @@ bool Engine::set_cursor(RefPtr<ObjectCursor>& cursor, Position<mpx_t> pos, const
 {
     if (&cursor->get_document() != document || &cursor->get_pageset() != &pageset) return false;
     if (document->scores.empty()) throw Error("Cannot create a cursor for an empty document.");
-    if (pageset.pages.empty()) engrave();
+    finish_engraving();
     const Page page(select_page(pos, layout));
     return cursor->select(pos, *page.it);
 }
@@ -532,7 +840,7 @@ bool Engine::register_cursor(RefPtr<CursorBase> cursor)
 {
     for (CursorList::iterator cur = cursors.begin(); cur != cursors.end(); ++cur)
         if (*cur == cursor) return false;
-    cursors.push_back(cursor);
+    cursors.push_back(std::move(cursor));
     return true;
 }
 
@@ -562,3 +870,17 @@ void Engine::plate_dump() const
     };
 }
 
+// accumulated run-times and object counts
+Statistics Engine::get_statistics() const
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return statistics;
+}
+
+// set all counters to zero
+void Engine::reset_statistics()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    statistics.reset();
+}
+
@@ -37,16 +37,16 @@ BeamInfo::Error::Error(const std::string& msg) : ScorePress::Error(msg) {}
 // set the given beam information to be ending at the given note
 void BeamInfo::set(size_t beam_idx, size_t end_idx, Plate::pNote& begin, const Plate::pNote& end, const Plate::pNote& cur)
 {
-    if (!begin.beam[beam_idx])              // if there is no beam info
-        begin.beam[beam_idx] = RefPtr<Plate::pNote::Beam>(new Plate::pNote::Beam());   // create one
+    if (!begin.beam[beam_idx].end)                  // if there is no beam info
+        begin.beam[beam_idx] = Plate::pNote::Beam();    // create one
     
-    begin.beam[beam_idx]->end_idx = end_idx % 0x10;         // end stem index
-    begin.beam[beam_idx]->short_beam = (&begin == &end);    // short beam?
+    begin.beam[beam_idx].end_idx = end_idx % 0x10;      // end stem index
+    begin.beam[beam_idx].short_beam = (&begin == &end); // short beam?
     
     // set end-note reference
     if (&begin == &end)                     // if we have got a short beam
-        begin.beam[beam_idx]->end = &cur;   //   let this next note be the reference
-    else begin.beam[beam_idx]->end = &end;  // normal beam end note
+        begin.beam[beam_idx].end = &cur;    //   let this next note be the reference
+    else begin.beam[beam_idx].end = &end;   // normal beam end note
 }
 
 // start necessary beams
@@ -71,12 +71,12 @@ void BeamInfo::calculate_beam(size_t i, Plate::pNote& pnote, const Plate::pNote&
             set(i, (i < VALUE_BASE - 3) ? s++ : s, *beam[i], end, pnote);
         
         // short beam adjustment
-        if (beam[i]->beam[i]->short_beam)
+        if (beam[i]->beam[i].short_beam)
         {
             // delete short 8th beam (i.e. use flag instead)
             if (i == VALUE_BASE - 3)
             {
-                free(beam[i]->beam[i]);
+                beam[i]->beam[i] = Plate::pNote::Beam();
                 beam[i]->noflag = false;
             } else
             
@@ -85,9 +85,9 @@ void BeamInfo::calculate_beam(size_t i, Plate::pNote& pnote, const Plate::pNote&
             {
                 // check for inconvienient previous note (i.e. no beam or not in the same beam group)
                 if (   beam[i]->beam_begin == voice->notes.end()
-                    || beam[i]->beam_begin != beam[i]->beam[i]->end->beam_begin)
+                    || beam[i]->beam_begin != beam[i]->beam[i].end->beam_begin)
                 {
-                    free(beam[i]->beam[i]);
+                    beam[i]->beam[i] = Plate::pNote::Beam();
                     beam[i]->noflag = false;
                 }
                 else
@@ -101,9 +101,9 @@ void BeamInfo::calculate_beam(size_t i, Plate::pNote& pnote, const Plate::pNote&
                     // let the beam face left (if the previous note did not cut the beam)
                     if (static_cast<const Chord&>(*short_end->note).beam != Chord::BEAM_CUT || short_dir == FORCE_LEFT)
                     {
-                        beam[i]->beam[i]->short_left = true;
+                        beam[i]->beam[i].short_left = true;
                         if (beam[i] != beam[VALUE_BASE - 3])
-                            beam[i]->beam[i]->end = &*short_end;
+                            beam[i]->beam[i].end = &*short_end;
                     };
                     
                     if (s) --s;
@@ -141,7 +141,7 @@ void BeamInfo::set(unsigned int exp, Plate::pVoice::Iterator pnote, ShortDir sho
                 ++s;                        
         };
     };
-    end->stem.beam_off = s;
+    end->stem.beam_off = static_cast<unsigned int>(s);
 }
 
 // end all existing beams at this note
@@ -152,7 +152,7 @@ void BeamInfo::stop(unsigned int exp, Plate::pVoice::Iterator end)
     {
         calculate_beam(i, *end, *end, s, FORCE_LEFT);
     };
-    end->stem.beam_off = s;
+    end->stem.beam_off = static_cast<unsigned int>(s);
 }
 
 // let each beam end on the previous note (indicating that the current symbol does not allow beams)
@@ -168,7 +168,7 @@ void BeamInfo::cut(Plate::pVoice::Iterator pnote)
     {
         calculate_beam(i, *pnote, *end, s, FORCE_LEFT);
     };
-    end->stem.beam_off = s;
+    end->stem.beam_off = static_cast<unsigned int>(s);
 }
 
 // create beam information
@@ -239,6 +239,9 @@ void BeamInfo::apply(const Chord&             chord,      // current chord
     else last_chord = NULL;     // erase remembered chord
 }
 
+// default constructor (without voice)
+BeamInfo::BeamInfo() : voice(NULL), beam(), last_pnote(), last_chord(NULL) {}
+
 // constructor
 BeamInfo::BeamInfo(Plate::pVoice& _voice) : voice(&_voice), last_pnote(voice->notes.end()), last_chord(NULL)
 {
@@ -18,6 +18,12 @@
   permissions and limitations under the Licence.
 */
 
+#include <vector>              // std::vector
+#include <cstddef>             // std::ptrdiff_t
+#include <thread>              // std::thread
+#include <atomic>              // std::atomic
+#include <exception>           // std::exception_ptr, std::current_exception, std::rethrow_exception
+
 #include "engraver.hh"         // Engraver
 #include "engraver_state.hh"   // EngraverState
 #include "undefined.hh"        // defines "UNDEFINED" macro, resolving to the largest value "size_t" can contain
@@ -34,18 +40,18 @@ inline int _round(const double d) {return static_cast<int>(d + 0.5);}
 // sprites, being saved to a plate. The target plate as well as the sprite-
 // library are given during the construction.
 // An instance of "EngraverState" is used to iterate and engrave the score.
+// If more than one thread is set, the scores of a document are engraved
+// concurrently into private pagesets, which are merged in document order.
 //
 
 // engrave the on-page attachables
 void Engraver::engrave_attachables(const Document& data)
 {
-    std::list<Pageset::pPage>::iterator p = pageset->pages.begin();
-    unsigned int pageno = 0;
     for (Document::AttachedMap::const_iterator apage = data.attached.begin(); apage != data.attached.end(); ++apage)
     {
+        const Pageset::Iterator p = pageset->get_page(apage->first);
         for (MovableList::const_iterator a = apage->second.begin(); a != apage->second.end(); ++a)
         {
-            while (pageno < apage->first) {++pageno; ++p;};
             p->attached.push_back(Plate::pNote::AttachablePtr(new Plate::pAttachable(
                             **a, Position<mpx_t>(viewport->umtopx_h((*a)->position.co.x),
                                                 viewport->umtopx_v((*a)->position.co.y)))));
@@ -77,17 +83,79 @@ void Engraver::engrave_attachables(const Document& data)
     };
 }
 
+// engrave the scores concurrently
+void Engraver::engrave_parallel(const Document& data)
+{
+    // collect the scores (in document order)
+    std::vector<const Document::Score*> scores;
+    for (std::list<Document::Score>::const_iterator i = data.scores.begin(); i != data.scores.end(); ++i)
+        scores.push_back(&*i);
+    
+    // prepare private pagesets
+    std::vector<Pageset> buffers(scores.size());
+    for (std::vector<Pageset>::iterator i = buffers.begin(); i != buffers.end(); ++i)
+    {
+        i->page_layout = pageset->page_layout;
+        i->head_height = pageset->head_height;
+        i->stem_width  = pageset->stem_width;
+    };
+    
+    // worker (engraving the next unclaimed score, until none is left)
+    std::vector<std::exception_ptr> errors(scores.size());
+    std::vector<Statistics> stats(statistics ? scores.size() : 0);  // (private counters, merged afterwards)
+    std::atomic<size_t> next(0);
+    const auto worker = [&]()
+    {
+        for (size_t idx = next++; idx < scores.size(); idx = next++)
+        {
+            try
+            {
+                EngraverState state(scores[idx]->score, scores[idx]->start_page, buffers[idx], *sprites, data.head_height, parameters, data.style, *viewport);
+                if (statistics) state.set_statistics(&stats[idx]);
+                state.log_set(*this);
+                while (state.engrave_next());
+            }
+            catch (...)
+            {
+                errors[idx] = std::current_exception();
+            };
+        };
+    };
+    
+    // run the worker pool (the calling thread being one of the workers)
+    std::vector<std::thread> pool;
+    const size_t poolsize = (threads < scores.size()) ? threads : scores.size();
+    for (size_t i = 1; i < poolsize; ++i)
+        pool.push_back(std::thread(worker));
+    worker();
+    for (std::vector<std::thread>::iterator i = pool.begin(); i != pool.end(); ++i)
+        i->join();
+    
+    // rethrow the error of the first failed score
+    for (std::vector<std::exception_ptr>::const_iterator i = errors.begin(); i != errors.end(); ++i)
+        if (*i) std::rethrow_exception(*i);
+    
+    // merge the plates into the target pageset (in document order)
+    for (std::vector<Pageset>::iterator i = buffers.begin(); i != buffers.end(); ++i)
+        pageset->merge(*i);
+    for (std::vector<Statistics>::const_iterator i = stats.begin(); i != stats.end(); ++i)
+        statistics->merge(*i);
+}
+
 // constructor (given target-plate and sprite-library)
 Engraver::Engraver(Pageset& _pageset, const Sprites& _sprites, const ViewportParam& _viewport) :
     pageset(&_pageset),
     sprites(&_sprites),
-    viewport(&_viewport) {}
+    viewport(&_viewport),
+    threads(1),
+    statistics(NULL) {}
 
 // engrave the score
 void Engraver::engrave(const Score& score, const StyleParam& style, const size_t start_page, const unsigned int head_height)
 {
     log_debug("engrave (score)");
     EngraverState state(score, start_page, *pageset, *sprites, head_height, parameters, style, *viewport);
+    state.set_statistics(statistics);
     state.log_set(*this);
     while (state.engrave_next());
 }
@@ -97,38 +165,189 @@ void Engraver::engrave(const Score& score, const StyleParam& style, const size_t
     log_debug("engrave (score with reengrave-info)");
     EngraverState state(score, start_page, *pageset, *sprites, head_height, parameters, style, *viewport);
     state.set_reengrave_info(info);
+    state.set_statistics(statistics);
     state.log_set(*this);
     while (state.engrave_next());
 }
 
-// engrave the document
-void Engraver::engrave(const Document& document)
+// engrave the score up to the given page (returns true, if the score is complete)
+bool Engraver::engrave(const Score& score, const StyleParam& style, const size_t start_page, const unsigned int head_height, const size_t end_page)
+{
+    log_debug("engrave (score up to page)");
+    EngraverState state(score, start_page, *pageset, *sprites, head_height, parameters, style, *viewport);
+    state.set_statistics(statistics);
+    state.log_set(*this);
+    while (state.engrave_next() && state.get_target_page().pageno <= end_page);
+    return state.eos();
+}
+
+// on-plate position of a line
+struct LinePos
+{
+    Pageset::PageIt  page;
+    Pageset::PlateIt plateinfo;
+    Plate::LineIt    line;
+    LinePos(Pageset::PageIt p, Pageset::PlateIt i, Plate::LineIt l) : page(p), plateinfo(i), line(l) {}
+};
+
+// collect the score's lines up to the given one (returns false, if the line is not found)
+static bool collect_lines(Pageset& pageset, const Score& score, const Plate::pLine& line, std::vector<LinePos>& lines)
+{
+    for (Pageset::PageIt p = pageset.pages.begin(); p != pageset.pages.end(); ++p)
+    {
+        const Pageset::PlateIt i = p->get_plate_by_score(score);
+        if (i == p->plates.end()) continue;
+        for (Plate::LineIt l = i->plate->lines.begin(); l != i->plate->lines.end(); ++l)
+        {
+            lines.push_back(LinePos(p, i, l));
+            if (&*l == &line) return true;
+        };
+    };
+    return false;
+}
+
+// collect the score's lines up to the last edited one (i.e. the given line or the last one marked as edited)
+// and find the first edited line (returns false, if the given line is not found)
+static bool collect_edited_lines(Pageset& pageset, const Score& score, const Plate::pLine& line, std::vector<LinePos>& lines, size_t& first)
+{
+    bool found = false;
+    size_t last = 0;
+    first = UNDEFINED;
+    for (Pageset::PageIt p = pageset.pages.begin(); p != pageset.pages.end(); ++p)
+    {
+        const Pageset::PlateIt i = p->get_plate_by_score(score);
+        if (i == p->plates.end()) continue;
+        for (Plate::LineIt l = i->plate->lines.begin(); l != i->plate->lines.end(); ++l)
+        {
+            lines.push_back(LinePos(p, i, l));
+            if (&*l == &line) found = true;
+            if (&*l == &line || l->edited)
+            {
+                if (first == UNDEFINED) first = lines.size() - 1;
+                last = lines.size() - 1;
+            };
+        };
+    };
+    if (found) lines.erase(lines.begin() + static_cast<std::ptrdiff_t>(last + 1), lines.end());
+    return found;
+}
+
+// check, if the engraving can be resumed at the given line
+static bool can_resume(const LinePos& pos, const size_t start_page)
+{
+    return    EngraverState::has_checkpoint(*pos.line)
+           && pos.plateinfo->start_page == start_page
+           && (   (pos.plateinfo->pageno == 0 && pos.line == pos.plateinfo->plate->lines.begin())
+               || EngraverState::get_checkpoint(*pos.line).pick.check_subvoices());
+}
+
+// reengrave the score, beginning in front of the first edited line (i.e. the given one or one marked as edited)
+size_t Engraver::reengrave(const Score& score, const StyleParam& style, const size_t start_page, const unsigned int head_height, const Plate::pLine& line, ReengraveInfo& info)
+{
+    log_debug("reengrave (score with reengrave-info)");
+    
+    // collect the score's lines up to the last edited one
+    std::vector<LinePos> lines;
+    size_t idx;
+    const bool found = collect_edited_lines(*pageset, score, line, lines, idx);
+    
+    // resume in front of the first edited line (at a line, where no voice begins with a newline)
+    if (found && idx > 0) --idx;
+    while (found && idx > 0 && (!EngraverState::has_checkpoint(*lines[idx].line) || EngraverState::get_checkpoint(*lines[idx].line).at_newline)) --idx;
+    
+    // engrave the whole score, if the engraving cannot be resumed
+    if (!found || !can_resume(lines[idx], start_page))
+    {
+        engrave(score, style, start_page, head_height, info);
+        return start_page;
+    };
+    
+    // the objects on the lines in front are not reengraved
+    for (size_t i = 0; i < idx; ++i)
+        info.release(*lines[i].line);
+    
+    // reengrave
+    const size_t pageno = lines[idx].page->pageno;
+    EngraverState state(score, *pageset, lines[idx].page, lines[idx].plateinfo, lines[idx].line, &*lines.back().line, *sprites, head_height, parameters, style, *viewport);
+    state.set_reengrave_info(info);
+    state.set_statistics(statistics);
+    state.log_set(*this);
+    while (state.engrave_next());
+    return pageno;
+}
+
+// resume the engraving of the score at the checkpoint of the given line
+void Engraver::resume(const Score& score, const StyleParam& style, const size_t start_page, const unsigned int head_height, const Plate::pLine& line)
+{
+    resume(score, style, start_page, head_height, line, UNDEFINED);
+}
+
+bool Engraver::resume(const Score& score, const StyleParam& style, const size_t start_page, const unsigned int head_height, const Plate::pLine& line, const size_t end_page)
+{
+    log_debug("resume (score)");
+    
+    // find the line
+    std::vector<LinePos> lines;
+    if (!collect_lines(*pageset, score, line, lines) || !can_resume(lines.back(), start_page))
+        return engrave(score, style, start_page, head_height, end_page);
+    
+    // engrave the rest of the score (up to the given page)
+    EngraverState state(score, *pageset, lines.back().page, lines.back().plateinfo, lines.back().line, NULL, *sprites, head_height, parameters, style, *viewport);
+    state.set_statistics(statistics);
+    state.log_set(*this);
+    while (state.engrave_next() && state.get_target_page().pageno <= end_page);
+    return state.eos();
+}
+
+// continue the partial engraving of the score up to the given page (returns true, if the score is complete)
+bool Engraver::proceed(const Score& score, const StyleParam& style, const size_t start_page, const unsigned int head_height, const size_t end_page)
+{
+    // find the last line of the score (i.e. the one following the last engraved page)
+    for (Pageset::Iterator p = pageset->pages.end(); p != pageset->pages.begin();)
+    {
+        const Pageset::PlateIt i = (--p)->get_plate_by_score(score);
+        if (i != p->plates.end() && !i->plate->lines.empty())
+            return resume(score, style, start_page, head_height, i->plate->lines.back(), end_page);
+    };
+    return engrave(score, style, start_page, head_height, end_page);
+}
+
+// prepare the pageset for the document (engraving the on-page attachables, but no scores)
+void Engraver::prepare(const Document& document)
 {
-    log_debug("engrave (document)");
     pageset->clear();
     pageset->page_layout.set(document.page_layout, *viewport);
     pageset->head_height = viewport->umtopx_v(document.head_height);
     pageset->stem_width = viewport->umtopx_h(document.stem_width);
+    engrave_attachables(document);
+}
+
+// engrave the document
+void Engraver::engrave(const Document& document)
+{
+    log_debug("engrave (document)");
+    prepare(document);
     
-    for (std::list<Document::Score>::const_iterator i = document.scores.begin(); i != document.scores.end(); ++i)
+    if (threads > 1 && document.scores.size() > 1)
+    {
+        engrave_parallel(document);     // engrave the scores concurrently
+    }
+    else
     {
-        engrave(i->score, document.style, i->start_page, document.head_height);
+        for (std::list<Document::Score>::const_iterator i = document.scores.begin(); i != document.scores.end(); ++i)
+            engrave(i->score, document.style, i->start_page, document.head_height);
     };
-    engrave_attachables(document);
 }
 
+// (the reengrave-info is shared by all scores, so these are always engraved serially)
 void Engraver::engrave(const Document& document, ReengraveInfo& info)
 {
     log_debug("engrave (document with reengrave-info)");
-    pageset->clear();
-    pageset->page_layout.set(document.page_layout, *viewport);
-    pageset->head_height = viewport->umtopx_v(document.head_height);
-    pageset->stem_width = viewport->umtopx_h(document.stem_width);
+    prepare(document);
     
     for (std::list<Document::Score>::const_iterator i = document.scores.begin(); i != document.scores.end(); ++i)
     {
         engrave(i->score, document.style, i->start_page, document.head_height, info);
     };
-    engrave_attachables(document);
 }
 
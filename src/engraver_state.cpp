@@ -18,7 +18,8 @@
   permissions and limitations under the Licence.
 */
 
-#include <set>                  // std::multiset
+#include <vector>               // std::vector
+#include <algorithm>            // std::stable_sort
 
 #include "engraver_state.hh"    // EngraverState
 #include "undefined.hh"         // defines "UNDEFINED" macro, resolving to the largest value "size_t" can contain
@@ -44,30 +45,31 @@ void EngraverState::engrave()
     // set "pvoice" corresponding to the current pick
     const Pick::VoiceCursor& cursor = pick.get_cursor();
     if (cursor.at_end()) {log_warn("Cursor at end during engraving process. (class: EngraverState)"); return;};
+    SCOREPRESS_COUNT(statistics, VIRTUALS, cursor.inserted ? 1 : 0);  // count the virtual objects
     
     // get the voice on the plate
-    VoiceMap::iterator pvoice_it = voiceinfo.find(&cursor.voice());
-    if (pvoice_it != voiceinfo.end())
+    if (cursor.voice_id >= voiceinfo.size()) voiceinfo.resize(cursor.voice_id + 1, pline->voices.end());
+    if (voiceinfo[cursor.voice_id] != pline->voices.end())
     {
-        pvoice = pvoice_it->second;
+        pvoice = voiceinfo[cursor.voice_id];
     }
     else
     {
         // search, where to insert the new on-plate voice
         Plate::VoiceIt next_pvoice = pline->voices.begin();
-        while (next_pvoice != pline->voices.end() && pick.is_above(next_pvoice->begin.voice(), cursor.voice()))
+        while (next_pvoice != pline->voices.end() && pick.is_above(pick.get_voice_id(next_pvoice->begin.voice()), cursor.voice_id))
             ++next_pvoice;
         
         // insert the new voice
-        pvoice = pline->voices.insert(next_pvoice, Plate::pVoice(cursor));
-        pvoice_it = voiceinfo.insert(VoiceMap::value_type(&cursor.voice(), pvoice)).first;
+        pvoice = pline->voices.insert(next_pvoice, Plate::pVoice(cursor, plate->get_allocator()));
+        voiceinfo[cursor.voice_id] = pvoice;
         pvoice->parent = cursor.parent;
         
         // search for the context
         bool got_ctx = false;               // set to true, if context is found
         if (pline != plate->lines.begin())  // if there is a previous line
         {                                   //     look there for the voice
-            std::list<Plate::pVoice>::iterator prevoice = (--pline)->get_voice(cursor.voice());
+            Plate::VoiceList::iterator prevoice = (--pline)->get_voice(cursor.voice());
             if (prevoice != pline->voices.end())    // and if it exists
             {
                 pvoice->context = prevoice->context;    // copy the context
@@ -81,7 +83,7 @@ void EngraverState::engrave()
         // check in the parent voice
         if (!got_ctx && cursor.is_sub())    // if no context found and parent-voice exists
         {
-            std::list<Plate::pVoice>::iterator parent;          // parent voice
+            Plate::VoiceList::iterator parent;          // parent voice
             parent = pline->get_voice(cursor.parent.voice());   // get parent
             
             if (parent != pline->voices.end())          // if we got the parent voice
@@ -140,7 +142,7 @@ void EngraverState::engrave()
     pnote = pvoice->append(pos, cursor);    // append the new note to the plate
     if (cursor.virtual_obj)                 // set virtual object
     {
-        pnote->virtual_obj = Plate::pNote::VirtualPtr(new Plate::pNote::Virtual(*cursor.virtual_obj, cursor.inserted));
+        pnote->virtual_obj.set(*cursor.virtual_obj, cursor.inserted);
     };
     
     // engrave object (polymorphically call "StaffObject::engrave")
@@ -157,7 +159,7 @@ void EngraverState::engrave()
             if (!(*i)->ctxchange()) continue;
             if (!(*i)->ctxchange()->permanent) continue;
             
-            for (std::list<Plate::pVoice>::iterator j = pline->voices.begin(); j != pline->voices.end(); ++j)
+            for (Plate::VoiceList::iterator j = pline->voices.begin(); j != pline->voices.end(); ++j)
             {
                 j->context.modify(*(*i)->ctxchange(),
                     ((*i)->ctxchange()->volume_scope == ContextChanging::SCORE) ||
@@ -182,12 +184,12 @@ void EngraverState::engrave()
             
             // search, where to insert the new on-plate voice
             Plate::VoiceIt next_pvoice = pline->voices.begin();
-            while (next_pvoice != pline->voices.end() && pick.is_above(next_pvoice->begin.voice(), cursor.voice()))
+            while (next_pvoice != pline->voices.end() && pick.is_above(pick.get_voice_id(next_pvoice->begin.voice()), cursor.voice_id))
                 ++next_pvoice;
             
             // insert the new voice
             Plate::VoiceIt parent(pvoice);
-            pvoice = pline->voices.insert(next_pvoice, Plate::pVoice(const_Cursor(cursor.staff(), **subvoice)));
+            pvoice = pline->voices.insert(next_pvoice, Plate::pVoice(const_Cursor(cursor.staff(), **subvoice), plate->get_allocator()));
             pvoice->context = parent->context;
             
             // add position information to the new voice
@@ -197,7 +199,7 @@ void EngraverState::engrave()
             pvoice->head_height = _round(viewport->umtopx_v(HEAD_HEIGHT(cursor.staff())));
             
             // add end-of-voice indicator object
-            pvoice->notes.push_back(Plate::pNote(pnote->absolutePos.front(), pvoice->begin));
+            pvoice->notes.push_back(Plate::pNote(pnote->absolutePos.front(), pvoice->begin, plate->get_allocator()));
             pvoice->notes.back().gphBox.pos = pvoice->notes.back().absolutePos.front();
             pvoice->notes.back().gphBox.width = 1000;
             pvoice->notes.back().gphBox.height = _round(viewport->umtopx_v( (cursor.staff().line_count - 1)
@@ -217,7 +219,7 @@ void EngraverState::engrave()
     // remember engraved symbol
     if (cursor->is(Class::BARLINE))     // barlines will be remembered by all voices
     {
-        for (std::list<Plate::pVoice>::iterator v = pline->voices.begin(); v != pline->voices.end(); ++v)
+        for (Plate::VoiceList::iterator v = pline->voices.begin(); v != pline->voices.end(); ++v)
         {
             v->context.set_buffer(&pnote->get_note());
             v->context.set_buffer_xpos(pnote->gphBox.right());
@@ -251,13 +253,12 @@ void EngraverState::engrave()
              && !cursor->is(Class::NEWLINE) && pick.eov())
     {
         // check dangling ties
-        if (!tieinfo[&cursor.voice()].empty())
+        if (!get_voice_ties().empty())
             log_warn("Got tie exceeding the end of the voice. (class: EngraverState)");
-        BeamInfoMap::iterator i = beaminfo.find(&*pvoice);
-        if (i != beaminfo.end()) i->second.finish();
+        if (cursor.voice_id < beaminfo.size()) beaminfo[cursor.voice_id].finish();
         
         // add end-of-voice indicator object
-        pvoice->notes.push_back(Plate::pNote(pos, cursor));
+        pvoice->notes.push_back(Plate::pNote(pos, cursor, plate->get_allocator()));
         pvoice->notes.back().note.to_end();
         if (cursor->is(Class::BARLINE))
             pvoice->notes.back().gphBox.pos.x = pnote->gphBox.pos.x + 1;
@@ -273,8 +274,10 @@ void EngraverState::engrave()
 // calculate line-end information/line's rightmost border (see "Plate::pLine::line_end")
 void EngraverState::create_lineend()
 {
+    SCOREPRESS_TIME(statistics, LINEEND);
+    
     // iterate through the voices
-    for (std::list<Plate::pVoice>::iterator voice = pline->voices.begin(); voice != pline->voices.end(); ++voice)
+    for (Plate::VoiceList::iterator voice = pline->voices.begin(); voice != pline->voices.end(); ++voice)
     {
         if (voice->notes.empty()) continue; // check if voice contains notes
         
@@ -283,33 +286,38 @@ void EngraverState::create_lineend()
             pline->line_end = voice->notes.back().gphBox.right();
     };
     
-    // break unfinished ties
-    for (std::list<Plate::pVoice>::iterator voice = pline->voices.begin(); voice != pline->voices.end(); ++voice)
+    // break unfinished ties (of the voices known to the pick; i.e. not the empty ones)
+    size_t id;
+    for (Plate::VoiceList::iterator voice = pline->voices.begin(); voice != pline->voices.end(); ++voice)
     {
-        break_ties(tieinfo[&voice->begin.voice()],
+        if (!pick.find_voice(voice->begin.voice(), id) || id >= tieinfo.size()) continue;
+        break_ties(tieinfo[id],
                    pline->line_end,
                    pick.eos() ? 0 : pick.get_indent(),
                    voice->head_height);
     };
     
-    // clear voice-map
+    // clear voice- and beam-map (beams do not exceed the line)
     voiceinfo.clear();
+    beaminfo.clear();
 }
 
 // apply all non-accumulative offsets
 void EngraverState::apply_offsets()
 {
+    SCOREPRESS_TIME(statistics, OFFSETS);
+    
     // iterate the voices
-    for (std::list<Plate::pVoice>::iterator voice = pline->voices.begin(); voice != pline->voices.end(); ++voice)
+    for (Plate::VoiceList::iterator voice = pline->voices.begin(); voice != pline->voices.end(); ++voice)
     {
         // iterate the voice
-        for (std::list<Plate::pNote>::iterator it = voice->notes.begin(); it != voice->notes.end(); ++it)
+        for (Plate::NoteList::iterator it = voice->notes.begin(); it != voice->notes.end(); ++it)
         {
             if (it->at_end() || it->is_inserted() || !it->get_note().is(Class::VISIBLEOBJECT)) continue;
             
             if (it->get_note().get_visible().offset_x)
             {
-                const mpx_t head_width = (sprites->head_width(it->sprite) * voice->head_height) / sprites->head_height(it->sprite);
+                const mpx_t head_width = metrics.get(it->sprite.setid, static_cast<mpx_t>(voice->head_height)).mpx_head_width;
                 it->add_offset((it->get_note().get_visible().offset_x * head_width) / 1000);
             };
         };
@@ -329,6 +337,8 @@ inline static bool is_above(const Position<mpx_t>& p, const Position<mpx_t>& p1,
 // engrave all stems within beams in the current line
 void EngraverState::engrave_stems()
 {
+    SCOREPRESS_TIME(statistics, STEMS);
+    
     bool          got_beam(false);  // indicating notes with beam
     mpx_t         x1(0), y1(0);     // beam coordinates
     double        slope(0.0);       // beam slope
@@ -360,14 +370,15 @@ void EngraverState::engrave_stems()
                 if ((pnote->stem.base > top) != (pnote->stem.base > pnote->stem.top))
                 {
                     // correct stem position
-                    const SpriteInfo& headsprite = (*sprites)[pnote->sprite];       // get sprite-info
-                    const double scale = pvoice->head_height / (sprites->head_height(pnote->sprite) * 1000.0);
+                    const SpriteMetrics& set = metrics.get(pnote->sprite.setid, static_cast<mpx_t>(pvoice->head_height));
+                    const SpriteMetrics::Metrics& headsprite = set[pnote->sprite.spriteid];     // get sprite metrics
+                    const double scale = set.scale;
                     const unsigned int app_scale = pnote->get_note().get_visible().appearance.scale;
                     const mpx_t stem_width = viewport->umtopx_h(style->stem_width); // get stem width
-                    const mpx_t sprite_width = _round(headsprite.width * scale * app_scale);
+                    const mpx_t sprite_width = _round(headsprite.width * app_scale);
                     Position<mpx_t> stem;                                           // stem position
-                    stem.x = _round(headsprite.get_real("stem.x") * scale * app_scale);
-                    stem.y = _round(headsprite.get_real("stem.y") * scale * app_scale);
+                    stem.x = _round(headsprite.stem_x * app_scale);
+                    stem.y = _round(headsprite.stem_y * app_scale);
                     
                     if (pnote->stem.base > top)     // an upward stem is right of the chord
                     {
@@ -378,7 +389,7 @@ void EngraverState::engrave_stems()
                         
                         pnote->stem.top = _round(y1 + (pnote->stem.x - x1) * slope);
                         pnote->stem.base = pnote->stem_info->base_pos + (pnote->stem_info->base_side ?
-                            _round(((headsprite.height * scale * app_scale - stem.y) * pnote->stem_info->base_scale) / 1000.0) :
+                            _round(((headsprite.height * app_scale - stem.y) * pnote->stem_info->base_scale) / 1000.0) :
                             stem.y);
                     };
                     
@@ -390,7 +401,7 @@ void EngraverState::engrave_stems()
                         pnote->stem.top = _round(y1 + (pnote->stem.x - x1) * slope);
                         pnote->stem.base = pnote->stem_info->top_pos + (pnote->stem_info->top_side ?
                             stem.y :
-                            _round(((headsprite.height * scale * app_scale - stem.y) * pnote->stem_info->top_scale) / 1000.0));
+                            _round(((headsprite.height * app_scale - stem.y) * pnote->stem_info->top_scale) / 1000.0));
                     };
                     
                     pnote->gphBox.extend(Position<mpx_t>(pnote->stem.x, pnote->stem.top));
@@ -398,14 +409,14 @@ void EngraverState::engrave_stems()
                 else pnote->stem.top = _round(top);
                 
                 // on the end of the beam
-                if (beam_it->beam[VALUE_BASE - 3]->end == &*pnote)
+                if (beam_it->beam[VALUE_BASE - 3].end == &*pnote)
                 {
                     got_beam = false;   // reset beam indicator
                 };
             };
             
             // on beam's begin
-            if (!got_beam && pnote->beam[VALUE_BASE - 3])
+            if (!got_beam && pnote->beam[VALUE_BASE - 3].end)
             {
                 // prepare beam data
                 pnote->beam_begin = pnote;  // set on-plate begin iterator
@@ -415,8 +426,8 @@ void EngraverState::engrave_stems()
                 y1 = pnote->stem.top;
                 
                 // calculate correct slope
-                const mpx_t x2 = pnote->beam[VALUE_BASE - 3]->end->stem.x;
-                const mpx_t y2 = pnote->beam[VALUE_BASE - 3]->end->stem.top;
+                const mpx_t x2 = pnote->beam[VALUE_BASE - 3].end->stem.x;
+                const mpx_t y2 = pnote->beam[VALUE_BASE - 3].end->stem.top;
                 const Chord& chord = static_cast<const Chord&>(*pnote->note);
                 
                 switch (chord.stem.slope_type)
@@ -465,12 +476,12 @@ void EngraverState::engrave_stems()
                 {
                     // adjust front stem length, if the last-notes stem-direction would be switched
                     const double min_stemlen = (style->stem_length_min / 1000.0) * pvoice->head_height;
-                    const double end_stemlen = y1 + slope - pnote->beam[VALUE_BASE - 3]->end->stem_info->base_pos;
-                    if (end_stemlen < min_stemlen && !(pnote->beam[VALUE_BASE - 3]->end->stem.is_up()))
+                    const double end_stemlen = y1 + slope - pnote->beam[VALUE_BASE - 3].end->stem_info->base_pos;
+                    if (end_stemlen < min_stemlen && !(pnote->beam[VALUE_BASE - 3].end->stem.is_up()))
                     {
                         y1 = pnote->stem.top += _round( min_stemlen - end_stemlen);
                     }
-                    else if (end_stemlen > -min_stemlen && (pnote->beam[VALUE_BASE - 3]->end->stem.is_up()))
+                    else if (end_stemlen > -min_stemlen && (pnote->beam[VALUE_BASE - 3].end->stem.is_up()))
                     {
                         y1 = pnote->stem.top += _round(-min_stemlen - end_stemlen);
                     };
@@ -516,7 +527,7 @@ void EngraverState::engrave_stems()
         for (pnote = pvoice->notes.begin(); pnote != pvoice->notes.end(); ++pnote)
         {
             // on beam's begin
-            if (!got_beam && pnote->beam[VALUE_BASE - 3])
+            if (!got_beam && pnote->beam[VALUE_BASE - 3].end)
             {
                 beam_it = pnote;            // set begin iterator
                 got_beam = true;            // set beam indicator
@@ -539,15 +550,21 @@ void EngraverState::engrave_stems()
                            + pnote->stem.beam_off * (style->beam_height + style->beam_distance))
                         / 1000.0);
                 
-                got_beam = (beam_it->beam[VALUE_BASE - 3]->end != &*pnote); // update beam indicator
+                got_beam = (beam_it->beam[VALUE_BASE - 3].end != &*pnote); // update beam indicator
             };
         };
+        
+        // release the temporary stem information
+        for (pnote = pvoice->notes.begin(); pnote != pvoice->notes.end(); ++pnote)
+            free(pnote->stem_info);
     };
 }
 
 // engrave all attachables within a given line
 void EngraverState::engrave_attachables()
 {
+    SCOREPRESS_TIME(statistics, ATTACHABLES);
+    
     std::list<DurableInfo> durableinfo; // information for all durable objects
     const VisibleObject* visible;       // visible object reference
     
@@ -691,12 +708,14 @@ mpx_t curlybrace_width(const double s,      // scale [mpx/svg]
 // engrave braces and brackets for the current line
 void EngraverState::engrave_braces()
 {
+    SCOREPRESS_TIME(statistics, BRACES);
+    
     // local iterators
-    std::list<Plate::pVoice>::iterator curlybrace_begin = pline->voices.end(); // curly brace begin
-    std::list<Plate::pVoice>::iterator curlybrace_end   = pline->voices.end(); // curly brace end
-    std::list<Plate::pVoice>::iterator bracket_begin    = pline->voices.end(); // bracket begin
-    std::list<Plate::pVoice>::iterator bracket_end      = pline->voices.end(); // bracket end
-    std::list<Plate::pVoice>::iterator tvoice;                                 // temporary
+    Plate::VoiceList::iterator curlybrace_begin = pline->voices.end(); // curly brace begin
+    Plate::VoiceList::iterator curlybrace_end   = pline->voices.end(); // curly brace end
+    Plate::VoiceList::iterator bracket_begin    = pline->voices.end(); // bracket begin
+    Plate::VoiceList::iterator bracket_end      = pline->voices.end(); // bracket end
+    Plate::VoiceList::iterator tvoice;                                 // temporary
     
     // sprites
     SpriteId brace_sprite =
@@ -753,8 +772,8 @@ void EngraverState::engrave_braces()
                 curlybrace_width(brace_scale,
                                  curlybrace_begin->brace.gphBox.height,
                                  (*sprites)[brace_sprite].width,
-                                 (*sprites)[brace_sprite].get_real("hmin"), (*sprites)[brace_sprite].get_real("hmax"),
-                                 (*sprites)[brace_sprite].get_real("low"),  (*sprites)[brace_sprite].get_real("high"));
+                                 (*sprites)[brace_sprite].get_real(ATOM_HMIN), (*sprites)[brace_sprite].get_real(ATOM_HMAX),
+                                 (*sprites)[brace_sprite].get_real(ATOM_LOW),  (*sprites)[brace_sprite].get_real(ATOM_HIGH));
                                  
             curlybrace_begin->brace.gphBox.pos = curlybrace_begin->basePos;
             curlybrace_begin->brace.gphBox.pos.x -= curlybrace_begin->brace.gphBox.width + viewport->umtopx_h(staff->brace_pos);
@@ -784,7 +803,7 @@ void EngraverState::engrave_braces()
             bracket_begin->bracket.line_end = bracket_begin->basePos;
             bracket_begin->bracket.line_end.x -= viewport->umtopx_h(staff->bracket_pos);
             bracket_begin->bracket.line_base = bracket_begin->bracket.line_end;
-            bracket_begin->bracket.line_base.x -= _round(bracket_scale * (*sprites)[bracket_sprite].get_real("linewidth"));
+            bracket_begin->bracket.line_base.x -= _round(bracket_scale * (*sprites)[bracket_sprite].get_real(ATOM_LINEWIDTH));
             bracket_begin->bracket.line_end.y =
                  (bracket_end->basePos.y
                 + viewport->umtopx_v(HEAD_HEIGHT(bracket_end->begin.staff()) * (bracket_end->begin.staff().line_count - 1))
@@ -830,32 +849,34 @@ void EngraverState::engrave_braces()
 // justification information
 struct SCOREPRESS_LOCAL DistanceData
 {
-    mutable mpx_t begin;    // empty space in front of the note
-            mpx_t pos;      // position of the note
-    mutable mpx_t end;      // end of the graphical object (start of the next empty space)
-    mutable mpx_t dist;     // distance available for scaling
-    
-    mutable std::string tag;
+    mpx_t  begin;   // empty space in front of the note
+    mpx_t  pos;     // position of the note
+    mpx_t  end;     // end of the graphical object (start of the next empty space)
+    mpx_t  dist;    // distance available for scaling
+    size_t voice;   // index of the voice within the line
     
-    Plate::pVoice* const src;
-    
-    DistanceData(Plate::pVoice* v, mpx_t p) : pos(p), src(v) {}
+    DistanceData(size_t v, mpx_t b, mpx_t p, mpx_t e) : begin(b), pos(p), end(e), dist(p - b), voice(v) {}
     inline bool operator < (const DistanceData& data) const {return pos < data.pos;}
 };
 
+inline static bool _voice_order(const DistanceData& d1, const DistanceData& d2) {return d1.voice < d2.voice;}
+
 // graphical mask (union over the line)
 struct SCOREPRESS_LOCAL GraphicData
 {
-            mpx_t pos;  // gphBox.pos.x
-    mutable mpx_t end;  // gphBox.right
+    mpx_t pos;  // gphBox.pos.x
+    mpx_t end;  // gphBox.right
     
     GraphicData(mpx_t p, mpx_t e) : pos(p), end(e) {}
     inline bool operator < (const GraphicData& data) const {return pos < data.pos;}
 };
 
 // justify the given line to fit into the score-area
+// (the data of all voices is kept in flat arrays, sorted by position; equal positions keep the voice order)
 void EngraverState::justify_line()
 {
+    SCOREPRESS_TIME(statistics, JUSTIFY);
+    
     // initialization and check
     mpx_t width = pline->line_end - pline->basePos.x;               // current line width
     mpx_t diff  = viewport->umtopx_h(lineinfo.dimension->width)     // space to be added
@@ -864,54 +885,62 @@ void EngraverState::justify_line()
     if ((1000 * diff) / width > mpx_t(param->max_justification) - 1000) return;
     
     // prepare justification data
-    std::multiset<DistanceData>     dists;          // interleaved distance information
-    std::multiset<GraphicData>      gphs;           // merged graphical information
-    std::map<Plate::pVoice*, mpx_t> dists_sum;      // sum of available distance
-    mpx_t                           dist_sum = 0;   // total of available distances
+    std::vector<DistanceData> dists;            // interleaved distance information
+    std::vector<GraphicData>  gphs;             // merged graphical information
+    std::vector<mpx_t>        dists_sum;        // sum of available distance (for each voice)
+    mpx_t                     dist_sum = 0;     // total of available distances
     
     // calculate distances for each voice
     {
-    std::multiset<DistanceData>::iterator tgt;
-    for (Plate::pLine::Iterator voice = pline->voices.begin(); voice != pline->voices.end(); ++voice)
+    size_t count = 0;
+    for (Plate::pLine::const_Iterator voice = pline->voices.begin(); voice != pline->voices.end(); ++voice)
+        count += voice->notes.size();
+    dists.reserve(count);
+    gphs.reserve(count);
+    
+    size_t idx = 0;
+    for (Plate::pLine::const_Iterator voice = pline->voices.begin(); voice != pline->voices.end(); ++voice, ++idx)
     {
-        // setup sum
-        dists_sum[&*voice] = 0;
-        
         // iterate the voice
         mpx_t npos = pline->basePos.x + viewport->umtopx_h(param->min_distance);
         for (Plate::pVoice::const_Iterator it = voice->notes.begin(); it != voice->notes.end(); ++it)
         {
-            tgt = dists.insert(DistanceData(&*voice, it->gphBox.pos.x));
-            tgt->begin = npos;
-            tgt->end   = npos = (lineinfo.forced_justification)
-                                ? it->gphBox.right()
-                                : it->gphBox.right() + viewport->umtopx_h(param->min_distance);
-            tgt->dist  = tgt->pos - tgt->begin;
-            tgt->tag   = (!it->at_end()) ? classname(it->get_note().classtype()) : "EOV";
-            gphs.insert(GraphicData(it->gphBox.pos.x, npos));
+            const mpx_t begin = npos;
+            npos = (lineinfo.forced_justification) ? it->gphBox.right()
+                                                   : it->gphBox.right() + viewport->umtopx_h(param->min_distance);
+            dists.push_back(DistanceData(idx, begin, it->gphBox.pos.x, npos));
+            gphs.push_back(GraphicData(it->gphBox.pos.x, npos));
         };
     };
+    dists_sum.resize(idx, 0);
+    std::stable_sort(dists.begin(), dists.end());
+    std::stable_sort(gphs.begin(), gphs.end());
     }
     
-    // merge graphic data
+    // merge graphic data (overlapping objects are joined into the preceding one)
     {
     mpx_t npos = 0;
-    for (std::multiset<GraphicData>::iterator it = gphs.begin(); it != gphs.end(); ++it)
+    std::vector<GraphicData>::iterator out = gphs.begin();  // end of the merged data
+    for (std::vector<GraphicData>::const_iterator it = gphs.begin(); it != gphs.end(); ++it)
     {
-        if (it->pos < npos)
+        if (it->pos < npos && out != gphs.begin())
         {
             if (npos < it->end)
-                ((--it)++)->end = npos = it->end;
-            gphs.erase(it--);
+                (out - 1)->end = npos = it->end;
         }
-        else npos = it->end;
+        else
+        {
+            *out++ = *it;
+            npos = it->end;
+        };
     };
+    gphs.erase(out, gphs.end());
     }
     
     // remove graphical data from available spaces ("punch holes")
     {
-    std::multiset<GraphicData>::iterator git = gphs.begin();
-    for (std::multiset<DistanceData>::iterator it = dists.begin(); it != dists.end(); ++it)
+    std::vector<GraphicData>::const_iterator git = gphs.begin();
+    for (std::vector<DistanceData>::iterator it = dists.begin(); it != dists.end(); ++it)
     {
         if (git == gphs.end()) --git;
         while (git->end > it->begin && git != gphs.begin()) --git;
@@ -934,14 +963,17 @@ void EngraverState::justify_line()
                 break;
         };
         if (it->dist < 0) it->dist = 0;
-        dists_sum[&*it->src] += it->dist;
+        dists_sum[it->voice] += it->dist;
     };
     }
     
     // check distance sum
-    for (std::map<Plate::pVoice*, mpx_t>::const_iterator i = dists_sum.begin(); i != dists_sum.end(); ++i)
-        if (i->second > dist_sum)
-            dist_sum = i->second;
+    for (std::vector<mpx_t>::const_iterator i = dists_sum.begin(); i != dists_sum.end(); ++i)
+        if (*i > dist_sum)
+            dist_sum = *i;
+    
+    // group the distances by voice (keeping their order within the voice)
+    std::stable_sort(dists.begin(), dists.end(), _voice_order);
     
     // execute justification
     if (diff < -dist_sum) diff = -dist_sum; // do not force overlapping
@@ -953,6 +985,7 @@ void EngraverState::justify_line()
     mpx_t offset;       // current offset
     bool  pre_tie;      // indicating the second part of a broken tie
     bool  got_tie;      // indicating the first  part of a broken tie
+    std::vector<DistanceData>::const_iterator data_it = dists.begin();  // distance data (of the current note)
     for (Plate::pLine::Iterator voice = pline->voices.begin(); voice != pline->voices.end(); ++voice)
     {
         // initialize
@@ -962,11 +995,8 @@ void EngraverState::justify_line()
         got_tie  = false;
         
         // iterate the voice
-        Plate::pVoice::Iterator               note_it = voice->notes.begin();
-        std::multiset<DistanceData>::iterator data_it = dists.begin();
-        for (; note_it != voice->notes.end(); ++note_it, ++data_it)
+        for (Plate::pVoice::Iterator note_it = voice->notes.begin(); note_it != voice->notes.end(); ++note_it, ++data_it)
         {
-            while (data_it->src != &*voice) ++data_it;              // move to correct data element
             prev_offset = offset;                                   // save previous offset
             distance += data_it->dist;
             offset = _round((double(diff) * distance) / dist_sum);  // calculate offset
@@ -1040,12 +1070,16 @@ EngraverState::EngraverState(const Score&         _score,
                                                                default_style(_style),
                                                                viewport(&_viewport),
                                                                reengrave_info(NULL),
-                                                               pick(_score, (!!_score.param) ? *_score.param : _param, _viewport, _sprites, def_head_height),
+                                                               statistics(NULL),
+                                                               metrics(_sprites),
+                                                               pick(_score, (!!_score.param) ? *_score.param : _param, _viewport, metrics, def_head_height),
                                                                pageset(&_pageset),
                                                                pagecnt(0),
                                                                barcnt(0),
                                                                start_time(0),
-                                                               end_time(0)
+                                                               end_time(0),
+                                                               resume(false),
+                                                               dirty_line(NULL)
 {
     // prepare the pageset
     pageset->erase(_score);         // erase the plates
@@ -1064,20 +1098,106 @@ EngraverState::EngraverState(const Score&         _score,
     start_time = pick.get_cursor().time;
     
     // prepare the plate
-    plate->lines.push_back(Plate::pLine());     // push first line
+    plate->lines.push_back(Plate::pLine(plate->get_allocator()));   // push first line
     pline = plate->lines.begin();               // initialize target line iterator
     pline->basePos.x = pick.get_indent();       // set the base-position of the new line (checked with new voice)
     pline->basePos.y = pick.get_cursor().ypos + viewport->umtopx_v(pick.staff_offset(_score.staves.front()));
     
     // create default clef
     Clef clef;
-    const std::map<std::string, size_t>::const_iterator sprite = (*sprites)[0].ids.find("clef.treble");
+    const AtomMap<size_t>::const_iterator sprite = (*sprites)[0].ids.find("clef.treble");
     clef.sprite = SpriteId(0, sprite->second);
-    clef.base_note = static_cast<tone_t>((*sprites)[0][sprite->second].get_integer("basenote"));
-    clef.line = static_cast<unsigned char>((*sprites)[0][sprite->second].get_integer("line"));
-    clef.keybnd_sharp = static_cast<tone_t>((*sprites)[0][sprite->second].get_integer("keybound.sharp"));
-    clef.keybnd_flat = static_cast<tone_t>((*sprites)[0][sprite->second].get_integer("keybound.flat"));
+    clef.base_note = static_cast<tone_t>((*sprites)[0][sprite->second].get_integer(ATOM_BASENOTE));
+    clef.line = static_cast<unsigned char>((*sprites)[0][sprite->second].get_integer(ATOM_LINE));
+    clef.keybnd_sharp = static_cast<tone_t>((*sprites)[0][sprite->second].get_integer(ATOM_KEYBOUND_SHARP));
+    clef.keybnd_flat = static_cast<tone_t>((*sprites)[0][sprite->second].get_integer(ATOM_KEYBOUND_FLAT));
     pline->staffctx[&get_staff()].modify(clef);
+    
+    // record the initial state
+    record_checkpoint();
+}
+
+// constructor (will resume the engraving at the given line, holding the following lines for convergence;
+//              without dirty line, the following engraving of the score is discarded)
+EngraverState::EngraverState(const Score&         _score,
+                                   Pageset&       _pageset,
+                             Pageset::PageIt      _page,
+                             Pageset::PlateIt     _plateinfo,
+                             Plate::LineIt        _line,
+                             const Plate::pLine*  _dirty_line,
+                             const Sprites&       _sprites,
+                             const unsigned int   _head_height,
+                             const EngraverParam& _param,
+                             const StyleParam&    _style,
+                             const ViewportParam& _viewport) : sprites(&_sprites),
+                                                               def_head_height(_score.head_height ? _score.head_height : _head_height),
+                                                               param((!!_score.param) ? &*_score.param : &_param),
+                                                               style(&_style),
+                                                               default_style(_style),
+                                                               viewport(&_viewport),
+                                                               reengrave_info(NULL),
+                                                               statistics(NULL),
+                                                               spaceinfo(get_checkpoint(*_line).spaceinfo),
+                                                               lineinfo(get_checkpoint(*_line).lineinfo),
+                                                               metrics(_sprites),
+                                                               pick((get_checkpoint(*_line).pagecnt == 0 && _line == _plateinfo->plate->lines.begin())
+                                                                        ? Pick(_score, (!!_score.param) ? *_score.param : _param, _viewport, metrics, def_head_height)
+                                                                        : get_checkpoint(*_line).pick),
+                                                               pageset(&_pageset),
+                                                               page(_page),
+                                                               plateinfo(_plateinfo),
+                                                               plate(_plateinfo->plate),
+                                                               pagecnt(get_checkpoint(*_line).pagecnt),
+                                                               barcnt(get_checkpoint(*_line).barcnt),
+                                                               start_time(get_checkpoint(*_line).start_time),
+                                                               end_time(get_checkpoint(*_line).end_time),
+                                                               resume(true),
+                                                               held_lines(_plateinfo->plate->lines.get_allocator()),
+                                                               dirty_line(_dirty_line)
+{
+    // bind the recorded pick to the metrics of this engraving
+    pick.set_metrics(metrics);
+    
+    // restore the tie-information (indexed by the voice ids of the pick)
+    const TieInfoMap& ties = get_checkpoint(*_line).tieinfo;
+    for (TieInfoMap::const_iterator i = ties.begin(); i != ties.end(); ++i)
+    {
+        const size_t voice = pick.get_voice_id(*i->first);
+        if (voice >= tieinfo.size()) tieinfo.resize(voice + 1);
+        tieinfo[voice] = i->second;
+    };
+    
+    // hold the previous engraving (beginning with the given line)
+    held_lines.splice(held_lines.end(), plate->lines, _line, plate->lines.end());
+    for (Pageset::PageIt p = page; ++p != pageset->pages.end();)
+    {
+        const Pageset::PlateIt i = p->get_plate_by_score(_score);
+        if (i != p->plates.end()) held_plates.splice(held_plates.end(), p->plates, i);
+    };
+    
+    // restore the line as it was before being engraved
+    plate->lines.push_back(get_checkpoint(*_line).line);
+    pline = --plate->lines.end();
+    
+    // on the first line of the score, the objects in front of the recorded pick may have been edited
+    // (so the pick is restarted at the score's beginning, see above)
+    if (pagecnt == 0 && pline == plate->lines.begin())
+    {
+        lineinfo.dimension = &pick.get_dimension();
+        lineinfo.indent = pick.get_indent();
+        lineinfo.justify = pick.get_justify();
+        lineinfo.forced_justification = pick.get_forced_justification();
+        lineinfo.right_margin = pick.get_right_margin();
+        start_time = pick.get_cursor().time;
+        pline->basePos.x = pick.get_indent();
+        pline->basePos.y = pick.get_cursor().ypos + viewport->umtopx_v(pick.staff_offset(_score.staves.front()));
+    };
+    
+    // discard the previous engraving, if there is nothing to converge with
+    if (!dirty_line) finish_resume();
+    
+    // record the restored checkpoint
+    record_checkpoint();
 }
 
 // get the staff, in which the note is drawn (i.e. apply staff-shift)
@@ -1093,10 +1213,13 @@ bool EngraverState::engrave_next()
     if (pick.eos()) return false;
     
     // engrave current object
-    engrave();
-    
-    // calculate data for the next note
-    pick.next(pnote->gphBox.width);
+    {
+        SCOREPRESS_TIME(statistics, PICK);
+        engrave();
+        
+        // calculate data for the next note
+        pick.next(pnote->gphBox.width);
+    };
     
     // quit here, if there's no newline (and no end of score)
     if (!pick.eos() && !pick.get_cursor()->is(Class::NEWLINE)) return true;
@@ -1107,6 +1230,8 @@ bool EngraverState::engrave_next()
     // engrave all newlines at once
     while (!pick.eos())
     {
+        SCOREPRESS_TIME(statistics, PICK);
+        
         // insert automatic clef, key and time signature
         if (pick.get_cursor().is_main())
         {
@@ -1140,21 +1265,43 @@ bool EngraverState::engrave_next()
     engrave_attachables();          // engrave all the line's attached objects
     pline->calculate_gphBox();      // calculate the graphical boundary box
     
+#ifdef STATISTICS
+    // count the engraved objects
+    if (statistics)
+    {
+        statistics->count(Statistics::LINES);
+        for (Plate::VoiceIt v = pline->voices.begin(); v != pline->voices.end(); ++v)
+        {
+            statistics->count(Statistics::NOTES, v->notes.size());
+            for (Plate::NoteIt n = v->notes.begin(); n != v->notes.end(); ++n)
+                statistics->count(Statistics::ATTACHED, n->attached.size());
+        };
+    };
+#endif
+    
     // exit here, if no newline (below is the code for newline handling)
-    if (!newline) return false;
+    if (!newline)
+    {
+        if (resume) finish_resume();    // discard the rest of the previous engraving
+        return false;
+    };
     
     // check for pagebreak
     if (pagebreak)
     {
         if (++page == pageset->pages.end())
             page = pageset->add_page();
-        page->plates.push_back(Pageset::PlateInfo(++pagecnt, plateinfo->start_page, pick.get_score(), dimtopx(pick.get_dimension())));
-        plateinfo = --page->plates.end();
-        plate = page->plates.back().plate;
+        ++pagecnt;
+        if (!resume || !reuse_plate())
+        {
+            page->plates.push_back(Pageset::PlateInfo(pagecnt, plateinfo->start_page, pick.get_score(), dimtopx(pick.get_dimension())));
+            plateinfo = --page->plates.end();
+        };
+        plate = plateinfo->plate;
     };
     
     // add new line to the plate
-    plate->lines.push_back(Plate::pLine());             // append new line to the plate
+    plate->lines.push_back(Plate::pLine(plate->get_allocator()));   // append new line to the plate
     plate->lines.back().basePos.x = pick.get_indent();  // calculate the base-position
     plate->lines.back().basePos.y = pick.get_cursor().ypos + viewport->umtopx_v(pick.staff_offset(get_score().staves.front()));
     plate->lines.back().gphBox.pos = plate->lines.back().basePos;   // initialize graphical boundary box
@@ -1189,7 +1336,7 @@ bool EngraverState::engrave_next()
         // on the plate yet.
         
         // add the voice (with "begin" at end)
-        plate->lines.back().voices.push_back(Plate::pVoice(v->begin));
+        plate->lines.back().voices.push_back(Plate::pVoice(v->begin, plate->get_allocator()));
         pvoice = --plate->lines.back().voices.end();
         pvoice->begin.to_end();
         pvoice->parent = v->parent;
@@ -1206,7 +1353,7 @@ bool EngraverState::engrave_next()
         pos.x += viewport->umtopx_h(param->min_distance);
         
         // add end-of-voice indicator object
-        pvoice->notes.push_back(Plate::pNote(pos, const_Cursor(v->begin)));
+        pvoice->notes.push_back(Plate::pNote(pos, const_Cursor(v->begin), plate->get_allocator()));
         pvoice->notes.back().note.to_end();
         pvoice->notes.back().gphBox.pos = pos;
         pvoice->notes.back().gphBox.width = 1000;
@@ -1220,17 +1367,121 @@ bool EngraverState::engrave_next()
     else
         ++pline;                        // increment target line iterator
     
+    // record the checkpoint at the beginning of the new line
+    record_checkpoint();
+    
+    // check, if the previous engraving can be restored from here on
+    if (resume)
+    {
+        if (converge())  return false;      // the rest of the score is unchanged
+        if (pick.eos())  finish_resume();   // discard the rest of the previous engraving
+    };
+    
     // we have not reached the end of score, yet
     return !pick.eos();
 }
 
+// record the checkpoint at the beginning of the current line
+void EngraverState::record_checkpoint()
+{
+    pline->checkpoint = RefPtr<Plate::pLine::Checkpoint>(new Checkpoint(*this));
+}
+
+// discard the first held line
+void EngraverState::discard_line()
+{
+    if (&held_lines.front() == dirty_line) dirty_line = NULL;
+    held_lines.pop_front();
+}
+
+// discard the first held plate
+void EngraverState::discard_plate()
+{
+    const Plate::LineList& lines = held_plates.front().plate->lines;
+    for (Plate::LineList::const_iterator l = lines.begin(); l != lines.end(); ++l)
+        if (&*l == dirty_line) dirty_line = NULL;
+    held_plates.pop_front();
+}
+
+// move the held plate of the current page to the pageset (if the dimension did not change)
+// (keeps the plate-info valid for cursors on lines, which might be restored on convergence)
+bool EngraverState::reuse_plate()
+{
+    // discard the rest of the previous page
+    while (!held_lines.empty()) discard_line();
+    
+    // check the held plate
+    if (held_plates.empty() || held_plates.front().pageno != pagecnt) return false;
+    if (!(held_plates.front().dimension == dimtopx(pick.get_dimension())))
+    {
+        discard_plate();
+        return false;
+    };
+    
+    // move the plate to the page and hold its lines
+    page->plates.splice(page->plates.end(), held_plates, held_plates.begin());
+    plateinfo = --page->plates.end();
+    Plate::LineList(plateinfo->plate->lines.get_allocator()).swap(held_lines);  // (lines may only be moved within the arena of their plate)
+    held_lines.splice(held_lines.end(), plateinfo->plate->lines);
+    return true;
+}
+
+// check for convergence with the held lines (and restore them on success)
+bool EngraverState::converge()
+{
+    // discard held lines beginning in front of the new line
+    while (!held_lines.empty() && (!held_lines.front().checkpoint || get_checkpoint(held_lines.front()).start_time < start_time))
+        discard_line();
+    
+    // compare the states (converging not before the edited line has been discarded)
+    if (dirty_line || held_lines.empty() || !(get_checkpoint(held_lines.front()) == get_checkpoint(*pline)))
+        return false;
+    
+    // replace the new line by the held lines
+    plate->lines.erase(pline);
+    pline = held_lines.begin();
+    plate->lines.splice(plate->lines.end(), held_lines);
+    if (reengrave_info)     // objects on the restored lines are not reengraved
+    {
+        for (Plate::LineIt l = pline; l != plate->lines.end(); ++l)
+            reengrave_info->release(*l);
+    };
+    
+    // return the held plates to their pages
+    Pageset::PageIt p;
+    while (!held_plates.empty())
+    {
+        p = pageset->get_page(plateinfo->start_page + held_plates.front().pageno);
+        if (reengrave_info)
+        {
+            const Plate::LineList& lines = held_plates.front().plate->lines;
+            for (Plate::LineList::const_iterator l = lines.begin(); l != lines.end(); ++l)
+                reengrave_info->release(*l);
+        };
+        p->plates.splice(p->plates.end(), held_plates, held_plates.begin());
+    };
+    
+    resume = false;
+    return true;
+}
+
+// discard the remaining held engraving
+void EngraverState::finish_resume()
+{
+    held_lines.clear();
+    held_plates.clear();
+    dirty_line = NULL;
+    pageset->remove_empty_pages();
+    resume = false;
+}
+
 // calculate beam end information (first pass; for second pass see "engrave_stems")
 void EngraverState::engrave_beam(const Chord& chord, const StemInfo& info)
 {
-    BeamInfoMap::iterator i = beaminfo.find(&*pvoice);
-    if (i == beaminfo.end())
-        i = beaminfo.insert(BeamInfoMap::value_type(&*pvoice, BeamInfo(*pvoice))).first;
-    i->second.apply1(chord, param->beam_group, info);
+    const size_t voice = pick.get_cursor().voice_id;
+    if (voice >= beaminfo.size()) beaminfo.resize(voice + 1);
+    if (!beaminfo[voice].ready()) beaminfo[voice] = BeamInfo(*pvoice);
+    beaminfo[voice].apply1(chord, param->beam_group, info);
 }
 
 // add the given offset in front of the note to be engraved
@@ -1239,16 +1490,16 @@ void EngraverState::add_offset(const mpx_t offset)
     const mpx_t refpos = pnote->absolutePos.front().x;  // save reference front position
     
     // apply offset to engraved notes (including oneself)
-    for (std::list<Plate::pVoice>::iterator i = pline->voices.begin(); i != pline->voices.end(); ++i)
+    for (Plate::VoiceList::iterator i = pline->voices.begin(); i != pline->voices.end(); ++i)
     {
         // iterate through the voice backwards
-        for (std::list<Plate::pNote>::reverse_iterator n = i->notes.rbegin(); n != i->notes.rend(); ++n)
+        for (Plate::NoteList::reverse_iterator n = i->notes.rbegin(); n != i->notes.rend(); ++n)
         {
             // if we got a note, which is early enough to not be influenced by the offset
             if (n->absolutePos.front().x < refpos)
             {
-                if (n->virtual_obj)     // ignore barline
-                    if (n->virtual_obj->object->is(Class::BARLINE))
+                if (n->is_virtual())    // ignore barline
+                    if (n->virtual_obj.object->is(Class::BARLINE))
                         continue;
                 
                 if (n != i->notes.rend() && !n->ties.empty())   // do not move broken tie front
@@ -1282,3 +1533,106 @@ void EngraverState::log_unset()
     pick.log_unset();
 }
 
+
+
+//
+//     class EngraverState::Checkpoint
+//    =================================
+//
+// The engraver state at the beginning of an on-plate line. This contains all
+// the information necessary to resume the engraving at this line (i.e. the
+// pick with its cursors and layout, the tie-information, the counters and the
+// on-plate line before being engraved), as well as the contexts inherited from
+// the previous line, to detect convergence.
+//
+
+// compare the tie-information (ignoring voices without ties)
+static bool same_ties(const TieInfoMap& ties1, const TieInfoMap& ties2)
+{
+    TieInfoMap::const_iterator i1 = ties1.begin();
+    TieInfoMap::const_iterator i2 = ties2.begin();
+    while (true)
+    {
+        while (i1 != ties1.end() && i1->second.empty()) ++i1;
+        while (i2 != ties2.end() && i2->second.empty()) ++i2;
+        if (i1 == ties1.end() || i2 == ties2.end()) return (i1 == ties1.end() && i2 == ties2.end());
+        if (i1->first != i2->first || i1->second.size() != i2->second.size()) return false;
+        
+        for (TieInfoChord::const_iterator t1 = i1->second.begin(), t2 = i2->second.begin(); t1 != i1->second.end(); ++t1, ++t2)
+        {
+            if (   t1->first         != t2->first
+                || t1->second.source != t2->second.source
+                || t1->second.target != t2->second.target
+                || t1->second.refPos != t2->second.refPos) return false;
+        };
+        ++i1;
+        ++i2;
+    };
+}
+
+// compare the voices of an unengraved line (i.e. the end-of-voice indicators)
+static bool same_voices(const Plate::VoiceList& voices1, const Plate::VoiceList& voices2)
+{
+    if (voices1.size() != voices2.size()) return false;
+    for (Plate::VoiceList::const_iterator v1 = voices1.begin(), v2 = voices2.begin(); v1 != voices1.end(); ++v1, ++v2)
+    {
+        if (   v1->begin      != v2->begin
+            || v1->context    != v2->context
+            || v1->basePos.x  != v2->basePos.x
+            || v1->basePos.y  != v2->basePos.y
+            || v1->time       != v2->time) return false;
+    };
+    return true;
+}
+
+// record the checkpoint (of the new target line)
+EngraverState::Checkpoint::Checkpoint(const EngraverState& state) : pick(state.pick),
+                                                                    spaceinfo(state.spaceinfo),
+                                                                    lineinfo(state.lineinfo),
+                                                                    line(*state.pline),
+                                                                    pagecnt(state.pagecnt),
+                                                                    barcnt(state.barcnt),
+                                                                    start_time(state.start_time),
+                                                                    end_time(state.end_time),
+                                                                    at_newline(state.pick.at_newline())
+{
+    // copy the tie-information of voices with broken ties (keyed by the voices, since the voice ids
+    // of the previous engraving may differ)
+    for (size_t i = 0; i < state.tieinfo.size(); ++i)
+        if (!state.tieinfo[i].empty()) tieinfo[&state.pick.get_voice(i)] = state.tieinfo[i];
+    
+    // copy the voice contexts of the previous line (inherited by new voices, see "EngraverState::engrave")
+    if (state.pline != state.plate->lines.begin())
+    {
+        Plate::LineIt prev = state.pline;
+        --prev;
+        for (Plate::VoiceList::const_iterator v = prev->voices.begin(); v != prev->voices.end(); ++v)
+            voicectx[&v->begin.voice()] = v->context;
+    };
+}
+
+// check, if the engraving will continue identically
+// (the end-time stamp is ignored, since it does not affect the engraving)
+bool EngraverState::Checkpoint::operator == (const Checkpoint& state) const
+{
+    return    pagecnt                        == state.pagecnt
+           && barcnt                         == state.barcnt
+           && start_time                     == state.start_time
+           && spaceinfo.accidental_time      == state.spaceinfo.accidental_time
+           && spaceinfo.leftcluster_host     == state.spaceinfo.leftcluster_host
+           && spaceinfo.rightcluster_time    == state.spaceinfo.rightcluster_time
+           && lineinfo.dimension             == state.lineinfo.dimension
+           && lineinfo.indent                == state.lineinfo.indent
+           && lineinfo.justify               == state.lineinfo.justify
+           && lineinfo.forced_justification  == state.lineinfo.forced_justification
+           && lineinfo.right_margin          == state.lineinfo.right_margin
+           && line.basePos.x                 == state.line.basePos.x
+           && line.basePos.y                 == state.line.basePos.y
+           && line.context                   == state.line.context
+           && line.staffctx                  == state.line.staffctx
+           && voicectx                       == state.voicectx
+           && same_voices(line.voices, state.line.voices)
+           && same_ties(tieinfo, state.tieinfo)
+           && pick                           == state.pick;
+}
+
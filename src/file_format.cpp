@@ -1331,8 +1331,6 @@ void XMLSpritesetReader::parse_spriteset(SpriteSet& spriteset, Renderer& rendere
                 else if (xmlStrcasecmp(attr, STR_CAST("symbol")) == 0)  // time-signature symbol
                 {
                     // create sprite
-                    spriteset.flags_rest = spriteset.size();
-                    spriteset.ids["base.flags.rest"] = spriteset.size();
                     spriteset.push_back(SpriteInfo(SpriteInfo::TIMESIG));
                     spriteset.back().text[" class "] = "timesig.symbol_";
                     
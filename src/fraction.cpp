@@ -49,9 +49,6 @@ long Fraction::gcd(long x, long y)
         else              {t = y; y = x % y; x = t;};
 }
 
-// create from an integer
-Fraction::Fraction(const long x) : enumerator(x), denominator(1l) {}
-
 // create from a pair of enumerator and denominator
 Fraction::Fraction(const long enu, const long deno) : enumerator(enu), denominator(deno)
 {
@@ -80,27 +77,8 @@ Fraction::Fraction(const long x, const long enu, const long deno) : enumerator((
     };
 }
 
-// copy constructor
-Fraction::Fraction(const Fraction& fract) : enumerator(fract.enumerator), denominator(fract.denominator) {}
-
-// assign value
-Fraction& Fraction::operator = (const Fraction& fract)
-{
-    enumerator = fract.enumerator;
-    denominator = fract.denominator;
-    return *this;
-}
-
-// assign integer value
-Fraction& Fraction::operator = (const long fract)
-{
-    enumerator = fract;
-    denominator = 1l;
-    return *this;
-}
-
-// sum of two fractions
-Fraction& Fraction::operator += (const Fraction& fract)
+// sum of two fractions (general case, see the inline "operator +=")
+Fraction& Fraction::add(const Fraction& fract)
 {
     // handle infinite values
     if (denominator == 0l) return *this;
@@ -167,8 +145,8 @@ Fraction& Fraction::operator += (const long fract)
     return *this;   // return this instance
 }
 
-// difference of two fractions
-Fraction& Fraction::operator -= (const Fraction& fract)
+// difference of two fractions (general case, see the inline "operator -=")
+Fraction& Fraction::sub(const Fraction& fract)
 {
     // handle infinite values
     if (denominator == 0l) return *this;
@@ -442,8 +420,8 @@ Fraction& Fraction::operator /= (const long fract)
     return *this;   // return this instance
 }
 
-// modulo operator for two fractions
-Fraction& Fraction::operator %= (const Fraction& fract)
+// modulo operator for two fractions (general case, see the inline "operator %=")
+Fraction& Fraction::mod(const Fraction& fract)
 {
     Fraction temp(*this);       // copy instance
     temp /= fract;              // execute division
@@ -451,8 +429,8 @@ Fraction& Fraction::operator %= (const Fraction& fract)
     return *this;               // return this instance
 }
 
-// modulo operator for fraction and number
-Fraction& Fraction::operator %= (const long fract)
+// modulo operator for fraction and number (general case)
+Fraction& Fraction::mod(const long fract)
 {
     Fraction temp(*this);       // copy instance
     temp /= fract;              // execute division
@@ -460,53 +438,9 @@ Fraction& Fraction::operator %= (const long fract)
     return *this;               // return this instance
 }
 
-// check equality
-bool Fraction::operator == (const Fraction& fract) const
-{
-    if (fract.denominator == 0l &&  // check if both fractions are infinite
-        denominator == 0l &&        // and check sign
-        ((enumerator < 0l && fract.enumerator < 0l) || (enumerator > 0l && fract.enumerator > 0l))) return true;
-    
-    return (enumerator == fract.enumerator && denominator == fract.denominator);    // else check normal equality
-}
-
-bool Fraction::operator == (const long fract) const
-{
-    return (enumerator == fract && denominator == 1l);  // check integer equality
-}
-
-// check inequality
-bool Fraction::operator != (const Fraction& fract) const
-{
-    if (enumerator == fract.enumerator && denominator == fract.denominator) return false;   // check for normal equality
-    return (fract.denominator != 0l ||  // else check for infinite equality
-            denominator != 0l ||        // and sign
-            ((enumerator >= 0l || fract.enumerator >= 0l) && (enumerator <= 0l || fract.enumerator <= 0l)));
-}
-
-bool Fraction::operator != (const long fract) const
-{
-    return (enumerator != fract || denominator != 1l);  // check integer inequality
-}
-
-// check less or equal
-bool Fraction::operator <= (const Fraction& fract) const {return ((Fraction(*this) -= fract).enumerator <= 0l);}
-bool Fraction::operator <= (const long      fract) const {return ((Fraction(*this) -= fract).enumerator <= 0l);}
-
-// check greater or equal
-bool Fraction::operator >= (const Fraction& fract) const {return ((Fraction(*this) -= fract).enumerator >= 0l);}
-bool Fraction::operator >= (const long      fract) const {return ((Fraction(*this) -= fract).enumerator >= 0l);}
-
-// check less
-bool Fraction::operator < (const Fraction& fract) const {return ((Fraction(*this) -= fract).enumerator < 0l);}
-bool Fraction::operator < (const long      fract) const {return ((Fraction(*this) -= fract).enumerator < 0l);}
-
-// check greater
-bool Fraction::operator > (const Fraction& fract) const {return ((Fraction(*this) -= fract).enumerator > 0l);}
-bool Fraction::operator > (const long      fract) const {return ((Fraction(*this) -= fract).enumerator > 0l);}
-
-// cast operators
-Fraction::operator double() const {return static_cast<double>(enumerator) / static_cast<double>(denominator);}
+// comparison (returns the enumerator of the difference, whose sign is the result of the comparison)
+long Fraction::cmp(const Fraction& fract) const {return Fraction(*this).sub(fract).enumerator;}
+long Fraction::cmp(const long      fract) const {return (Fraction(*this) -= fract).enumerator;}
 
 // setting methods
 void Fraction::set(const long enu, const long deno)
@@ -63,6 +63,7 @@ bool Log::open(const char* filename)
 // log informational message
 void Log::info(const char* msg)
 {
+    std::lock_guard<std::mutex> guard(lock);
     if (_flags.ECHO_INFO)
         std::cout << msg << std::endl;
     if (_flags.LOG_INFO && file.is_open())
@@ -72,6 +73,7 @@ void Log::info(const char* msg)
 // log debug message
 void Log::debug(const char* msg)
 {
+    std::lock_guard<std::mutex> guard(lock);
     if (_flags.ECHO_DEBUG)
         std::cout << msg << std::endl;
     if (_flags.LOG_DEBUG && file.is_open())
@@ -81,6 +83,7 @@ void Log::debug(const char* msg)
 // log verbose output
 void Log::verbose(const char* msg)
 {
+    std::lock_guard<std::mutex> guard(lock);
     if (_flags.ECHO_VERBOSE)
         std::cout << msg << std::endl;
     if (_flags.LOG_VERBOSE && file.is_open())
@@ -90,6 +93,7 @@ void Log::verbose(const char* msg)
 // log warning
 void Log::warn(const char* msg)
 {
+    std::lock_guard<std::mutex> guard(lock);
     if (_flags.ECHO_WARN)
         std::cout << "WARNING: " << msg << std::endl;
     if (_flags.LOG_WARN && file.is_open())
@@ -99,6 +103,7 @@ void Log::warn(const char* msg)
 // log error message
 void Log::error(const char* msg)
 {
+    std::lock_guard<std::mutex> guard(lock);
     if (_flags.ECHO_ERROR)
         std::cout << "ERROR: " << msg << std::endl;
     if (_flags.LOG_ERROR && file.is_open())
@@ -108,6 +113,7 @@ void Log::error(const char* msg)
 // write message to log file only
 void Log::noprint(const char* msg)
 {
+    std::lock_guard<std::mutex> guard(lock);
     if (file.is_open())
         file << msg << std::endl;
 }
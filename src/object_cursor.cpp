@@ -141,19 +141,20 @@ bool ObjectCursor::select(Position<mpx_t> pos, Pageset::pPage& page)
     pos.x -= pageset->page_layout.margin.left;
     pos.y -= pageset->page_layout.margin.top;
     
+    // find the objects at the position (using the page's spatial index)
+    Pageset::Index::ItemList items;
+    page.get_index().find(pos, items);
+    
     // search for object on page
-    for (Pageset::pPage::AttachableList::iterator a = page.attached.begin(); a != page.attached.end(); ++a)
+    for (Pageset::Index::ItemList::const_iterator i = items.begin(); i != items.end() && (*i)->type == Pageset::Index::ATTACHABLE; ++i)
     {
-        if (!(*a)->object->is(Class::MOVABLE)) continue;
-        if ((*a)->contains(pos))
-        {
-            buffer.set_parent(page);
-            buffer.select(*static_cast<const Movable*>((*a)->object));
-            if (!buffer.ready() || buffer.end())
-                return false;
-            *this = buffer;
-            return true;
-        };
+        if (!(*i)->attachable->object->is(Class::MOVABLE)) continue;
+        buffer.set_parent(page);
+        buffer.select(*static_cast<const Movable*>((*i)->attachable->object));
+        if (!buffer.ready() || buffer.end())
+            return false;
+        *this = buffer;
+        return true;
     };
     
     // search for object within plates
@@ -161,7 +162,7 @@ bool ObjectCursor::select(Position<mpx_t> pos, Pageset::pPage& page)
     if (pinfo == page.plates.end())
         pinfo = --page.plates.end();
     pageno = pinfo->pageno - 1;             // set pagenumber
-    pos -= pinfo->dimension.position;       // calculate position relative to plate
+    const Position<mpx_t> ppos = pos - pinfo->dimension.position;   // calculate position relative to plate
     
     // search the score
     Document::ScoreList::iterator score_it = document->scores.begin();
@@ -171,35 +172,26 @@ bool ObjectCursor::select(Position<mpx_t> pos, Pageset::pPage& page)
     if (score_it == document->scores.end()) return false;
     buffer.score = &score_it->score;        // set score pointer
     
-    // search the object
-    for (Plate::LineIt l = pinfo->plate->lines.begin(); l != pinfo->plate->lines.end(); ++l)
+    // search the object (among the attachables of the plate's notes)
+    for (Pageset::Index::ItemList::const_iterator i = items.begin(); i != items.end(); ++i)
     {
-        if (!l->contains(pos)) continue;
-        for (Plate::VoiceIt v = l->voices.begin(); v != l->voices.end(); ++v)
+        if ((*i)->type != Pageset::Index::ATTACHED || (*i)->plateinfo != &*pinfo) continue;
+        if (!(*i)->line->contains(ppos)) continue;
+        const Plate::pNote& n = *(*i)->note;
+        if (n.at_end() || n.is_inserted()) continue;
+        if (!n.get_note().is(Class::VISIBLEOBJECT)) continue;
+        if (!(*i)->attachable->object->is(Class::MOVABLE)) continue;
+        
+        // (casts away const, but not unexpected, since this object got a non-const reference to the document)
+        buffer.pline  = &*(*i)->line;
+        buffer.pvoice = (*i)->voice;
+        buffer.pnote  = (*i)->note;
+        buffer.list   = &const_cast<StaffObject&>(n.get_note()).get_visible().attached;
+        buffer.plist  = &(*i)->note->attached;
+        if (buffer.setup() && buffer.select(*static_cast<const Movable*>((*i)->attachable->object)))
         {
-            for (Plate::NoteIt n = v->notes.begin(); n != v->notes.end() && !n->at_end(); ++n)
-            {
-                if (n->is_inserted()) continue;
-                if (!n->get_note().is(Class::VISIBLEOBJECT)) continue;
-                for (Plate::pNote::AttachableList::iterator a = n->attached.begin(); a != n->attached.end(); ++a)
-                {
-                    if (!(*a)->object->is(Class::MOVABLE)) continue;
-                    if ((*a)->contains(pos))
-                    {
-                        // (casts away const, but not unexpected, since this object got a non-const reference to the document)
-                        buffer.pline  = &*l;
-                        buffer.pvoice = &*v;
-                        buffer.pnote  = &*n;
-                        buffer.list   = &const_cast<StaffObject&>(n->get_note()).get_visible().attached;
-                        buffer.plist  = &n->attached;
-                        if (buffer.setup() && buffer.select(*static_cast<const Movable*>((*a)->object)))
-                        {
-                            *this = buffer;
-                            return true;
-                        };
-                    };
-                };
-            };
+            *this = buffer;
+            return true;
         };
     };
     
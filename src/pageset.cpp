@@ -18,9 +18,14 @@
   permissions and limitations under the Licence.
 */
 
+#include <algorithm>        // std::sort, std::unique
+#include <cmath>            // sqrt
+
 #include "pageset.hh"
 using namespace ScorePress;
 
+inline mpx_t _clamp(const mpx_t x, const mpx_t max) {return (x < 0) ? 0 : ((x > max) ? max : x);}
+
 
 //
 //     class Pageset
@@ -47,10 +52,131 @@ bool Pageset::ScoreDimension::contains(const Position<mpx_t>& pos) const
     return (pos.x >= position.x && pos.y >= position.y && pos.x < position.x + width && pos.y < position.y + height);
 }
 
+// check, if both score-objects have the same position and size
+bool Pageset::ScoreDimension::operator == (const ScoreDimension& dim) const
+{
+    return (position.x == dim.position.x && position.y == dim.position.y && width == dim.width && height == dim.height);
+}
+
 // plate-info constructor
 Pageset::PlateInfo::PlateInfo(const size_t _pageno, const size_t _start, const Score& _score, const ScoreDimension& _dim)
     : pageno(_pageno), start_page(_start), score(&_score), dimension(_dim), plate(new Plate()) {}
 
+// add an object to the index
+void Pageset::Index::add(const Type type, const Plate::GphBox& box, PlateInfo* plateinfo, Plate::LineIt line,
+                         Plate::pVoice* voice, Plate::pNote* note, Plate::pAttachable* attachable)
+{
+    const Item item = {type, box, plateinfo, line, voice, note, attachable};
+    items.push_back(item);
+}
+
+// (re)build the index for the given page
+void Pageset::Index::build(pPage& page)
+{
+    clear();
+    
+    // collect the objects (in rendering order)
+    for (pPage::AttachableList::iterator a = page.attached.begin(); a != page.attached.end(); ++a)
+        add(ATTACHABLE, (*a)->gphBox, NULL, Plate::LineIt(), NULL, NULL, &**a);
+    for (PlateList::iterator p = page.plates.begin(); p != page.plates.end(); ++p)
+    {
+        const Position<mpx_t>& origin = p->dimension.position;
+        for (Plate::LineIt l = p->plate->lines.begin(); l != p->plate->lines.end(); ++l)
+        {
+            add(LINE, Plate::GphBox(l->noteBox.pos + origin, l->noteBox.width, l->noteBox.height), &*p, l, NULL, NULL, NULL);
+            for (Plate::VoiceIt v = l->voices.begin(); v != l->voices.end(); ++v)
+                for (Plate::NoteIt n = v->notes.begin(); n != v->notes.end(); ++n)
+                {
+                    add(NOTE, Plate::GphBox(n->gphBox.pos + origin, n->gphBox.width, n->gphBox.height), &*p, l, &*v, &*n, NULL);
+                    for (Plate::pNote::AttachableList::iterator a = n->attached.begin(); a != n->attached.end(); ++a)
+                        add(ATTACHED, Plate::GphBox((*a)->gphBox.pos + origin, (*a)->gphBox.width, (*a)->gphBox.height), &*p, l, &*v, &*n, &**a);
+                };
+        };
+    };
+    valid = true;
+    if (items.empty()) return;
+    
+    // calculate the grid dimension (about one cell per object)
+    bounds = items.front().box;
+    for (std::vector<Item>::const_iterator i = items.begin(); i != items.end(); ++i)
+        bounds.extend(i->box);
+    const double w = (bounds.width  > 0) ? bounds.width  : 1;
+    const double h = (bounds.height > 0) ? bounds.height : 1;
+    cols = static_cast<size_t>(sqrt(static_cast<double>(items.size()) * w / h)) + 1;
+    rows = items.size() / cols + 1;
+    cell_w = static_cast<mpx_t>(w / static_cast<double>(cols)) + 1;
+    cell_h = static_cast<mpx_t>(h / static_cast<double>(rows)) + 1;
+    
+    // count the objects per cell
+    const mpx_t maxcol = static_cast<mpx_t>(cols - 1);
+    const mpx_t maxrow = static_cast<mpx_t>(rows - 1);
+    cells.assign(cols * rows + 1, 0);
+    for (std::vector<Item>::const_iterator i = items.begin(); i != items.end(); ++i)
+        for (mpx_t y = _clamp((i->box.pos.y - bounds.pos.y) / cell_h, maxrow); y <= _clamp((i->box.bottom() - bounds.pos.y) / cell_h, maxrow); ++y)
+            for (mpx_t x = _clamp((i->box.pos.x - bounds.pos.x) / cell_w, maxcol); x <= _clamp((i->box.right() - bounds.pos.x) / cell_w, maxcol); ++x)
+                ++cells[static_cast<size_t>(y) * cols + static_cast<size_t>(x) + 1];
+    for (size_t c = 1; c < cells.size(); ++c)
+        cells[c] += cells[c - 1];
+    
+    // fill the cells
+    std::vector<size_t> fill(cells.begin(), cells.end() - 1);
+    entries.resize(cells.back());
+    for (size_t idx = 0; idx < items.size(); ++idx)
+    {
+        const Plate::GphBox& box = items[idx].box;
+        for (mpx_t y = _clamp((box.pos.y - bounds.pos.y) / cell_h, maxrow); y <= _clamp((box.bottom() - bounds.pos.y) / cell_h, maxrow); ++y)
+            for (mpx_t x = _clamp((box.pos.x - bounds.pos.x) / cell_w, maxcol); x <= _clamp((box.right() - bounds.pos.x) / cell_w, maxcol); ++x)
+                entries[fill[static_cast<size_t>(y) * cols + static_cast<size_t>(x)]++] = idx;
+    };
+}
+
+// remove all objects (marking the index outdated)
+void Pageset::Index::clear()
+{
+    items.clear();
+    cells.clear();
+    entries.clear();
+    cols = rows = 0;
+    valid = false;
+}
+
+// find the objects containing the given point
+void Pageset::Index::find(const Position<mpx_t>& pos, ItemList& result) const
+{
+    result.clear();
+    if (items.empty() || !bounds.contains(pos)) return;
+    const size_t c = static_cast<size_t>((pos.y - bounds.pos.y) / cell_h) * cols + static_cast<size_t>((pos.x - bounds.pos.x) / cell_w);
+    for (size_t e = cells[c]; e < cells[c + 1]; ++e)
+        if (items[entries[e]].box.contains(pos))
+            result.push_back(&items[entries[e]]);
+}
+
+// find the objects intersecting the given rectangle
+void Pageset::Index::find(const Plate::GphBox& rect, ItemList& result) const
+{
+    result.clear();
+    if (items.empty() || !bounds.intersects(rect)) return;
+    
+    // collect the objects of the intersected cells
+    std::vector<size_t> found;
+    const mpx_t maxcol = static_cast<mpx_t>(cols - 1);
+    const mpx_t maxrow = static_cast<mpx_t>(rows - 1);
+    for (mpx_t y = _clamp((rect.pos.y - bounds.pos.y) / cell_h, maxrow); y <= _clamp((rect.bottom() - bounds.pos.y) / cell_h, maxrow); ++y)
+        for (mpx_t x = _clamp((rect.pos.x - bounds.pos.x) / cell_w, maxcol); x <= _clamp((rect.right() - bounds.pos.x) / cell_w, maxcol); ++x)
+        {
+            const size_t c = static_cast<size_t>(y) * cols + static_cast<size_t>(x);
+            for (size_t e = cells[c]; e < cells[c + 1]; ++e)
+                if (items[entries[e]].box.intersects(rect))
+                    found.push_back(entries[e]);
+        };
+    
+    // remove duplicates (restoring the rendering order)
+    std::sort(found.begin(), found.end());
+    found.erase(std::unique(found.begin(), found.end()), found.end());
+    for (std::vector<size_t>::const_iterator i = found.begin(); i != found.end(); ++i)
+        result.push_back(&items[*i]);
+}
+
 // find a plate belonging to a given score on this page
 Pageset::pPage::Iterator Pageset::pPage::get_plate_by_score(const Score& score)
 {
@@ -99,41 +225,52 @@ void Pageset::erase(const Score& score)
     {
         info = i->get_plate_by_score(score);                // get the plate for the given score
         if (info != i->plates.end()) i->plates.erase(info); // if it exists, remove the plate
+        i->index.clear();                                   // (invalidate the index)
     };
     remove_empty_pages();               // remove pages left empty
 }
 
+// assignment (rebuilding the page table for the copied pages)
+Pageset& Pageset::operator = (const Pageset& pageset)
+{
+    Pageset copy(pageset);      // (the plate-infos are not assignable; thus copy and swap the page list)
+    page_layout = copy.page_layout;
+    head_height = copy.head_height;
+    stem_width  = copy.stem_width;
+    pages.swap(copy.pages);     // (the iterators in the table stay valid)
+    table.swap(copy.table);
+    return *this;
+}
+
+// rebuild the page table
+void Pageset::update_table()
+{
+    table.clear();
+    table.reserve(pages.size());
+    for (Iterator i = pages.begin(); i != pages.end(); ++i)
+        table.push_back(i);
+}
+
+// mark the spatial indices of all pages outdated
+void Pageset::invalidate_index()
+{
+    for (Iterator i = pages.begin(); i != pages.end(); ++i)
+        i->index.clear();
+}
+
 // append a new page to the list (and return iterator)
 Pageset::Iterator Pageset::add_page()
 {
-    if (pages.empty())
-    {
-        pages.push_back(pPage(0));
-        return pages.begin();
-    };
-    pages.push_back(pPage(pages.back().pageno + 1));
-    return --pages.end();
+    pages.push_back(pPage(table.size()));
+    table.push_back(--pages.end());
+    return table.back();
 }
 
 // get the page with the given index (creates non-existing pages)
 Pageset::Iterator Pageset::get_page(size_t pageno)
 {
-    unsigned int idx = 0;   // page index
-    for (Iterator i = pages.begin(); i != pages.end(); ++i) // iterate through pages
-    {
-        if (i->pageno == pageno) return i;  // if we have got the correct page, return
-        ++idx;                              // count the page
-    };
-    do pages.push_back(pPage(idx)); while (++idx < pageno); // append enough pages to be able to return requested page
-    return --pages.end();                                   // return page
-}
-
-// get the page with the given index (on not existing page, returns pages.end())
-Pageset::const_Iterator Pageset::get_page(size_t pageno) const
-{
-    for (const_Iterator i = pages.begin(); i != pages.end(); ++i)   // iterate through pages
-        if (i->pageno == pageno) return i;                          // if we have got the correct page, return
-    return pages.end();                                             // otherwise, return invalid iterator
+    while (table.size() <= pageno) add_page();  // append enough pages to be able to return requested page
+    return table[pageno];                       // return page
 }
 
 // get the first page with the fiven score object
@@ -155,6 +292,20 @@ void Pageset::remove_empty_pages()
     while (!pages.empty() && pages.back().plates.empty() && pages.back().attached.empty())
     {
         pages.pop_back();
+        table.pop_back();
     };
 }
 
+// move the plates of another pageset to the pages with the same index
+void Pageset::merge(Pageset& source)
+{
+    Iterator target;                    // target page
+    for (Iterator i = source.pages.begin(); i != source.pages.end(); ++i)
+    {
+        target = get_page(i->pageno);                                   // find target page (or append it)
+        target->plates.splice(target->plates.end(), i->plates);         // move the plates
+        target->attached.splice(target->attached.end(), i->attached);   // and on-page objects
+        target->index.clear();                                          // (invalidate the index)
+    };
+    source.clear();
+}
@@ -39,7 +39,39 @@ inline int _round(const double d) {return static_cast<mpx_t>(d + 0.5);}
 
 // constructor for the "VoiceCursor" class
 Pick::VoiceCursor::VoiceCursor() : const_Cursor(), pos(0), npos(0), ypos(0), time(0), ntime(0),
-                                   virtual_obj(NULL), inserted(false), remaining_duration(-1) {}
+                                   virtual_obj(NULL), inserted(false), remaining_duration(-1), voice_id(UNDEFINED),
+                                   type(Class::STAFFOBJECT), order(ORDER_OTHER) {}
+
+// precompute the sort key (for the current object)
+void Pick::VoiceCursor::update_order()
+{
+    const StaffObject& obj = **this;
+    type = obj.classtype();
+    if      (obj.is(Class::PAGEBREAK)) order = ORDER_PAGEBREAK;
+    else if (obj.is(Class::NEWLINE))   order = ORDER_NEWLINE;
+    else if (obj.is(Class::TIMESIG))   order = ORDER_TIMESIG;
+    else if (obj.is(Class::KEY))       order = ORDER_KEY;
+    else if (obj.is(Class::BARLINE))   order = ORDER_BARLINE;
+    else if (obj.is(Class::CLEF))      order = ORDER_CLEF;
+    else                               order = ORDER_OTHER;
+}
+
+// compare position, time and virtual object
+bool Pick::VoiceCursor::operator == (const VoiceCursor& cursor) const
+{
+    if (!const_Cursor::operator == (cursor))          return false;   // compare score position
+    if (parent.ready() != cursor.parent.ready())      return false;   // compare parent note
+    if (parent.ready() && parent != cursor.parent)    return false;
+    if (!!virtual_obj != !!cursor.virtual_obj)        return false;   // compare virtual object
+    if (!!virtual_obj && virtual_obj->classtype() != cursor.virtual_obj->classtype()) return false;
+    return    pos                == cursor.pos                        // compare position and time
+           && npos               == cursor.npos
+           && ypos               == cursor.ypos
+           && time               == cursor.time
+           && ntime              == cursor.ntime
+           && inserted           == cursor.inserted
+           && remaining_duration == cursor.remaining_duration;
+}
 
 
 //     class LineLayout
@@ -52,114 +84,126 @@ Pick::VoiceCursor::VoiceCursor() : const_Cursor(), pos(0), npos(0), ypos(0), tim
 Pick::LineLayout::VoiceNotFoundException::VoiceNotFoundException()
     : ScorePress::Error("Cannot find layout of requested voice. (class Pick::LineLayout)") {}
 
-// associate a voice with its newline object
-void Pick::LineLayout::set(const Voice& voice, const LayoutParam& layout)
-{
-    data[&voice] = &layout;
-}
+// default constructor
+Pick::LineLayout::LineLayout() : first_voice(UNDEFINED) {}
 
-// check, if the voice has a newline object
-bool Pick::LineLayout::exist(const Voice& voice) const
+// associate a voice with its newline object
+void Pick::LineLayout::set(const size_t voice, const LayoutParam& layout)
 {
-    std::map<const Voice*, const LayoutParam*>::const_iterator i = data.find(&voice);
-    return (i != data.end() && i->second);
+    if (voice >= data.size()) data.resize(voice + 1, NULL);
+    data[voice] = &layout;
 }
 
 // get arbitrary newline object (for line-properties)
 const LayoutParam& Pick::LineLayout::get() const
 {
-    if (first_voice) return get(*first_voice);
-    if (data.empty()) throw VoiceNotFoundException();
-    return *data.begin()->second;
+    if (first_voice != UNDEFINED) return get(first_voice);
+    for (std::vector<const LayoutParam*>::const_iterator i = data.begin(); i != data.end(); ++i)
+        if (*i) return **i;
+    throw VoiceNotFoundException();
 }
 
-// get the newline object of the given voice
-const LayoutParam& Pick::LineLayout::get(const Voice& voice) const
+// remove a voice's layout
+void Pick::LineLayout::remove(const size_t voice)
 {
-    std::map<const Voice*, const LayoutParam*>::const_iterator i = data.find(&voice);
-    if (i == data.end() || !i->second) throw VoiceNotFoundException();
-    return *i->second;
+    if (voice < data.size()) data[voice] = NULL;
+    if (first_voice == voice) first_voice = UNDEFINED;
 }
 
-// remove a voice's layout
-void Pick::LineLayout::remove(const Voice& voice)
+// set the voice for line-properties
+void Pick::LineLayout::set_first_voice(const size_t voice)
 {
-    data.erase(&voice);
-    if (first_voice == &voice) first_voice = NULL;
+    if (!exist(voice)) throw VoiceNotFoundException();
+    first_voice = voice;
 }
 
-// set the voice for line-properties
-void Pick::LineLayout::set_first_voice(const Voice& voice)
+// compare the newline objects
+bool Pick::LineLayout::operator == (const LineLayout& layout) const
 {
-    if (data.find(&voice) == data.end()) throw VoiceNotFoundException();
-    first_voice = &voice;
+    if (first_voice != layout.first_voice) return false;
+    const std::vector<const LayoutParam*>& shorter = (data.size() < layout.data.size()) ? data : layout.data;
+    const std::vector<const LayoutParam*>& longer  = (data.size() < layout.data.size()) ? layout.data : data;
+    for (size_t i = 0; i < longer.size(); ++i)
+        if (longer[i] != ((i < shorter.size()) ? shorter[i] : NULL)) return false;
+    return true;
 }
 
 //
 //     class VoiceOrder
 //    ==================
 //
-// maps voices to their index thus providing an order comparison for voices
+// assigns dense ids to the voices (in the order of their appearance) and
+// provides an order comparison for voices (by the vertical rank of each id)
 //
 
 // exception class
 Pick::VoiceOrder::VoiceNotFoundException::VoiceNotFoundException()
     : ScorePress::Error("Cannot find index of parent voice. (class Pick::VoiceOrder)") {}
 
-// insert new voice above "parent"
-void Pick::VoiceOrder::add_above(const Voice& voice, const Voice& parent)
+// assign the next id to the voice (at the given rank)
+size_t Pick::VoiceOrder::add(const Voice& voice, const size_t rank)
 {
-    iterator i = find(&parent);
-    if (i == end()) throw VoiceNotFoundException();
-    const size_t idx = i->second;
-    for (i = begin(); i != end(); ++i)
-        if (i->second >= idx)
-            ++i->second;
-    insert(value_type(&voice, idx));
+    const std::map<const Voice*, size_t>::const_iterator i = ids.find(&voice);
+    if (i != ids.end()) return i->second;       // keep the id of known voices
+    
+    for (std::vector<size_t>::iterator r = ranks.begin(); r != ranks.end(); ++r)
+        if (*r >= rank) ++*r;
+    voices.push_back(&voice);
+    ranks.push_back(rank);
+    ids[&voice] = voices.size() - 1;
+    return voices.size() - 1;
 }
 
 // insert new voice above "parent"
-void Pick::VoiceOrder::add_below(const Voice& voice, const Voice& parent)
+size_t Pick::VoiceOrder::add_above(const Voice& voice, const size_t parent)
 {
-    iterator i = find(&parent);
-    if (i == end()) throw VoiceNotFoundException();
-    const size_t idx = i->second + 1;
-    for (i = begin(); i != end(); ++i)
-        if (i->second >= idx)
-            ++i->second;
-    insert(value_type(&voice, idx));
+    if (parent >= ranks.size()) throw VoiceNotFoundException();
+    return add(voice, ranks[parent]);
 }
 
-// insert new staff at the top
-void Pick::VoiceOrder::add_above(const Staff& staff)
+// insert new voice below "parent"
+size_t Pick::VoiceOrder::add_below(const Voice& voice, const size_t parent)
 {
-    for (iterator i = begin(); i != end(); ++i)
-        ++i->second;
-    insert(value_type(&static_cast<const Voice&>(staff), 0));
+    if (parent >= ranks.size()) throw VoiceNotFoundException();
+    return add(voice, ranks[parent] + 1);
 }
 
 // insert new staff at the bottom
-void Pick::VoiceOrder::add_below(const Staff& staff)
+size_t Pick::VoiceOrder::add_below(const Staff& staff)
 {
-    insert(value_type(&static_cast<const Voice&>(staff), size()));
+    return add(staff, ranks.size());
 }
 
-// check voice order ("v1" above "v2"?)
-bool Pick::VoiceOrder::is_above(const Voice& v1, const Voice& v2) const
+// get the id of the voice (false, if not found)
+bool Pick::VoiceOrder::find(const Voice& voice, size_t& id) const
 {
-    const const_iterator i1 = find(&v1);
-    const const_iterator i2 = find(&v2);
-    if (i1 == end() || i2 == end()) throw VoiceNotFoundException();
-    return i1->second < i2->second;
+    const std::map<const Voice*, size_t>::const_iterator i = ids.find(&voice);
+    if (i == ids.end()) return false;
+    id = i->second;
+    return true;
 }
 
-// check voice order ("v1" below "v2"?)
-bool Pick::VoiceOrder::is_below(const Voice& v1, const Voice& v2) const
+// get the id of the voice
+size_t Pick::VoiceOrder::get_id(const Voice& voice) const
 {
-    const const_iterator i1 = find(&v1);
-    const const_iterator i2 = find(&v2);
-    if (i1 == end() || i2 == end()) throw VoiceNotFoundException();
-    return i1->second > i2->second;
+    const std::map<const Voice*, size_t>::const_iterator i = ids.find(&voice);
+    if (i == ids.end()) throw VoiceNotFoundException();
+    return i->second;
+}
+
+// remove all voices
+void Pick::VoiceOrder::clear()
+{
+    voices.clear();
+    ranks.clear();
+    ids.clear();
+}
+
+// compare voice ids and ranks
+// (the ids of both orders have to be assigned identically, since the layouts are indexed by them)
+bool Pick::VoiceOrder::operator == (const VoiceOrder& order) const
+{
+    return voices == order.voices && ranks == order.ranks;
 }
 
 
@@ -174,47 +218,34 @@ bool Pick::VoiceOrder::is_below(const Voice& v1, const Voice& v2) const
 //
 
 // comparison defining the engraving order for VoiceCursor
+// (pagebreaks after newlines after all other objects, these ordered by time and
+//  class: time-signatures, keys, barlines, other objects and clefs)
 bool Pick::compare(const VoiceCursorPtr& cur1, const VoiceCursorPtr& cur2)
 {
-    if ((*cur1)->is(Class::PAGEBREAK))
-        return (!(*cur2)->is(Class::PAGEBREAK) || cur2->time < cur1->time);
-    if ((*cur2)->is(Class::PAGEBREAK))
-        return false;
-    if ((*cur1)->is(Class::NEWLINE))
-        return (!(*cur2)->is(Class::NEWLINE) || cur2->time < cur1->time);
-    if ((*cur2)->is(Class::NEWLINE))
-        return false;
+    const Order order1 = cur1->order;
+    const Order order2 = cur2->order;
+    if (order1 <= ORDER_NEWLINE || order2 <= ORDER_NEWLINE)
+        return (order1 != order2) ? (order1 < order2) : (cur2->time < cur1->time);
     if (cur1->time != cur2->time)
         return (cur2->time < cur1->time);
     if (cur1->ntime != cur2->ntime)
         return (cur2->ntime < cur1->ntime);
-    if ((*cur1)->classtype() == (*cur2)->classtype())
+    if (cur1->type == cur2->type)
         return (cur2->time < cur1->time);
     
-    if ((*cur1)->is(Class::TIMESIG)) return true;
-    if ((*cur2)->is(Class::TIMESIG)) return false;
-    if ((*cur1)->is(Class::KEY))     return true;
-    if ((*cur2)->is(Class::KEY))     return false;
-    if ((*cur1)->is(Class::BARLINE)) return true;
-    if ((*cur2)->is(Class::BARLINE)) return false;
-    return !((*cur1)->is(Class::CLEF));
+    if (order1 < ORDER_CLEF || order2 < ORDER_CLEF) return (order1 <= order2);
+    return (order1 != ORDER_CLEF);
 }
 
 // return the graphical width for the number
-mpx_t Pick::width(const SpriteSet& spr, unsigned int n, const mpx_t height)
+mpx_t Pick::width(const SpriteMetrics& metrics, unsigned int n)
 {
     mpx_t width = 0;
     
     do
     {
-        width += (    spr[
-                    (spr.digits_time[n % 10] == UNDEFINED) ?
-                        spr.undefined_symbol :
-                        spr.digits_time[n % 10]
-                ].width * height
-            ) / spr.head_height;
-        
-        width += (spr.timesig_digit_space * height) / spr.head_height;
+        width += metrics[metrics.digit(n % 10)].mpx_width;
+        width += metrics.mpx_digit_space;
         n /= 10;
     } while(n != 0);
     
@@ -225,10 +256,11 @@ mpx_t Pick::width(const SpriteSet& spr, unsigned int n, const mpx_t height)
 #define _width(idx, type)      \
     ((height == 0) ?            \
         spr[idx].width * 1000 : \
-        (((spr[idx].width * height) / spr.head_height(idx)) * static_cast<const type*>(obj)->appearance.scale) / 1000)
+        (metrics.get(idx, height).mpx_width * static_cast<const type*>(obj)->appearance.scale) / 1000)
 
-mpx_t Pick::width(const Sprites& spr, const StaffObject* obj, const mpx_t height)
+mpx_t Pick::width(MetricsCache& metrics, const StaffObject* obj, const mpx_t height)
 {
+    const Sprites& spr = metrics.get_sprites();
     SpriteId idx = obj->get_sprite(spr);    // get sprite id (if possible)
     
     if (obj->is(Class::CHORD))          // if the object is a chord...
@@ -247,18 +279,18 @@ mpx_t Pick::width(const Sprites& spr, const StaffObject* obj, const mpx_t height
         if (rest.val.exp >= VALUE_BASE - 2) return _width(idx, Rest);
         
         // otherwise calculate width of composed graphic
-        if (spr[idx].real.find("stem.slope") == spr[idx].real.end())    // if there is no slope,
+        if (spr[idx].real.find(ATOM_STEM_SLOPE) == spr[idx].real.end())    // if there is no slope,
             return spr[idx].width * 1000;                               //    return simple width
         
         return (height == 0) ? (    // if height is not given, suppose the sprite-set's default height
              _round((
                         spr[idx].width + 
-                        spr[idx].real.find("stem.slope")->second * (VALUE_BASE - 2 - rest.val.exp)
+                        spr[idx].real.find(ATOM_STEM_SLOPE)->second * (VALUE_BASE - 2 - rest.val.exp)
                      ) * rest.appearance.scale
                )) : (               // on given height, scale appropriately
              _round(((((
                         spr[idx].width + 
-                        spr[idx].real.find("stem.slope")->second * (VALUE_BASE - 2 - rest.val.exp)
+                        spr[idx].real.find(ATOM_STEM_SLOPE)->second * (VALUE_BASE - 2 - rest.val.exp)
                      ) * height) / spr.head_height(idx)) * rest.appearance.scale) / 1000
                ));
     }
@@ -284,10 +316,10 @@ mpx_t Pick::width(const Sprites& spr, const StaffObject* obj, const mpx_t height
         };
         
         // get the width of the "number of beats" (within the default set)
-        mpx_t width_number = width(spr[setid], static_cast<const TimeSig*>(obj)->number, height);
+        mpx_t width_number = width(metrics.get(setid, height), static_cast<const TimeSig*>(obj)->number);
         
         // get the width of the beat (within the default set)
-        mpx_t width_beat = width(spr[setid], static_cast<const TimeSig*>(obj)->beat, height);
+        mpx_t width_beat = width(metrics.get(setid, height), static_cast<const TimeSig*>(obj)->beat);
         
         // return the maximum of both
         return (width_number < width_beat) ? width_beat : width_number;
@@ -331,9 +363,11 @@ void Pick::add_subvoices(const VoiceCursor& parent, CQueue& cqueue)
             VoiceCursorPtr cursor = VoiceCursorPtr(new VoiceCursor());
             cursor->set(parent.staff(), **voice);
             cursor->parent = parent;
+            cursor->voice_id = below ? _voice_order.add_below(**voice, parent.voice_id)    // assign the voice id
+                                     : _voice_order.add_above(**voice, parent.voice_id);
             
             // set layout
-            _layout.set(**voice, _layout.get(parent.voice()));
+            _layout.set(cursor->voice_id, _layout.get(parent.voice_id));
             
             // set position
             cursor->pos = parent.pos;   // copy horizontal position
@@ -349,10 +383,9 @@ void Pick::add_subvoices(const VoiceCursor& parent, CQueue& cqueue)
             };
             
             // insert note
-            if (below) _voice_order.add_below(**voice, parent.voice());
-            else       _voice_order.add_above(**voice, parent.voice());
-            cqueue.push(cursor);            // add cursor to the queue
-            add_subvoices(*cursor, cqueue); // add the subvoices of the first note of the new voice
+            const VoiceCursor& added = *cursor;
+            cqueue.push(std::move(cursor)); // add cursor to the queue
+            add_subvoices(added, cqueue);   // add the subvoices of the first note of the new voice
         };
     };
 }
@@ -360,7 +393,12 @@ void Pick::add_subvoices(const VoiceCursor& parent, CQueue& cqueue)
 // intialize the cursors to the score's beginning
 void Pick::_initialize()
 {
+    // assign the voice ids of the staves (i.e. their index)
     for (std::list<Staff>::const_iterator s = score->staves.begin(); s != score->staves.end(); ++s)
+        _voice_order.add_below(*s);
+    
+    size_t idx = 0;
+    for (std::list<Staff>::const_iterator s = score->staves.begin(); s != score->staves.end(); ++s, ++idx)
     {
         if (!s->notes.empty())  // if the staff contains any notes...
         {
@@ -368,6 +406,7 @@ void Pick::_initialize()
             
             // append main-voice
             cursor->set(*s);            // create cursor to the staff's beginning
+            cursor->voice_id = idx;     // (with the staff's voice id)
             if (s->notes.front()->is(Class::NOTEOBJECT))
                 cursor->pos = viewport->umtopx_h(param->barline_distance +              // set pos to barline distance
                                              score->staves.front().layout.indent);  // plus the initial line indent
@@ -389,13 +428,13 @@ void Pick::_initialize()
             };
             
             // set layout
-            _layout.set(*s, s->layout);
-            _layout.set_first_voice(*s);
+            _layout.set(idx, s->layout);
+            _layout.set_first_voice(idx);
             
             // insert note
-            _voice_order.add_below(*s);
-            cursors.push(cursor);   // add cursor to the queue
-            add_subvoices(*cursor); // add the subvoices of the first note of the new voice
+            const VoiceCursor& added = *cursor;
+            cursors.push(std::move(cursor));    // add cursor to the queue
+            add_subvoices(added);               // add the subvoices of the first note of the new voice
         };
     };
     
@@ -407,7 +446,7 @@ void Pick::_initialize()
 void Pick::calculate_npos(VoiceCursor& nextNote)
 {
     // the note's graphical width (plus minimal distance)
-    const mpx_t note_width = width(*sprites,
+    const mpx_t note_width = width(*metrics,
                                    &*nextNote,
                                    viewport->umtopx_v(HEAD_HEIGHT(nextNote.staff())));
     nextNote.npos = nextNote.pos + note_width;
@@ -491,8 +530,8 @@ void Pick::insert_next(const VoiceCursor& engravedNote)
         const Pagebreak& obj = static_cast<const Pagebreak&>(*engravedNote);
         if (obj.dimension.width && obj.dimension.height)    // set new score dimension
             _dimension = &obj.dimension;
-        _next_layout.set(engravedNote.voice(), obj.layout); // set new line layout
-        _next_layout.set_first_voice(engravedNote.voice());
+        _next_layout.set(engravedNote.voice_id, obj.layout);    // set new line layout
+        _next_layout.set_first_voice(engravedNote.voice_id);
         
         // reset "pos" and "ypos"
         nextNote.pos = viewport->umtopx_h(param->min_distance + obj.layout.indent);
@@ -527,8 +566,8 @@ void Pick::insert_next(const VoiceCursor& engravedNote)
         
         // copy new line layout
         const Newline& obj = static_cast<const Newline&>(*engravedNote);
-        _next_layout.set(engravedNote.voice(), obj.layout); // set new line layout
-        _next_layout.set_first_voice(engravedNote.voice());
+        _next_layout.set(engravedNote.voice_id, obj.layout);    // set new line layout
+        _next_layout.set_first_voice(engravedNote.voice_id);
         
         if (!(++nextNote).at_end())     // if there is a next note
         {
@@ -564,7 +603,7 @@ void Pick::insert_next(const VoiceCursor& engravedNote)
         };
         
         // insert new note into stack
-        ((engravedNote->is(Class::NEWLINE)) ? next_cursors : cursors).push(nextNotePtr);
+        ((engravedNote->is(Class::NEWLINE)) ? next_cursors : cursors).push(std::move(nextNotePtr));
         
         // add new voices
         if (!nextNote.virtual_obj)
@@ -688,14 +727,12 @@ void Pick::prepare_next(const VoiceCursor& engravedNote, mpx_t w)
 }
 
 // constructor: create a new pick
-Pick::Pick(const Score& _score, const EngraverParam& _param, const ViewportParam& _viewport, const Sprites& _sprites, int def_head_height) :
+Pick::Pick(const Score& _score, const EngraverParam& _param, const ViewportParam& _viewport, MetricsCache& _metrics, int def_head_height) :
                                             score(&_score),
                                             param(&_param),
                                             viewport(&_viewport),
-                                            sprites(&_sprites),
+                                            metrics(&_metrics),
                                             head_height(def_head_height),
-                                            cursors(&compare),
-                                            next_cursors(&compare),
                                             _dimension(NULL),
                                             _newline(false),
                                             _pagebreak(false),
@@ -705,14 +742,19 @@ Pick::Pick(const Score& _score, const EngraverParam& _param, const ViewportParam
     _initialize();  // intialize the cursors to the score's beginning
 }
 
+// use other sprite metrics (i.e. after being copied from a checkpoint)
+void Pick::set_metrics(MetricsCache& _metrics)
+{
+    metrics = &_metrics;
+}
+
 // pop current note from stack and add next note in voice
 void Pick::next(mpx_t w)
 {
     // remove engraved note
     if (cursors.empty()) return;
     
-    VoiceCursorPtr engravedNote(cursors.top());
-    cursors.pop();
+    VoiceCursorPtr engravedNote(cursors.pop_top());
     insert_next(*engravedNote);
     prepare_next(*engravedNote, w);
 }
@@ -725,6 +767,8 @@ void Pick::reset()
     _newline = false;       // reset newline indicator
     _pagebreak = false;     // reset pagebreak indicator
     _newline_time = -1L;    // reset newline timestamp
+    _layout.clear();        // reset layout
+    _voice_order.clear();   //   and voice ids
     _initialize();          // re-initialize cursors to the score's beginning
 }
 
@@ -799,7 +843,7 @@ void Pick::insert(const StaffObject& obj)
     cur.inserted = true;
     cur.remaining_duration = -1;
     ++cur;
-    ((*cursors.top())->is(Class::NEWLINE) ? next_cursors : cursors).push(curptr);
+    ((*cursors.top())->is(Class::NEWLINE) ? next_cursors : cursors).push(std::move(curptr));
 }
 
 // insert a virtual barline object at a given time
@@ -811,7 +855,7 @@ void Pick::insert_barline(const Barline::Style& style)
     barline->virtual_obj = StaffObjectPtr(new Barline(style));
     barline->inserted = true;
     barline->remaining_duration = -1;
-    cursors.push(barline);
+    cursors.push(std::move(barline));
 }
 
 // insert a virtual object (changes current cursor)
@@ -838,7 +882,7 @@ bool Pick::insert_before(const StaffObject& obj, const Voice& voice)
     vobj->remaining_duration = -1;
     calculate_npos(*vobj);
     cursors.top()->npos = vobj->npos;
-    cursors.push(vobj);
+    cursors.push(std::move(vobj));
     prepare_next(*cursors.top(), 0);
     return true;
 }
@@ -869,6 +913,7 @@ void Pick::cut(value_t duration)
         cursors.top()->remaining_duration = cursors.top()->ntime - cursors.top()->time - duration;
         cursors.top()->ntime = cursors.top()->time + duration;
         cursors.top()->virtual_obj = StaffObjectPtr(nchord);    // inserted status stays ("false" for first, "true" for following)
+        cursors.top()->update_order();                          // (the object changed)
         
         // calculate estimated position of the following note
         calculate_npos(*cursors.top());
@@ -883,6 +928,7 @@ void Pick::cut(value_t duration)
         cursors.top()->remaining_duration = cursors.top()->ntime - cursors.top()->time - duration;
         cursors.top()->ntime = cursors.top()->time + duration;
         cursors.top()->virtual_obj = StaffObjectPtr(nrest); // inserted status stays ("false" for first, "true" for following)
+        cursors.top()->update_order();                      // (the object changed)
         
         // calculate estimated position of the following note
         calculate_npos(*cursors.top());
@@ -896,21 +942,24 @@ const Staff& Pick::get_staff(int idx_shift) const
     
     std::list<Staff>::const_iterator i = score->staves.begin(); // iterator (real)
     std::list<Staff>::const_iterator j = score->staves.begin(); // iterator (offset)
+    size_t                          ii = 0;                     // voice id of "i" (i.e. the staff index)
+    size_t                          jj = 0;                     // voice id of "j"
     const Staff& staff = cursors.top()->staff();
     
     // push idx-offset without adding position
     while (idx_shift < 0 && &*i != &staff && i != score->staves.end())
     {
-            if (_layout.get(*i).visible) ++idx_shift;
-            ++i;
+            if (_layout.get(ii).visible) ++idx_shift;
+            ++i; ++ii;
     };
     if (idx_shift < 0) idx_shift = 0;
     
     // iterate until given staff is found (or we run out of staves)
     while ((idx_shift || &*i != &staff) && i != score->staves.end())
     {
-        if (idx_shift < 0 && _layout.get(*j).visible) ++idx_shift;
-        if (!idx_shift) ++i;
+        if (idx_shift < 0 && _layout.get(jj).visible) ++idx_shift;
+        if (!idx_shift) {++i; ++ii;};
+        ++jj;
         if (&*++j == &score->staves.back()) break;
     };
     
@@ -928,26 +977,30 @@ int Pick::staff_offset(int idx_shift) const
     int out = 0;                                                // staff offset
     std::list<Staff>::const_iterator i = score->staves.begin(); // iterator (real)
     std::list<Staff>::const_iterator j = score->staves.begin(); // iterator (offset)
+    size_t                          ii = 0;                     // voice id of "i" (i.e. the staff index)
+    size_t                          jj = 0;                     // voice id of "j"
     const Staff& staff = cursors.top()->staff();
     
     // push idx-offset without adding position
     while (idx_shift < 0 && &*i != &staff && i != score->staves.end())
     {
-            if (_layout.get(*i).visible) ++idx_shift;
-            ++i;
+            if (_layout.get(ii).visible) ++idx_shift;
+            ++i; ++ii;
     };
     if (idx_shift < 0) idx_shift = 0;
     
     // iterate until given staff is found (or we run out of staves)
     while ((idx_shift || &*i != &staff) && i != score->staves.end())
     {
-        if (_layout.get(*j).visible)
+        const LayoutParam& layout = _layout.get(jj);
+        if (layout.visible)
         {
-            out += ((j->offset_y + _layout.get(*j).distance) * HEAD_HEIGHT(*j)) / 1000  // add staff offset
-                +  (j->line_count - 1) * HEAD_HEIGHT(*j);                               // add staff height
+            out += ((j->offset_y + layout.distance) * HEAD_HEIGHT(*j)) / 1000   // add staff offset
+                +  (j->line_count - 1) * HEAD_HEIGHT(*j);                       // add staff height
             if (idx_shift < 0) ++idx_shift;
         };
-        if (!idx_shift) ++i;
+        if (!idx_shift) {++i; ++ii;};
+        ++jj;
         if (&*++j == &score->staves.back()) break;
     };
     
@@ -959,7 +1012,7 @@ int Pick::staff_offset(int idx_shift) const
     };
     
     // add staff offset and return
-    return out + ((j->offset_y + _layout.get(*j).distance) * HEAD_HEIGHT(*j)) / 1000;
+    return out + ((j->offset_y + _layout.get(jj).distance) * HEAD_HEIGHT(*j)) / 1000;
 }
 
 // calculate the staff's offset relative to the line's position (in micrometer)
@@ -967,13 +1020,15 @@ int Pick::staff_offset(const Staff& staff) const
 {
     int out = 0;                                                // staff offset
     std::list<Staff>::const_iterator i = score->staves.begin(); // iterator
+    size_t                          ii = 0;                     // voice id of "i" (i.e. the staff index)
     
     while (i != score->staves.end() && &*i != &staff)   // iterate until given staff is found (or we run out of staves)
     {
-        if (_layout.get(*i).visible)
-            out += ((i->offset_y + _layout.get(*i).distance) * HEAD_HEIGHT(*i)) / 1000  // add staff offset
-                +  (i->line_count - 1) * HEAD_HEIGHT(*i);                               // add staff height
-        ++i;
+        const LayoutParam& layout = _layout.get(ii);
+        if (layout.visible)
+            out += ((i->offset_y + layout.distance) * HEAD_HEIGHT(*i)) / 1000   // add staff offset
+                +  (i->line_count - 1) * HEAD_HEIGHT(*i);                       // add staff height
+        ++i; ++ii;
     };
     
     // if we did not find the given staff, return
@@ -984,16 +1039,17 @@ int Pick::staff_offset(const Staff& staff) const
     };
     
     // add staff offset and return
-    return out + ((staff.offset_y + _layout.get(staff).distance) * HEAD_HEIGHT(staff)) / 1000;
+    return out + ((staff.offset_y + _layout.get(ii).distance) * HEAD_HEIGHT(staff)) / 1000;
 }
 
 // calculate the complete line height (in micrometer)
 int Pick::line_height() const
 {
-    int out = 0; // staff offset
-    for (std::list<Staff>::const_iterator i = score->staves.begin(); i != score->staves.end(); ++i)
+    int out = 0;    // staff offset
+    size_t ii = 0;  // voice id of "i" (i.e. the staff index)
+    for (std::list<Staff>::const_iterator i = score->staves.begin(); i != score->staves.end(); ++i, ++ii)
     {
-        out += ((i->offset_y + _layout.get(*i).distance) * HEAD_HEIGHT(*i)) / 1000  // add staff offset
+        out += ((i->offset_y + _layout.get(ii).distance) * HEAD_HEIGHT(*i)) / 1000  // add staff offset
             +  (i->line_count - 1) * HEAD_HEIGHT(*i);                               // add staff height
     };
     return out;
@@ -1020,3 +1076,60 @@ const Pick::VoiceCursor* Pick::peek(const Voice& v) const
         if (&(*i)->voice() == &v) return &**i;
     return NULL;
 }
+
+// check, if the queue contains a cursor equal to the given one
+static bool contains(const Pick::CQueue& queue, const Pick::VoiceCursor& cursor)
+{
+    for (Pick::CQueue::const_iterator i = queue.begin(); i != queue.end(); ++i)
+        if (**i == cursor) return true;
+    return false;
+}
+
+// check, if both picks will continue identically
+// (cursors are compared regardless of their order within the queue; the layout for
+//  the next line is ignored, since it is only valid during the processing of a newline)
+bool Pick::operator == (const Pick& pick) const
+{
+    if (   score               != pick.score
+        || cursors.size()      != pick.cursors.size()
+        || next_cursors.size() != pick.next_cursors.size()
+        || _dimension          != pick._dimension
+        || !(_layout           == pick._layout)
+        || !(_voice_order      == pick._voice_order)
+        || _newline            != pick._newline
+        || _pagebreak          != pick._pagebreak
+        || _newline_time       != pick._newline_time
+        || _line_height        != pick._line_height)
+        return false;
+    
+    for (CQueue::const_iterator i = cursors.begin(); i != cursors.end(); ++i)
+        if (!contains(pick.cursors, **i)) return false;
+    for (CQueue::const_iterator i = next_cursors.begin(); i != next_cursors.end(); ++i)
+        if (!contains(pick.next_cursors, **i)) return false;
+    return true;
+}
+
+// check, if any voice's next object is a newline (i.e. the voice is empty on the current line)
+bool Pick::at_newline() const
+{
+    for (CQueue::const_iterator i = cursors.begin(); i != cursors.end(); ++i)
+        if (!(*i)->const_Cursor::at_end() && (*i)->original().is(Class::NEWLINE)) return true;
+    return false;
+}
+
+// check, if all sub-voices still exist in their parents
+// (the score might have been edited, since the pick was copied)
+bool Pick::check_subvoices() const
+{
+    for (CQueue::const_iterator i = cursors.begin(); i != cursors.end(); ++i)
+    {
+        if (!(*i)->is_sub() || !(*i)->parent.ready() || (*i)->parent.at_end()) continue;
+        if (!(*i)->parent->is(Class::NOTEOBJECT)) continue;
+        
+        const SubVoiceList& subvoices = static_cast<const NoteObject&>(*(*i)->parent).subvoices;
+        SubVoiceList::const_iterator v = subvoices.begin();
+        while (v != subvoices.end() && &**v != &(*i)->voice()) ++v;
+        if (v == subvoices.end()) return false;
+    };
+    return true;
+}
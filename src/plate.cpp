@@ -110,10 +110,18 @@ Plate_pAttachable::Plate_pAttachable(const AttachedObject& obj, const Plate::Pos
 Plate_pDurable::Plate_pDurable(const AttachedObject& obj, const Plate::Pos& pos) : Plate_pAttachable(obj, pos) {}
 
 // virtual note constructor
-Plate_pNote::Virtual::Virtual(const StaffObject& _object, bool _inserted) : object(_object.clone()), inserted(_inserted) {}
+Plate_pNote::Virtual::Virtual() : inserted(false) {}
+
+// set the virtual object
+void Plate_pNote::Virtual::set(const StaffObject& _object, bool _inserted)
+{
+    object = SmartPtr<const StaffObject, CloneTrait>(_object.clone());
+    inserted = _inserted;
+}
 
 // note object constructor
-Plate_pNote::Plate_pNote(const Plate::Pos& pos, const const_Cursor& n) : note(n), virtual_obj(), stem_info(), noflag(false)
+Plate_pNote::Plate_pNote(const Plate::Pos& pos, const const_Cursor& n, const Plate_Allocator& alloc)
+    : note(n), attached(alloc), noflag(false), stem_info()
 {
     absolutePos.push_back(pos); // append top pos
     stem.x = pos.x;             // initialize zero length stem at pos
@@ -129,7 +137,7 @@ void Plate_pNote::add_offset(mpx_t offset)
     {
         p->x += offset;
     };
-    for (PositionList::iterator p = dotPos.begin(); p != dotPos.end(); ++p)
+    for (DotList::iterator p = dotPos.begin(); p != dotPos.end(); ++p)
     {
         p->x += offset;
     };
@@ -154,7 +162,7 @@ void Plate_pNote::add_offset(mpx_t offset)
 // add offset to tie-end positions
 void Plate_pNote::add_tieend_offset(mpx_t offset)
 {
-    for (std::list<Tie>::iterator t = ties.begin(); t != ties.end(); ++t)
+    for (TieList::iterator t = ties.begin(); t != ties.end(); ++t)
     {
         t->pos2.x += offset;
         t->control2.x += offset;
@@ -174,7 +182,7 @@ void Plate_pNote::dump() const
     if (!dotPos.empty())
     {
         std::cout << "dotPos      ";
-        for (PositionList::const_iterator i = dotPos.begin(); i != dotPos.end(); ++i)
+        for (DotList::const_iterator i = dotPos.begin(); i != dotPos.end(); ++i)
             std::cout << " (" << i->x << ", " << i->y << ")";
         std::cout << "\n";
     };
@@ -185,15 +193,15 @@ void Plate_pNote::dump() const
             std::cout << "  " << i->count << " x (" << i->basepos.x << ", " << i->basepos.y << ") - " << i->length << (i->below ? " v" : " ^");
         std::cout << "\n";
     };
-    std::cout << "virtual      " << (virtual_obj ? (virtual_obj->inserted ? "Yes (inserted)\n" : "Yes\n") : "No\n");
+    std::cout << "virtual      " << (is_virtual() ? (virtual_obj.inserted ? "Yes (inserted)\n" : "Yes\n") : "No\n");
     std::cout << "stem         (" << stem.x << ", " << stem.top << ") - (" << stem.x << ", " << stem.base << ") : " << stem.beam_off << "\n";
     for (size_t i = 0; i < VALUE_BASE - 2; ++i)
     {
-        if (beam[i])
+        if (beam[i].end)
         {
             std::cout << "beam " << ((i > VALUE_BASE - 7) ? " " : "") << ((i > VALUE_BASE - 4) ? " " : "") << (1 << (VALUE_BASE - i));
-            std::cout << ":    " << beam[i]->end << " ~ idx " << beam[i]->end_idx << "  ";
-            std::cout << (beam[i]->short_beam ? "S" : "") << (beam[i]->short_left ? "L" : "");
+            std::cout << ":    " << beam[i].end << " ~ idx " << beam[i].end_idx << "  ";
+            std::cout << (beam[i].short_beam ? "S" : "") << (beam[i].short_left ? "L" : "");
             std::cout << "\n";
         };
     };
@@ -201,16 +209,22 @@ void Plate_pNote::dump() const
 }
 
 // voice constructor
-Plate_pVoice::Plate_pVoice(const const_Cursor& cursor) : begin(cursor) {}
+Plate_pVoice::Plate_pVoice(const const_Cursor& cursor, const Plate_Allocator& alloc) : notes(alloc), begin(cursor) {}
 
 // append new note to voice
 Plate_pVoice::Iterator Plate_pVoice::append(const Plate_Pos& pos, const const_Cursor& note)
 {
-    notes.push_back(Plate_pNote(pos, note));
+    notes.push_back(Plate_pNote(pos, note, notes.get_allocator()));
     notes.back().beam_begin = notes.end();
     return --notes.end();
 }
 
+// virtual destructor of the engraver checkpoint
+Plate_pLine::Checkpoint::~Checkpoint() {}
+
+// constructor
+Plate_pLine::Plate_pLine(const Plate_Allocator& alloc) : line_end(0), voices(alloc), edited(false) {}
+
 // find the given voice in this line
 Plate_pLine::Iterator Plate_pLine::get_voice(const Voice& voice)
 {
@@ -264,6 +278,9 @@ void Plate_pLine::calculate_gphBox()
                 gphBox.extend((*a)->gphBox);
 }
 
+// plate constructor
+Plate::Plate() : lines(get_allocator()) {}
+
 // dump the plate content to stdout
 void Plate::dump() const
 {
@@ -287,10 +304,10 @@ void Plate::dump() const
                     std::cout << "        Note " << k++ << " @EOV";
                 else
                     std::cout << "        Note " << k++ << " @" << &n->get_note() << "\t" << classname(n->get_note().classtype()) << "\t(" << n->sprite.setid << ", " << n->sprite.spriteid << ")";
-                if (n->virtual_obj)
+                if (n->is_virtual())
                 {
                     std::cout << " [V";
-                    if (n->virtual_obj->inserted) std::cout << "I";
+                    if (n->is_inserted()) std::cout << "I";
                     std::cout << "]";
                 };
                 std::cout << "\n";
@@ -60,7 +60,7 @@ void Press::render(Renderer& renderer, const Plate::pNote& note)
     note.get_note().render(renderer, note, state);
     
     // render ties
-    for (std::list<Plate::pNote::Tie>::const_iterator i = note.ties.begin(); i != note.ties.end(); ++i)
+    for (Plate::pNote::TieList::const_iterator i = note.ties.begin(); i != note.ties.end(); ++i)
     {
         renderer.bezier_slur((scale(i->pos1.x)     + state.offset.x) / 1000.0, (scale(i->pos1.y)     + state.offset.y) / 1000.0,
                              (scale(i->control1.x) + state.offset.x) / 1000.0, (scale(i->control1.y) + state.offset.y) / 1000.0,
@@ -78,21 +78,42 @@ void Press::render(Renderer& renderer, const Plate::pNote& note)
     };
 }
 
+// check, if a box (in plate coordinates, placed at the offset) intersects the visible rectangle
+// (with a tolerance of one pixel for line widths and anti-aliasing)
+bool Press::is_visible(const Plate::GphBox& box, const Position<mpx_t> offset, const Plate::GphBox* visible) const
+{
+    if (!visible) return true;
+    return Plate::GphBox(Position<mpx_t>(_round(scale(box.pos.x)) + offset.x - 1000, _round(scale(box.pos.y)) + offset.y - 1000),
+                         _round(scale(box.width)) + 2000, _round(scale(box.height)) + 2000).intersects(*visible);
+}
+
 // render the staff-lines for a plate
-void Press::render_staff(Renderer& renderer, const Plate& plate, const Position<mpx_t> offset)
+void Press::render_staff(Renderer& renderer, const Plate& plate, const Position<mpx_t> offset, const Plate::GphBox* visible)
 {
     std::set<const Staff*> staves;      // set of already drawn staves
     renderer.set_color(0, 0, 0, 255);   // set color for all lines
     
     // iterate through the lines
-    for (std::list<Plate::pLine>::const_iterator line = plate.lines.begin(); line != plate.lines.end(); ++line)
+    for (Plate::LineList::const_iterator line = plate.lines.begin(); line != plate.lines.end(); ++line)
     {
+        // skip invisible lines (including braces and brackets)
+        if (visible)
+        {
+            Plate::GphBox box = line->gphBox;
+            for (Plate::VoiceList::const_iterator pvoice = line->voices.begin(); pvoice != line->voices.end(); ++pvoice)
+            {
+                if (pvoice->brace.sprite.ready())   box.extend(pvoice->brace.gphBox);
+                if (pvoice->bracket.sprite.ready()) box.extend(pvoice->bracket.gphBox);
+            };
+            if (!is_visible(box, offset, visible)) continue;
+        };
+        
         // initialize max-/min-pos (for front line rendering)
         mpx_t max_pos = line->voices.front().basePos.y;
         mpx_t min_pos = line->voices.front().basePos.y;
         
         // iterate through the on-plate voices
-        for (std::list<Plate::pVoice>::const_iterator pvoice = line->voices.begin(); pvoice != line->voices.end(); ++pvoice)
+        for (Plate::VoiceList::const_iterator pvoice = line->voices.begin(); pvoice != line->voices.end(); ++pvoice)
         {
             // render the brace
             if (pvoice->brace.sprite.ready())
@@ -255,7 +276,7 @@ void Press::draw_boundaries(Renderer& renderer, const Plate::GphBox& gphBox, con
 }
 
 // render a plate through the given renderer
-void Press::render(Renderer& renderer, const Plate& plate, const Position<mpx_t> offset)
+void Press::render(Renderer& renderer, const Plate& plate, const Position<mpx_t> offset, const Plate::GphBox* visible)
 {
     // check if the renderer is ready
     if (!renderer.ready()) throw InvalidRendererException();
@@ -264,7 +285,7 @@ void Press::render(Renderer& renderer, const Plate& plate, const Position<mpx_t>
     state.offset = offset;
     
     // render the lines
-    render_staff(renderer, plate, offset);
+    render_staff(renderer, plate, offset, visible);
     
     // iterate through the lines
     size_t l = 0;
@@ -273,6 +294,7 @@ void Press::render(Renderer& renderer, const Plate& plate, const Position<mpx_t>
     {
         ++l;
         v = 0;
+        if (!is_visible(line->gphBox, offset, visible)) continue;
         
         // clip to the line
         renderer.clip(static_cast<int>((scale(line->gphBox.pos.x) + offset.x) / 1000),
@@ -306,13 +328,13 @@ void Press::render(Renderer& renderer, const Plate& plate, const Position<mpx_t>
 }
 
 // render a page through the given renderer
-void Press::render(Renderer& renderer, const Pageset::pPage& page, const Pageset& pageset, const Position<mpx_t> offset)
+void Press::render(Renderer& renderer, const Pageset::pPage& page, const Pageset& pageset, const Position<mpx_t> offset, const Plate::GphBox* visible)
 {
     // render scores
     for (std::list<Pageset::PlateInfo>::const_iterator i = page.plates.begin(); i != page.plates.end(); ++i)
     {
         render(renderer, *i->plate, Position<mpx_t>(_round(scale(i->dimension.position.x)) + offset.x,
-                                                    _round(scale(i->dimension.position.y)) + offset.y));
+                                                    _round(scale(i->dimension.position.y)) + offset.y), visible);
     };
     
     // set state
@@ -320,8 +342,9 @@ void Press::render(Renderer& renderer, const Pageset::pPage& page, const Pageset
     state.head_height = pageset.head_height;
     
     // render attachables
-    for (std::list<RefPtr<Plate_pAttachable> >::const_iterator i = page.attached.begin(); i != page.attached.end(); ++i)
+    for (Pageset::pPage::AttachableList::const_iterator i = page.attached.begin(); i != page.attached.end(); ++i)
     {
+        if (!is_visible((*i)->gphBox, offset, visible)) continue;
         (*i)->object->render(renderer, **i, state);
         if (parameters.draw_attachbounds) draw_boundaries(renderer, **i, parameters.attachbounds_color, offset);
     };
@@ -0,0 +1,368 @@
+
+/*
+  ScorePress - Music Engraving Software  (libscorepress)
+  Copyright (C) 2016 Dominik Lehmann
+  
+  Licensed under the EUPL, Version 1.1 or - as soon they
+  will be approved by the European Commission - subsequent
+  versions of the EUPL (the "Licence");
+  You may not use this work except in compliance with the
+  Licence. You may obtain a copy of the Licence at
+  <http://ec.europa.eu/idabc/eupl/>.
+  
+  Unless required by applicable law or agreed to in
+  writing, software distributed under the Licence is
+  distributed on an "AS IS" basis, WITHOUT WARRANTIES OR
+  CONDITIONS OF ANY KIND, either expressed or implied.
+  See the Licence for the specific language governing
+  permissions and limitations under the Licence.
+*/
+
+#include "recording_renderer.hh"
+
+using namespace ScorePress;
+
+inline int _round(const double d) {return static_cast<int>((d < 0) ? d - 0.5 : d + 0.5);}
+inline unsigned char _uchar(const int i) {return static_cast<unsigned char>(i);}
+
+
+//
+//     class DisplayList
+//    ===================
+//
+// This class stores the commands issued to a renderer in flat arrays, such
+// that they can be replayed to another renderer without traversing the plates
+// again.
+//
+
+// replay the commands (transforming each coordinate "c" to "c * scale + offset")
+void DisplayList::replay(Renderer& renderer, const double x, const double y, const double scale) const
+{
+    std::vector<double>::const_iterator      real    = reals.begin();
+    std::vector<int>::const_iterator         integer = integers.begin();
+    std::vector<std::string>::const_iterator string  = strings.begin();
+    const bool scaled = (scale < 1.0 || scale > 1.0);
+    double x1, y1, x2, y2, p[8];
+    int i1, i2;
+    
+    for (std::vector<unsigned char>::const_iterator cmd = commands.begin(); cmd != commands.end(); ++cmd)
+    {
+        switch (*cmd)
+        {
+        case DRAW_SPRITE:
+            i1 = *integer++;
+            i2 = *integer++;
+            x1 = *real++ * scale + x;
+            y1 = *real++ * scale + y;
+            if (!scaled) renderer.draw_sprite(SpriteId(static_cast<size_t>(i1), static_cast<size_t>(i2)), x1, y1);
+            else         renderer.draw_sprite(SpriteId(static_cast<size_t>(i1), static_cast<size_t>(i2)), x1, y1, scale, scale);
+            break;
+        case DRAW_SPRITE_SCALED:
+            i1 = *integer++;
+            i2 = *integer++;
+            x1 = *real++ * scale + x;
+            y1 = *real++ * scale + y;
+            x2 = *real++ * scale;
+            y2 = *real++ * scale;
+            renderer.draw_sprite(SpriteId(static_cast<size_t>(i1), static_cast<size_t>(i2)), x1, y1, x2, y2);
+            break;
+    
+        case SET_LINE_WIDTH: renderer.set_line_width(*real++ * scale); break;
+        case SET_COLOR:
+            renderer.set_color(_uchar(integer[0]), _uchar(integer[1]), _uchar(integer[2]), _uchar(integer[3]));
+            integer += 4;
+            break;
+        case MOVE_TO:
+            x1 = *real++ * scale + x;
+            y1 = *real++ * scale + y;
+            renderer.move_to(x1, y1);
+            break;
+        case LINE_TO:
+            x1 = *real++ * scale + x;
+            y1 = *real++ * scale + y;
+            renderer.line_to(x1, y1);
+            break;
+        case FILL:   renderer.fill();   break;
+        case STROKE: renderer.stroke(); break;
+        case CLOSE:  renderer.close();  break;
+    
+        case CLIP:
+            renderer.clip(_round(integer[0] * scale + x), _round(integer[1] * scale + y),
+                          _round(integer[2] * scale),     _round(integer[3] * scale));
+            integer += 4;
+            break;
+        case UNCLIP: renderer.unclip(); break;
+    
+        case SET_FONT_FAMILY:    renderer.set_font_family(*string++);       break;
+        case SET_FONT_SIZE:      renderer.set_font_size(*real++ * scale);   break;
+        case SET_FONT_BOLD:      renderer.set_font_bold(*integer++ != 0);   break;
+        case SET_FONT_ITALIC:    renderer.set_font_italic(*integer++ != 0); break;
+        case SET_FONT_UNDERLINE: renderer.set_font_underline(*integer++ != 0); break;
+        case SET_FONT_COLOR:
+            renderer.set_font_color(_uchar(integer[0]), _uchar(integer[1]), _uchar(integer[2]));
+            integer += 3;
+            break;
+    
+        case SET_TEXT_WIDTH:   renderer.set_text_width(*real++ * scale);                                  break;
+        case RESET_TEXT_WIDTH: renderer.reset_text_width();                                               break;
+        case SET_TEXT_ALIGN:   renderer.set_text_align(static_cast<Renderer::enuAlignment>(*integer++)); break;
+        case SET_TEXT_JUSTIFY: renderer.set_text_justify(*integer++ != 0);                                break;
+        case ADD_TEXT:         renderer.add_text(*string++);                                              break;
+        case RENDER_TEXT:      renderer.render_text();                                                    break;
+    
+        case RECT_INVERT:
+            x1 = *real++ * scale + x;
+            y1 = *real++ * scale + y;
+            x2 = *real++ * scale + x;
+            y2 = *real++ * scale + y;
+            renderer.rect_invert(x1, y1, x2, y2);
+            break;
+        case BEZIER:
+        case BEZIER_SLUR:
+            for (size_t i = 0; i < 8; i += 2)
+            {
+                p[i]     = *real++ * scale + x;
+                p[i + 1] = *real++ * scale + y;
+            };
+            if (*cmd == BEZIER)
+            {
+                renderer.bezier(p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7]);
+                break;
+            };
+            x1 = *real++ * scale;
+            x2 = *real++ * scale;
+            renderer.bezier_slur(p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7], x1, x2);
+            break;
+        };
+    };
+}
+
+// remove all commands
+void DisplayList::clear()
+{
+    commands.clear();
+    reals.clear();
+    integers.clear();
+    strings.clear();
+}
+
+
+//
+//     class RecordingRenderer
+//    =========================
+//
+// This renderer does not draw anything, but appends the received commands to
+// a display list.
+//
+
+// exception class
+RecordingRenderer::Error::Error(const std::string& msg) : ScorePress::Error(msg) {}
+
+// constructor (without source)
+RecordingRenderer::RecordingRenderer() : source(NULL), target(NULL) {}
+
+// constructor (copying the sprites of the given renderer)
+RecordingRenderer::RecordingRenderer(const Renderer& _source) : source(&_source), target(NULL)
+{
+    sprites = _source.get_sprites();
+}
+
+// copy the sprites of the given renderer
+void RecordingRenderer::set_source(const Renderer& _source)
+{
+    source = &_source;
+    sprites = _source.get_sprites();
+}
+
+// renderer methods (sprite access)
+bool RecordingRenderer::ready() const {return target != NULL && source != NULL;}
+bool RecordingRenderer::exist(const std::string& sprite) const                     {return source && source->exist(sprite);}
+bool RecordingRenderer::exist(const std::string& sprite, const size_t setid) const {return source && source->exist(sprite, setid);}
+
+size_t RecordingRenderer::spriteset_format_count() const {return 0;}
+
+Renderer::ReaderPtr RecordingRenderer::spriteset_reader(const size_t)
+{
+    throw Error("The recording renderer cannot read sprites (use the source renderer instead).");
+}
+
+size_t RecordingRenderer::add_spriteset(ReaderPtr)
+{
+    throw Error("The recording renderer cannot read sprites (use the source renderer instead).");
+}
+
+// sprite rendering
+void RecordingRenderer::draw_sprite(const SpriteId sprite_id, double x, double y)
+{
+    target->commands.push_back(DisplayList::DRAW_SPRITE);
+    target->integers.push_back(static_cast<int>(sprite_id.setid));
+    target->integers.push_back(static_cast<int>(sprite_id.spriteid));
+    target->reals.push_back(x);
+    target->reals.push_back(y);
+}
+
+void RecordingRenderer::draw_sprite(const SpriteId sprite_id, double x, double y, double xscale, double yscale)
+{
+    target->commands.push_back(DisplayList::DRAW_SPRITE_SCALED);
+    target->integers.push_back(static_cast<int>(sprite_id.setid));
+    target->integers.push_back(static_cast<int>(sprite_id.spriteid));
+    target->reals.push_back(x);
+    target->reals.push_back(y);
+    target->reals.push_back(xscale);
+    target->reals.push_back(yscale);
+}
+
+// basic rendering
+void RecordingRenderer::set_line_width(const double width)
+{
+    target->commands.push_back(DisplayList::SET_LINE_WIDTH);
+    target->reals.push_back(width);
+}
+
+void RecordingRenderer::set_color(const unsigned char r, const unsigned char g, const unsigned char b, const unsigned char a)
+{
+    target->commands.push_back(DisplayList::SET_COLOR);
+    target->integers.push_back(r);
+    target->integers.push_back(g);
+    target->integers.push_back(b);
+    target->integers.push_back(a);
+}
+
+void RecordingRenderer::move_to(const double x, const double y)
+{
+    target->commands.push_back(DisplayList::MOVE_TO);
+    target->reals.push_back(x);
+    target->reals.push_back(y);
+}
+
+void RecordingRenderer::line_to(const double x, const double y)
+{
+    target->commands.push_back(DisplayList::LINE_TO);
+    target->reals.push_back(x);
+    target->reals.push_back(y);
+}
+
+void RecordingRenderer::fill()   {target->commands.push_back(DisplayList::FILL);}
+void RecordingRenderer::stroke() {target->commands.push_back(DisplayList::STROKE);}
+void RecordingRenderer::close()  {target->commands.push_back(DisplayList::CLOSE);}
+
+// clipping
+void RecordingRenderer::clip(const int x1, const int y1, const int w, const int h)
+{
+    target->commands.push_back(DisplayList::CLIP);
+    target->integers.push_back(x1);
+    target->integers.push_back(y1);
+    target->integers.push_back(w);
+    target->integers.push_back(h);
+}
+
+void RecordingRenderer::unclip() {target->commands.push_back(DisplayList::UNCLIP);}
+
+// text rendering
+void RecordingRenderer::set_font_family(const std::string& family)
+{
+    target->commands.push_back(DisplayList::SET_FONT_FAMILY);
+    target->strings.push_back(family);
+}
+
+void RecordingRenderer::set_font_size(const double pt)
+{
+    target->commands.push_back(DisplayList::SET_FONT_SIZE);
+    target->reals.push_back(pt);
+}
+
+void RecordingRenderer::set_font_bold(const bool bold)
+{
+    target->commands.push_back(DisplayList::SET_FONT_BOLD);
+    target->integers.push_back(bold ? 1 : 0);
+}
+
+void RecordingRenderer::set_font_italic(const bool italic)
+{
+    target->commands.push_back(DisplayList::SET_FONT_ITALIC);
+    target->integers.push_back(italic ? 1 : 0);
+}
+
+void RecordingRenderer::set_font_underline(const bool underline)
+{
+    target->commands.push_back(DisplayList::SET_FONT_UNDERLINE);
+    target->integers.push_back(underline ? 1 : 0);
+}
+
+void RecordingRenderer::set_font_color(const unsigned char r, const unsigned char g, const unsigned char b)
+{
+    target->commands.push_back(DisplayList::SET_FONT_COLOR);
+    target->integers.push_back(r);
+    target->integers.push_back(g);
+    target->integers.push_back(b);
+}
+
+void RecordingRenderer::set_text_width(const double width)
+{
+    target->commands.push_back(DisplayList::SET_TEXT_WIDTH);
+    target->reals.push_back(width);
+}
+
+void RecordingRenderer::reset_text_width() {target->commands.push_back(DisplayList::RESET_TEXT_WIDTH);}
+
+void RecordingRenderer::set_text_align(const enuAlignment align)
+{
+    target->commands.push_back(DisplayList::SET_TEXT_ALIGN);
+    target->integers.push_back(align);
+}
+
+void RecordingRenderer::set_text_justify(const bool justify)
+{
+    target->commands.push_back(DisplayList::SET_TEXT_JUSTIFY);
+    target->integers.push_back(justify ? 1 : 0);
+}
+
+void RecordingRenderer::add_text(const std::string& utf8)
+{
+    target->commands.push_back(DisplayList::ADD_TEXT);
+    target->strings.push_back(utf8);
+}
+
+void RecordingRenderer::render_text() {target->commands.push_back(DisplayList::RENDER_TEXT);}
+
+// advanced rendering
+void RecordingRenderer::rect_invert(double x1, double y1, double x2, double y2)
+{
+    target->commands.push_back(DisplayList::RECT_INVERT);
+    target->reals.push_back(x1);
+    target->reals.push_back(y1);
+    target->reals.push_back(x2);
+    target->reals.push_back(y2);
+}
+
+bool RecordingRenderer::has_rect_invert() const {return source && source->has_rect_invert();}
+
+// cubic bézier curves (recorded as such, to be replayed by the target's implementation)
+void RecordingRenderer::bezier(double x1, double y1, double cx1, double cy1, double cx2, double cy2, double x2, double y2)
+{
+    target->commands.push_back(DisplayList::BEZIER);
+    target->reals.push_back(x1);
+    target->reals.push_back(y1);
+    target->reals.push_back(cx1);
+    target->reals.push_back(cy1);
+    target->reals.push_back(cx2);
+    target->reals.push_back(cy2);
+    target->reals.push_back(x2);
+    target->reals.push_back(y2);
+}
+
+void RecordingRenderer::bezier_slur(double x1, double y1, double cx1, double cy1, double cx2, double cy2, double x2, double y2, double w0, double w1)
+{
+    target->commands.push_back(DisplayList::BEZIER_SLUR);
+    target->reals.push_back(x1);
+    target->reals.push_back(y1);
+    target->reals.push_back(cx1);
+    target->reals.push_back(cy1);
+    target->reals.push_back(cx2);
+    target->reals.push_back(cy2);
+    target->reals.push_back(x2);
+    target->reals.push_back(y2);
+    target->reals.push_back(w0);
+    target->reals.push_back(w1);
+}
+
@@ -19,6 +19,7 @@
 */
 
 #include "reengrave_info.hh"
+#include "plate.hh"         // Plate_pLine
 using namespace ScorePress;
 
 // virtual destructor
@@ -89,3 +90,20 @@ void ReengraveInfo::finish()
     on_finish.clear();
 }
 
+// remove all objects triggered by the objects of a line, which is not reengraved
+// (these are still valid after a partial reengraving; see "EngraverState")
+void ReengraveInfo::release(const Plate_pLine& line)
+{
+    for (Plate_pLine::const_Iterator voice = line.voices.begin(); voice != line.voices.end(); ++voice)
+    {
+        on_create_voice.erase(&voice->begin.voice());
+        for (Plate_pVoice::const_Iterator note = voice->notes.begin(); note != voice->notes.end(); ++note)
+        {
+            if (!note->note.at_end())
+                on_create_note.erase(&*note->note);
+            for (Plate_pNote::AttachableList::const_iterator i = note->attached.begin(); i != note->attached.end(); ++i)
+                if ((*i)->object->is(Class::MOVABLE))
+                    on_create_movable.erase(&static_cast<const Movable&>(*(*i)->object));
+        };
+    };
+}
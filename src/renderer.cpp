@@ -41,20 +41,20 @@ void Renderer::dump() const
     for (Sprites::const_iterator s = sprites.begin(); s != sprites.end(); s++)
     for (SpriteSet::const_iterator i = s->begin(); i != s->end(); i++)
     {
-        for (std::map<std::string, std::string>::const_iterator t = i->text.begin(); t != i->text.end(); t++)
+        for (AtomMap<std::string>::const_iterator t = i->text.begin(); t != i->text.end(); t++)
         {
-            std::cout << t->first << "$ = \"" << t->second << "\"\n";
+            std::cout << AtomTable::name(t->first) << "$ = \"" << t->second << "\"\n";
         };
         std::cout << "path$ = \"" << i->path << "\"\n";
         std::cout << "width% = " << i->width << "\n";
         std::cout << "height% = " << i->height << "\n";
-        for (std::map<std::string, int>::const_iterator n = i->integer.begin(); n != i->integer.end(); n++)
+        for (AtomMap<int>::const_iterator n = i->integer.begin(); n != i->integer.end(); n++)
         {
-            std::cout << n->first << "% = " << n->second << "\n";
+            std::cout << AtomTable::name(n->first) << "% = " << n->second << "\n";
         };
-        for (std::map<std::string, double>::const_iterator r = i->real.begin(); r != i->real.end(); r++)
+        for (AtomMap<double>::const_iterator r = i->real.begin(); r != i->real.end(); r++)
         {
-            std::cout << r->first << "& = " << r->second << "\n";
+            std::cout << AtomTable::name(r->first) << "& = " << r->second << "\n";
         };
         std::cout << "\n";
     };
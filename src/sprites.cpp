@@ -39,25 +39,37 @@ SpriteInfo::SpriteInfo(Type _type) : type(_type), width(0), height(0) {}
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wexit-time-destructors"
 
-// easy access methods (with default returns for non-existing values)
-const std::string& SpriteInfo::get_text(const std::string& key) const
+// default for non-existing text properties
+static const std::string& nulltext()
 {
-    static const std::string nulltext;
-    const std::map<std::string, std::string>::const_iterator i = text.find(key);
-    return (i == text.end()) ? nulltext : i->second;
+    static const std::string text;
+    return text;
 }
 
 #pragma clang diagnostic pop
 
+// easy access methods (with default returns for non-existing values)
+const std::string& SpriteInfo::get_text(const Atom key) const
+{
+    const AtomMap<std::string>::const_iterator i = text.find(key);
+    return (i == text.end()) ? nulltext() : i->second;
+}
+
+const std::string& SpriteInfo::get_text(const std::string& key) const
+{
+    const AtomMap<std::string>::const_iterator i = text.find(key);
+    return (i == text.end()) ? nulltext() : i->second;
+}
+
 double SpriteInfo::get_real(const std::string& key) const
 {
-    const std::map<std::string, double>::const_iterator i = real.find(key);
+    const AtomMap<double>::const_iterator i = real.find(key);
     return (i == real.end()) ? 0.0 : i->second;
 }
 
 int SpriteInfo::get_integer(const std::string& key) const
 {
-    const std::map<std::string, int>::const_iterator i = integer.find(key);
+    const AtomMap<int>::const_iterator i = integer.find(key);
     return (i == integer.end()) ? 0 : i->second;
 }
 
@@ -168,9 +180,90 @@ void SpriteSet::clear()
 }
 
 // get index by sprite-id
+size_t SpriteSet::index(const Atom id) const
+{
+    const AtomMap<size_t>::const_iterator i(ids.find(id));
+    return (i == ids.end()) ? UNDEFINED : i->second;
+}
+
 size_t SpriteSet::index(const std::string& id) const
 {
-    const std::map<std::string, size_t>::const_iterator i(ids.find(id));
+    const AtomMap<size_t>::const_iterator i(ids.find(id));
     return (i == ids.end()) ? UNDEFINED : i->second;
 }
 
+
+//
+//     class SpriteMetrics
+//    =====================
+//
+// This class holds the metrics of all sprites of one sprite-set, scaled to the
+// given head-height (in milli-pixel) and indexed by the sprite-id.
+//
+
+// constructor (scaling the metrics of the given sprite-set)
+SpriteMetrics::SpriteMetrics(const SpriteSet& spriteset, const size_t _setid, const mpx_t _head_height) :
+            undefined_symbol(spriteset.undefined_symbol),
+            setid(_setid),
+            head_height(_head_height),
+            scale(_head_height / (spriteset.head_height * 1000.0)),
+            head_width(0.0),
+            mpx_head_width(0),
+            mpx_digit_space(static_cast<mpx_t>((spriteset.timesig_digit_space * _head_height) / spriteset.head_height))
+{
+    // (the expressions match the ones of the engraver, so that the results are identical)
+    sprites.resize(spriteset.size());
+    for (size_t i = 0; i < spriteset.size(); ++i)
+    {
+        const SpriteInfo& info = spriteset[i];
+        Metrics& metrics = sprites[i];
+        metrics.mpx_width  = static_cast<mpx_t>((info.width  * _head_height) / spriteset.head_height);
+        metrics.mpx_height = static_cast<mpx_t>((info.height * _head_height) / spriteset.head_height);
+        metrics.width    = info.width  * scale;
+        metrics.height   = info.height * scale;
+        metrics.anchor_x = info.get_real(ATOM_ANCHOR_X) * scale;
+        metrics.anchor_y = info.get_real(ATOM_ANCHOR_Y) * scale;
+        metrics.stem_x   = info.get_real(ATOM_STEM_X) * scale;
+        metrics.stem_y   = info.get_real(ATOM_STEM_Y) * scale;
+        metrics.offset   = info.get_real(ATOM_OFFSET) * scale;
+        metrics.distance = info.get_real(ATOM_DISTANCE) * scale;
+        metrics.stem_slope     = info.get_real(ATOM_STEM_SLOPE) * scale;
+        metrics.stem_minlen    = info.get_real(ATOM_STEM_MINLEN) * scale;
+        metrics.stem_bottom_x1 = info.get_real(ATOM_STEM_BOTTOM_X1) * scale;
+        metrics.line = info.get_integer(ATOM_LINE);
+    };
+    
+    if (!spriteset.empty())
+    {
+        head_width = spriteset[spriteset.heads_quarter].width * scale;
+        mpx_head_width = static_cast<mpx_t>((spriteset[spriteset.heads_quarter].width * _head_height) / spriteset.head_height);
+    };
+    
+    for (size_t i = 0; i < 10; ++i)
+        digits_time[i] = (spriteset.digits_time[i] == UNDEFINED) ? undefined_symbol : spriteset.digits_time[i];
+}
+
+
+//
+//     class MetricsCache
+//    ====================
+//
+// This class builds the metrics of the sprite-sets on demand, once for each
+// combination of sprite-set and head-height.
+//
+
+// constructor (without metrics)
+MetricsCache::MetricsCache(const Sprites& _sprites) : sprites(&_sprites), last(NULL) {}
+
+// find or build the metrics
+const SpriteMetrics& MetricsCache::find(const size_t setid, const mpx_t head_height)
+{
+    for (std::deque<SpriteMetrics>::const_iterator i = tables.begin(); i != tables.end(); ++i)
+    {
+        if (i->setid == setid && i->head_height == head_height)
+            return *(last = &*i);
+    };
+    tables.push_back(SpriteMetrics((*sprites)[setid], setid, head_height));
+    return *(last = &tables.back());
+}
+
@@ -0,0 +1,101 @@
+
+/*
+  ScorePress - Music Engraving Software  (libscorepress)
+  Copyright (C) 2016 Dominik Lehmann
+  
+  Licensed under the EUPL, Version 1.1 or - as soon they
+  will be approved by the European Commission - subsequent
+  versions of the EUPL (the "Licence");
+  You may not use this work except in compliance with the
+  Licence. You may obtain a copy of the Licence at
+  <http://ec.europa.eu/idabc/eupl/>.
+  
+  Unless required by applicable law or agreed to in
+  writing, software distributed under the Licence is
+  distributed on an "AS IS" basis, WITHOUT WARRANTIES OR
+  CONDITIONS OF ANY KIND, either expressed or implied.
+  See the Licence for the specific language governing
+  permissions and limitations under the Licence.
+*/
+
+#include "statistics.hh"
+
+using namespace ScorePress;
+
+
+//
+//     class Statistics
+//    ==================
+//
+// This class holds the accumulated wall-time and the number of calls of each
+// engraving phase and of the rendering, as well as the number of engraved
+// objects.
+//
+
+// constructor
+Statistics::Statistics()
+{
+    reset();
+}
+
+// is the library compiled with instrumentation?
+bool Statistics::enabled()
+{
+#ifdef STATISTICS
+    return true;
+#else
+    return false;
+#endif
+}
+
+// name of a phase
+const char* Statistics::name(const Phase phase)
+{
+    switch (phase)
+    {
+    case PICK:          return "pick";
+    case LINEEND:       return "create_lineend";
+    case JUSTIFY:       return "justify_line";
+    case OFFSETS:       return "apply_offsets";
+    case STEMS:         return "engrave_stems";
+    case ATTACHABLES:   return "engrave_attachables";
+    case BRACES:        return "engrave_braces";
+    case RENDER:        return "render";
+    default:            return "";
+    };
+}
+
+// name of a counter
+const char* Statistics::name(const Counter counter)
+{
+    switch (counter)
+    {
+    case LINES:         return "lines";
+    case NOTES:         return "notes";
+    case ATTACHED:      return "attachables";
+    case VIRTUALS:      return "virtual_objects";
+    default:            return "";
+    };
+}
+
+// add the values of the given statistics
+void Statistics::merge(const Statistics& statistics)
+{
+    for (size_t i = 0; i < PHASE_COUNT; ++i)
+    {
+        timers[i].time  += statistics.timers[i].time;
+        timers[i].calls += statistics.timers[i].calls;
+    };
+    for (size_t i = 0; i < COUNTER_COUNT; ++i)
+        counters[i] += statistics.counters[i];
+}
+
+// set all values to zero
+void Statistics::reset()
+{
+    for (size_t i = 0; i < PHASE_COUNT; ++i)
+        timers[i].time = timers[i].calls = 0;
+    for (size_t i = 0; i < COUNTER_COUNT; ++i)
+        counters[i] = 0;
+}
+
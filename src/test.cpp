@@ -18,6 +18,8 @@
   permissions and limitations under the Licence.
 */
 
+#include <algorithm>     // std::min
+
 #include "test.hh"
 
 #define JUSTIFY       false
@@ -41,10 +43,13 @@ static void add_articulation(Staff& voice, const SpriteId& sprite, int offset_y,
 static void add_articulation(SubVoice& voice, const SpriteId& sprite, int offset_y, bool far = false);
 static void add_newline(Staff& voice, unsigned int distance, int indent = 0, int right_margin = 0, bool justify = false, bool force = false);
 static void add_newline(SubVoice& voice, unsigned int distance, int indent = 0, int right_margin = 0, bool justify = false, bool force = false);
-//static void add_pagebreak(Staff& voice, unsigned int distance, int indent = 0, int right_margin = 0, bool justify = false, bool force = false);
+static void add_pagebreak(Staff& voice, const ScoreDimension& dimension, unsigned int distance, int indent = 0, int right_margin = 0, bool justify = false, bool force = false);
 //static void add_pagebreak(SubVoice& voice, unsigned int distance, int indent = 0, int right_margin = 0, bool justify = false, bool force = false);
 static void add1(Staff& staff, const Sprites& sprites, int toneoffset = 0);
 static void add2(Staff& staff, const Sprites& sprites, int toneoffset = 0, int staffdist = 0);
+static void add_clef(Staff& staff, const Sprites& sprites, const std::string& clef);
+static void add_slur(Chord& chord, unsigned int duration);
+static void add_hairpin(Chord& chord, unsigned int duration, bool crescendo);
 
 static void add(Staff& voice, unsigned char exp, int tone, int stem_length, Chord::BeamType beam)
 {
@@ -177,17 +182,18 @@ static void add_newline(SubVoice& voice, unsigned int distance, int indent, int
     static_cast<Newline&>(*voice.notes.back()).layout.justify = justify;
     static_cast<Newline&>(*voice.notes.back()).layout.forced_justification = force;
 }
-/*
-static void add_pagebreak(Staff& voice, unsigned int distance, int indent, int right_margin, bool justify, bool force)
+
+static void add_pagebreak(Staff& voice, const ScoreDimension& dimension, unsigned int distance, int indent, int right_margin, bool justify, bool force)
 {
     voice.notes.push_back(StaffObjectPtr(new Pagebreak()));
-    static_cast<Pagebreak&>(*voice.notes.back()).distance = distance;
-    static_cast<Pagebreak&>(*voice.notes.back()).indent = indent;
-    static_cast<Pagebreak&>(*voice.notes.back()).right_margin = right_margin;
-    static_cast<Pagebreak&>(*voice.notes.back()).justify = justify;
-    static_cast<Pagebreak&>(*voice.notes.back()).forced_justification = force;
+    static_cast<Pagebreak&>(*voice.notes.back()).dimension = dimension;
+    static_cast<Pagebreak&>(*voice.notes.back()).layout.distance = distance;
+    static_cast<Pagebreak&>(*voice.notes.back()).layout.indent = indent;
+    static_cast<Pagebreak&>(*voice.notes.back()).layout.right_margin = right_margin;
+    static_cast<Pagebreak&>(*voice.notes.back()).layout.justify = justify;
+    static_cast<Pagebreak&>(*voice.notes.back()).layout.forced_justification = force;
 }
-
+/*
 static void add_pagebreak(SubVoice& voice, unsigned int distance, int indent, int right_margin, bool justify, bool force)
 {
     voice.notes.push_back(VoiceObjectPtr(new Pagebreak()));
@@ -300,6 +306,53 @@ static void add2(Staff& staff, const Sprites& sprites, int toneoffset, int staff
     //add_pagebreak(subvoice, staffdist, 0, 0, JUSTIFY, FORCE_JUSTIFY);
 }
 
+static void add_clef(Staff& staff, const Sprites& sprites, const std::string& clef)
+{
+    staff.notes.push_back(StaffObjectPtr(new Clef()));
+    static_cast<Clef&>(*staff.notes.back()).sprite = SpriteId(0, sprites.front().index(clef));
+    static_cast<Clef&>(*staff.notes.back()).base_note = static_cast<tone_t>(sprites.front().get(clef).get_integer("basenote"));
+    static_cast<Clef&>(*staff.notes.back()).line = static_cast<unsigned char>(sprites.front().get(clef).get_integer("line"));
+    static_cast<Clef&>(*staff.notes.back()).keybnd_sharp = static_cast<tone_t>(sprites.front().get(clef).get_integer("keybound.sharp"));
+    static_cast<Clef&>(*staff.notes.back()).keybnd_flat = static_cast<tone_t>(sprites.front().get(clef).get_integer("keybound.flat"));
+}
+
+static void add_slur(Chord& chord, unsigned int duration)
+{
+    chord.attached.push_back(MovablePtr(new Slur()));
+    Slur& slur = static_cast<Slur&>(*chord.attached.back());
+    slur.duration = duration;
+    slur.position.orig.x = UnitPosition::NOTE;
+    slur.position.orig.y = UnitPosition::STAFF;
+    slur.position.unit.x = UnitPosition::HEAD;
+    slur.position.unit.y = UnitPosition::HEAD;
+    slur.position.co.x = 0;
+    slur.position.co.y = 0;
+    slur.control1 = slur.position;
+    slur.control1.co.x = 2000;
+    slur.control1.co.y = -3000;
+    slur.control2 = slur.position;
+    slur.control2.co.x = -2000;
+    slur.control2.co.y = -3000;
+    slur.end = slur.position;
+}
+
+static void add_hairpin(Chord& chord, unsigned int duration, bool crescendo)
+{
+    chord.attached.push_back(MovablePtr(new Hairpin()));
+    Hairpin& hairpin = static_cast<Hairpin&>(*chord.attached.back());
+    hairpin.duration = duration;
+    hairpin.position.orig.x = UnitPosition::NOTE;
+    hairpin.position.orig.y = UnitPosition::STAFF;
+    hairpin.position.unit.x = UnitPosition::HEAD;
+    hairpin.position.unit.y = UnitPosition::HEAD;
+    hairpin.position.co.x = 0;
+    hairpin.position.co.y = 8500;
+    hairpin.end = hairpin.position;
+    hairpin.thickness = 1000;
+    hairpin.height = 800;
+    hairpin.crescendo = crescendo;
+}
+
 static void set_test(Document& document, const Sprites& sprites)
 {
     // setup document
@@ -428,3 +481,143 @@ const Document& Test::get_document(const Sprites& sprites)
     return document;
 }
 
+
+// default synthetic score (a two-page piano score)
+Test::SyntheticParam::SyntheticParam() : staves(2), subvoices(1), beats(256), line_beats(16), page_lines(8), justify(true),
+                                         beams(300), ties(100), slurs(100), hairpins(50), accidentals(200),
+                                         seed(1) {}
+
+// pseudo-random choices (linear congruential generator, independent of the standard library's implementation)
+class SyntheticRandom
+{
+ private:
+    unsigned long state;
+    
+ public:
+    SyntheticRandom(unsigned int seed) : state(seed) {}
+    unsigned int next(unsigned int range) {state = (state * 1103515245ul + 12345ul) & 0x7FFFFFFFul; return static_cast<unsigned int>((state >> 16) % range);}
+    bool chance(unsigned int density) {return next(1000) < density;}
+};
+
+// tone of the given diatonic step (i.e. of the white keys, counting from C0)
+static int diatonic(int step)
+{
+    static const int tones[] = {0, 2, 4, 5, 7, 9, 11};
+    return 12 * (step / 7) + tones[step % 7];
+}
+
+// add a random accidental to the last head of the chord (altering its tone accordingly)
+static void alter(Chord& chord, SyntheticRandom& random)
+{
+    static const Accidental::Type types[] = {Accidental::flat, Accidental::natural, Accidental::sharp};
+    static const int modifiers[] = {-1, 0, 1};
+    const unsigned int idx = random.next(3);
+    chord.heads.back()->accidental.type = types[idx];
+    chord.heads.back()->tone = static_cast<tone_t>(chord.heads.back()->tone + modifiers[idx]);
+}
+
+static void set_synthetic_staff(Staff& staff, const Score& score, const Test::SyntheticParam& param, SyntheticRandom& random, int stepoffset, int staffdist)
+{
+    const unsigned int beat = 1u << (VALUE_BASE-2);
+    int step = 36 + stepoffset;
+    bool tied = false;
+    
+    for (size_t b = 0; b < param.beats; ++b)
+    {
+        // choose the tone (keeping the tied one; tied notes are not altered)
+        const bool tie_target = tied;
+        if (!tied) step = 36 + stepoffset + static_cast<int>(random.next(10));
+        tied = (b + 1 < param.beats && random.chance(param.ties));
+        
+        // main-voice notes (a quarter, or two beamed eighths)
+        Chord* first = NULL;
+        if (random.chance(param.beams))
+        {
+            add(staff, VALUE_BASE-3, diatonic(step), 6, Chord::BEAM_FORCED);
+            first = &static_cast<Chord&>(*staff.notes.back());
+            if (!tie_target && random.chance(param.accidentals)) alter(*first, random);
+            if (tied) add(staff, VALUE_BASE-3, diatonic(++step), 6, 100, -700, 1500, -600, -1500, -600, -100, -700, Chord::BEAM_NONE);
+            else      add(staff, VALUE_BASE-3, diatonic(step + 1), 6, Chord::BEAM_NONE);
+            if (!tied && random.chance(param.accidentals)) alter(static_cast<Chord&>(*staff.notes.back()), random);
+        }
+        else
+        {
+            if (tied) add(staff, VALUE_BASE-2, diatonic(step), 6, 100, -700, 1500, -600, -1500, -600, -100, -700);
+            else      add(staff, VALUE_BASE-2, diatonic(step), 6);
+            first = &static_cast<Chord&>(*staff.notes.back());
+            if (!tie_target && !tied && random.chance(param.accidentals)) alter(*first, random);
+        };
+        
+        // attached objects (on the last main-voice chord)
+        Chord& chord = static_cast<Chord&>(*staff.notes.back());
+        if (b + 2 < param.beats && random.chance(param.slurs))    add_slur(chord, 2 * beat);
+        if (b + 2 < param.beats && random.chance(param.hairpins)) add_hairpin(chord, 2 * beat, random.chance(500));
+        
+        // sub-voices (beginning with the line, ending in front of its last beat)
+        const size_t line_end = std::min(b - b % param.line_beats + param.line_beats, param.beats);
+        if (b % param.line_beats == 0 && b + 1 < line_end)
+        {
+            for (size_t v = 0; v < param.subvoices; ++v)
+            {
+                SubVoice& subvoice = *first->subvoices.add_below();
+                subvoice.stem_direction = Voice::STEM_DOWN;
+                for (size_t i = b; i + 1 < line_end; ++i)
+                {
+                    add(subvoice, VALUE_BASE-2, diatonic(31 + stepoffset - 2 * static_cast<int>(v) + static_cast<int>(random.next(5))), -6);
+                    if (random.chance(param.accidentals))
+                        alter(static_cast<Chord&>(*subvoice.notes.back()), random);
+                };
+            };
+        };
+        
+        // newlines and pagebreaks
+        if ((b + 1) % param.line_beats == 0 && b + 1 < param.beats)
+        {
+            if (param.page_lines && ((b + 1) / param.line_beats) % param.page_lines == 0)
+                add_pagebreak(staff, score.layout.dimension, static_cast<unsigned int>(staffdist), 0, 0, param.justify, FORCE_JUSTIFY);
+            else
+                add_newline(staff, static_cast<unsigned int>(staffdist), 0, 0, param.justify, FORCE_JUSTIFY);
+        };
+    };
+}
+
+void Test::get_synthetic_document(Document& document, const Sprites& sprites, const SyntheticParam& param)
+{
+    SyntheticRandom random(param.seed);
+    
+    // setup document
+    document = Document();
+    document.head_height = 2000;       // µm
+    document.stem_width = 250;         // µm
+    
+    // setup score
+    document.scores.push_back(Document::Score(0));
+    Score& score = document.scores.back().score;
+    score.layout.dimension.width = 190000;      // µm
+    score.layout.dimension.height = 297000;     // µm
+    
+    // setup staves (alternating treble and bass clef)
+    for (size_t i = 0; i < param.staves; ++i)
+    {
+        score.staves.push_back(Staff());
+        score.staves.back().offset_y = (i == 0) ? 5000 : 6000;     // pohh
+        score.staves.back().line_count = 5;
+        score.staves.back().long_barlines = (i + 1 < param.staves);
+        score.staves.back().curlybrace = (i == 0 && param.staves > 1);
+        score.staves.back().layout.indent = 10000;                  // µm
+        score.staves.back().layout.justify = param.justify;
+        score.staves.back().layout.distance = (i == 0) ? 10000 : 0; // pohh
+        score.staves.back().stem_direction = Voice::STEM_UP;
+        
+        add_clef(score.staves.back(), sprites, (i % 2) ? "clef.bass" : "clef.treble");
+        score.staves.back().notes.push_back(StaffObjectPtr(new Key()));
+        static_cast<Key&>(*score.staves.back().notes.back()).type = Key::SHARP;
+        static_cast<Key&>(*score.staves.back().notes.back()).number = 2;
+        score.staves.back().notes.push_back(StaffObjectPtr(new CustomTimeSig()));
+        static_cast<CustomTimeSig&>(*score.staves.back().notes.back()).number = 4;
+        static_cast<CustomTimeSig&>(*score.staves.back().notes.back()).beat = 4;
+        static_cast<CustomTimeSig&>(*score.staves.back().notes.back()).sprite = SpriteId(0, sprites.front().index("timesig.symbol_4_4_timesigC"));
+        
+        set_synthetic_staff(score.staves.back(), score, param, random, (i % 2) ? -14 : 0, (i == 0) ? 3000 : 0);
+    };
+}
@@ -383,7 +383,7 @@ void UserCursor::prepare_voices()
     if (line->voices.empty()) return;
     
     // prepare all voices of the current line
-    for (std::list<Plate::pVoice>::iterator voice = line->voices.begin(); voice != line->voices.end(); ++voice)
+    for (Plate::VoiceList::iterator voice = line->voices.begin(); voice != line->voices.end(); ++voice)
     {
         vcursors.push_back(VoiceCursor());
         if (!prepare_voice(vcursors.back(), *voice))    // prepare the voice cursor
@@ -621,15 +621,15 @@ void UserCursor::set_pos(Position<mpx_t> pos, Pageset::Iterator new_page, const
     // find PLATE
     Pageset::pPage::Iterator new_pinfo = new_page->get_plate_by_pos(pos);
     if (new_pinfo == new_page->plates.end()) return;    // if no plate is found at the position, abort
-    pos -= new_pinfo->dimension.position;               // calculate position relative to plate
     
-    // find on-plate LINE
-    bool check = false;                             // success indicator
-    for (std::list<Plate::pLine>::iterator l = new_pinfo->plate->lines.begin(); l != new_pinfo->plate->lines.end(); ++l)
-    {                                               // search all lines for a match
-        if (l->noteBox.contains(pos)) {line = l; check = true; break;};
-    };
-    if (!check) return;                             // if no line is found at the position, abort
+    // find on-plate LINE (using the page's spatial index)
+    Pageset::Index::ItemList items;
+    new_page->get_index().find(pos, items);
+    Pageset::Index::ItemList::const_iterator l = items.begin();
+    while (l != items.end() && ((*l)->type != Pageset::Index::LINE || (*l)->plateinfo != &*new_pinfo)) ++l;
+    if (l == items.end()) return;                   // if no line is found at the position, abort
+    line = (*l)->line;                              // set new line
+    pos -= new_pinfo->dimension.position;           // calculate position relative to plate
     page = new_page;                                // set new page
     plateinfo = &*new_pinfo;                        // set new plateinfo
     score = const_cast<Score*>(plateinfo->score);   // set score
@@ -1047,7 +1047,7 @@ void UserCursor::end()
     std::list<VoiceCursor>::iterator cur = vcursors.end();  // corresponding voice-cursor
     
     // search for the voice with the latest end
-    for (std::list<Plate::pVoice>::iterator pvoice = line->voices.begin(); pvoice != line->voices.end(); ++pvoice)
+    for (Plate::VoiceList::iterator pvoice = line->voices.begin(); pvoice != line->voices.end(); ++pvoice)
     {
         // if the voice ends later than the one last saved (or the current voice ends simultneously)
         if (pvoice->end_time > end_time || (pvoice->end_time == end_time && &*pvoice == cursor->pvoice))
@@ -1083,7 +1083,7 @@ StaffContext UserCursor::get_staff_context() const
     StaffContext out_ctx;
     if (line != plateinfo->plate->lines.begin())    // get the end-context of the previous line
     {
-        std::list<Plate::pLine>::iterator l(line); --l;
+        Plate::LineList::iterator l(line); --l;
         std::map<const Staff*, StaffContext>::iterator ctx = l->staffctx.find(&cursor->pvoice->begin.staff());
         if (ctx != l->staffctx.end()) out_ctx = ctx->second;
     };  // (if we cannot find this staff within the previous line, empty context is correct)
@@ -1319,7 +1319,7 @@ void UserCursor::dump() const
     for (std::list<VoiceCursor>::const_iterator i = vcursors.begin(); i != vcursors.end(); ++i)
     {
         size_t idx = 0;
-        for (std::list<Plate::pNote>::const_iterator j = i->pvoice->notes.begin(); j != i->pvoice->notes.end() && j != i->pnote; ++j, ++idx);
+        for (Plate::NoteList::const_iterator j = i->pvoice->notes.begin(); j != i->pvoice->notes.end() && j != i->pnote; ++j, ++idx);
         if (!i->active) std::cout << "["; else std::cout << " ";
         std::cout << i->note.index() << "/" << idx << ":";
         if (i->has_prev()) std::cout << "<"; else std::cout << " ";